@@ -0,0 +1,78 @@
+// converts every sound of a directory to the .adpcm files AudioSampleBank reads as they are, mono ima adpcm at the device's sample rate, so
+// the game packages them instead of the sources and doesn't decode or resample anything at load
+// usage: adpcm_converter [input_directory] [output_directory] [sample_rate_hz]
+// defaults to assets_source/sounds to assets/sounds at 48000 Hz like the device backends
+
+#define TOM_ENGINE_AUDIO_MIXER_IMPLEMENTATION
+#include "audio_mixer.h"
+
+#define MINIAUDIO_IMPLEMENTATION
+#include <miniaudio.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+
+static bool write_adpcm_file(const char* file_path, const uint32_t sample_rate_hz, const uint32_t frame_count, const std::vector<uint8_t>& blocks) {
+  FILE* file = fopen(file_path, "wb");
+  if (file == nullptr) return false;
+
+  const uint32_t header[3] = { AudioSampleBank::file_magic, sample_rate_hz, frame_count };
+  const bool is_written = (fwrite(header, sizeof(header), 1, file) == 1) && (fwrite(blocks.data(), 1, blocks.size(), file) == blocks.size());
+  return (fclose(file) == 0) && is_written;
+}
+
+int main(int argc, char** argv) {
+  const std::string input_directory  = (argc > 1) ? argv[1] : std::string(BENCHMARK_ASSET_DIRECTORY) + "assets_source/sounds";
+  const std::string output_directory = (argc > 2) ? argv[2] : std::string(BENCHMARK_ASSET_DIRECTORY) + "assets/sounds";
+  const uint32_t    sample_rate_hz   = (argc > 3) ? static_cast<uint32_t>(strtoul(argv[3], nullptr, 10)) : 48000;
+
+  std::error_code error;
+  std::filesystem::create_directories(output_directory, error);
+  std::vector<std::filesystem::path> input_paths;
+  for (const auto& entry : std::filesystem::directory_iterator(input_directory, error)) {
+    if (entry.is_regular_file()) input_paths.push_back(entry.path());
+  }
+  if (error || input_paths.empty()) {
+    printf("no sounds in: %s\n", input_directory.c_str());
+    return 1;
+  }
+  std::sort(input_paths.begin(), input_paths.end());
+
+  uint32_t             error_count        = 0;
+  uint64_t             total_input_bytes  = 0;
+  uint64_t             total_output_bytes = 0;
+  std::vector<uint8_t> blocks;
+  for (const auto& input_path : input_paths) {
+    ma_decoder_config config = ma_decoder_config_init(ma_format_f32, 1, sample_rate_hz);
+    ma_uint64 frame_count;
+    void*     frames;
+    if (ma_decode_file(input_path.c_str(), &config, &frame_count, &frames) != MA_SUCCESS) {
+      printf("%-20s can't be decoded, skipped\n", input_path.filename().c_str());
+      continue;
+    }
+
+    encode_ima_adpcm(static_cast<float*>(frames), static_cast<uint32_t>(frame_count), blocks);
+    ma_free(frames, nullptr);
+
+    const std::filesystem::path output_path = std::filesystem::path(output_directory) / input_path.filename().replace_extension(".adpcm");
+    if (!write_adpcm_file(output_path.c_str(), sample_rate_hz, static_cast<uint32_t>(frame_count), blocks)) {
+      printf("failed to write: %s\n", output_path.c_str());
+      ++error_count;
+      continue;
+    }
+
+    const uint64_t input_bytes  = std::filesystem::file_size(input_path, error);
+    const uint64_t output_bytes = std::filesystem::file_size(output_path, error);
+    total_input_bytes  += input_bytes;
+    total_output_bytes += output_bytes;
+    printf("%-20s %8llu frames  %8.1f KiB -> %7.1f KiB %s\n", input_path.filename().c_str(), (unsigned long long)frame_count, input_bytes / 1024.0,
+           output_bytes / 1024.0, output_path.filename().c_str());
+  }
+
+  printf("\n%.1f KiB -> %.1f KiB, %.1fx smaller, %u errors\n", total_input_bytes / 1024.0, total_output_bytes / 1024.0,
+         static_cast<double>(total_input_bytes) / static_cast<double>(std::max<uint64_t>(total_output_bytes, 1)), error_count);
+  return (error_count == 0) ? 0 : 1;
+}
@@ -0,0 +1,121 @@
+// decodes the game's sounds from AudioSampleBank the way the audio callback reads a voice, a SAMPLE_COUNT of frames at a time, and reports the
+// time per frame against copying them from the f32 frames the bank held before, its memory against theirs and the signal to noise ratio
+// usage: audio_adpcm_benchmark [repetitions]
+
+#define TOM_ENGINE_AUDIO_MIXER_IMPLEMENTATION
+#include "audio_mixer.h"
+
+#define MINIAUDIO_IMPLEMENTATION
+#include <miniaudio.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+constexpr const char* sound_names[]  = { "place_bomb", "explosion", "start_bell", "white_win", "red_win", "green_win", "blue_win", "white_death", "red_death", "green_death", "blue_death" };
+constexpr uint32_t    sound_count    = sizeof(sound_names) / sizeof(sound_names[0]);
+constexpr uint32_t    sample_rate_hz = 48000;
+constexpr uint32_t    sample_count   = 480;  // frames read at a time like SAMPLE_COUNT of the device backends
+
+static uint64_t get_file_byte_count(const std::string& file_path) {
+  FILE* file = fopen(file_path.c_str(), "rb");
+  if (file == nullptr) return 0;
+  fseek(file, 0, SEEK_END);
+  const uint64_t byte_count = static_cast<uint64_t>(ftell(file));
+  fclose(file);
+  return byte_count;
+}
+
+int main(int argc, char** argv) {
+  const uint32_t repetitions = (argc > 1) ? static_cast<uint32_t>(strtoul(argv[1], nullptr, 10)) : 20;
+
+  AudioSampleBank    sample_bank;
+  std::vector<float> source_frames[sound_count];  // what the bank held before
+  uint64_t source_file_byte_count = 0;
+  uint64_t adpcm_file_byte_count  = 0;
+  uint64_t source_byte_count      = 0;
+  uint32_t error_count            = 0;
+  printf("sound         frames    snr\n");
+  for (uint32_t i=0; i < sound_count; ++i) {
+    const std::string adpcm_path  = std::string(BENCHMARK_ASSET_DIRECTORY) + "assets/sounds/" + sound_names[i] + ".adpcm";
+    const std::string source_path = std::string(BENCHMARK_ASSET_DIRECTORY) + "assets_source/sounds/" + sound_names[i] + ".wav";
+    if (sample_bank.load_from_file(adpcm_path.c_str(), sample_rate_hz) != i) {
+      printf("failed to read: %s\n", adpcm_path.c_str());
+      return 1;
+    }
+
+    ma_decoder_config config = ma_decoder_config_init(ma_format_f32, 1, sample_rate_hz);
+    ma_uint64 frame_count;
+    void*     frames;
+    if (ma_decode_file(source_path.c_str(), &config, &frame_count, &frames) != MA_SUCCESS) {
+      printf("failed to decode: %s\n", source_path.c_str());
+      return 1;
+    }
+    source_frames[i].assign(static_cast<float*>(frames), static_cast<float*>(frames) + frame_count);
+    ma_free(frames, nullptr);
+    source_file_byte_count += get_file_byte_count(source_path);
+    adpcm_file_byte_count  += get_file_byte_count(adpcm_path);
+    source_byte_count      += source_frames[i].size() * sizeof(float);
+
+    // the whole sound read from a cursor that isn't at the start of a block, wrapping around like a looping voice
+    std::vector<float> decoded_frames(source_frames[i].size());
+    uint32_t           cursor = 13;
+    const uint32_t     read   = read_audio_sample_frames(sample_bank, i, cursor, true, decoded_frames.data() + 13, static_cast<uint32_t>(decoded_frames.size()) - 13) +
+                                read_audio_sample_frames(sample_bank, i, cursor, true, decoded_frames.data(), 13);
+    if ( (read != decoded_frames.size()) || (sample_bank.frame_counts[i] != source_frames[i].size()) ) ++error_count;
+
+    double signal = 0.0;
+    double noise  = 0.0;
+    for (size_t j=0; j < decoded_frames.size(); ++j) {
+      signal += double(source_frames[i][j]) * source_frames[i][j];
+      noise  += double(decoded_frames[j] - source_frames[i][j]) * (decoded_frames[j] - source_frames[i][j]);
+    }
+    const double snr = 10.0 * std::log10(signal / std::max(noise, 1e-12));
+    if (snr < 20.0) ++error_count;  // place_bomb and start_bell are the worst at about 21 dB, accepted (see README.md)
+    printf("%-12s %7zu  %5.1f dB\n", sound_names[i], decoded_frames.size(), snr);
+  }
+
+  // every sound read through a SAMPLE_COUNT of frames at a time
+  float    output[sample_count];
+  float    checksum = 0.0f;
+  uint64_t total_frame_count = 0;
+  const auto adpcm_start = std::chrono::steady_clock::now();
+  for (uint32_t repetition=0; repetition < repetitions; ++repetition) {
+    for (uint32_t i=0; i < sound_count; ++i) {
+      uint32_t cursor = 0;
+      for (uint32_t frames_read=1; frames_read > 0;) {
+        frames_read        = read_audio_sample_frames(sample_bank, i, cursor, false, output, sample_count);
+        checksum          += output[0];
+        total_frame_count += frames_read;
+      }
+    }
+  }
+  const double adpcm_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - adpcm_start).count();
+
+  const auto copy_start = std::chrono::steady_clock::now();
+  for (uint32_t repetition=0; repetition < repetitions; ++repetition) {
+    for (uint32_t i=0; i < sound_count; ++i) {
+      for (size_t cursor=0; cursor < source_frames[i].size(); cursor += sample_count) {
+        const size_t frames_read = std::min<size_t>(sample_count, source_frames[i].size() - cursor);
+        memcpy(output, source_frames[i].data() + cursor, frames_read * sizeof(float));
+        checksum += output[0];
+      }
+    }
+  }
+  const double copy_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - copy_start).count();
+
+  const double adpcm_nanoseconds = (adpcm_seconds * 1e9) / static_cast<double>(total_frame_count);
+  const double copy_nanoseconds  = (copy_seconds * 1e9) / static_cast<double>(total_frame_count);
+  printf("\n%u sounds read %u times, %llu frames (checksum %g)\n", sound_count, repetitions, (unsigned long long)total_frame_count, checksum);
+  printf("adpcm decode: %6.2f ns per frame, %6.2f us per voice per 10 ms block\n", adpcm_nanoseconds, adpcm_nanoseconds * (sample_rate_hz / 100) / 1000.0);
+  printf("f32 copy:     %6.2f ns per frame, %6.2f us per voice per 10 ms block\n", copy_nanoseconds, copy_nanoseconds * (sample_rate_hz / 100) / 1000.0);
+  printf("memory: %.1f KiB of adpcm against %.1f KiB of f32, %.1fx smaller\n", sample_bank.get_byte_count() / 1024.0, source_byte_count / 1024.0,
+         static_cast<double>(source_byte_count) / static_cast<double>(sample_bank.get_byte_count()));
+  printf("files:  %.1f KiB of adpcm against %.1f KiB of wav, %.1fx smaller\n", adpcm_file_byte_count / 1024.0, source_file_byte_count / 1024.0,
+         static_cast<double>(source_file_byte_count) / static_cast<double>(adpcm_file_byte_count));
+  printf("%u errors\n", error_count);
+
+  return (error_count == 0) ? 0 : 1;
+}
@@ -0,0 +1,152 @@
+// pushes audio commands from one thread while the audio callback of a miniaudio null device pops them into AudioVoices and mixes it like the
+// device backends do without a spatializer, it's built with ThreadSanitizer so a data race between the two fails the run, commands are also
+// checked to arrive in order and none lost, and every command type has to be applied
+// bursts bigger than the queue are pushed every second so dropping is exercised too
+// usage: audio_command_queue_stress [commands_per_second] [seconds]
+
+#define TOM_ENGINE_AUDIO_MIXER_IMPLEMENTATION
+#include "audio_mixer.h"
+
+#define MINIAUDIO_IMPLEMENTATION
+#include <miniaudio.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+
+constexpr uint32_t sample_rate_hz     = 48000;
+constexpr uint32_t period_frame_count = 480;  // 10 ms like the device backends
+constexpr uint32_t channel_count      = 2;
+constexpr uint32_t command_type_count = 6;
+constexpr uint32_t sample_frame_count = sample_rate_hz / 4;
+
+// only touched by the audio callback
+AudioSampleBank stress_sample_bank;
+AudioVoices     stress_voices;
+uint64_t        last_sequence             = 0;
+uint64_t        out_of_order_count        = 0;
+uint32_t        max_commands_per_callback = 0;
+uint64_t        applied_type_counts[command_type_count] = {};
+
+AudioCommandQueue     stress_command_queue;
+std::atomic<uint64_t> applied_command_count{0};
+std::atomic<uint64_t> callback_count{0};
+
+void stress_data_callback(ma_device* device, void* output, const void* input, ma_uint32 frame_count) {
+  uint32_t command_count = 0;
+  AudioCommand command;
+  while (stress_command_queue.pop(command)) {
+    // every command carries its push order in position.y, it's put back on the floor before the voices see it
+    const uint64_t sequence = static_cast<uint64_t>(command.position.y);
+    if (sequence <= last_sequence) ++out_of_order_count;
+    last_sequence      = sequence;
+    command.position.y = 0.0f;
+
+    stress_voices.apply_command(command);
+    ++applied_type_counts[static_cast<uint32_t>(command.type)];
+    ++command_count;
+  }
+  max_commands_per_callback = std::max(max_commands_per_callback, command_count);
+
+  // the listener at the origin facing down -z, near voices are panned and far ones virtual
+  float* mix_buffer = static_cast<float*>(output);
+  stress_voices.update_tiers({ 0.0f, 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f });
+  stress_voices.is_real_voice_reassigned.reset();  // there's no spatializer to set them up
+  stress_voices.mix_panned_voices(stress_sample_bank, mix_buffer, frame_count);
+  stress_voices.advance_virtual_voices(stress_sample_bank, frame_count);
+
+  // real voices are read like the spatializer does and put in the middle instead
+  float          samples[period_frame_count];
+  const uint32_t real_frame_count = std::min(static_cast<uint32_t>(frame_count), period_frame_count);
+  for (AudioVoices::Index real_voice_index=0; real_voice_index < AudioVoices::max_real_count; ++real_voice_index) {
+    const AudioVoices::Index voice_index = stress_voices.real_voice_owners[real_voice_index];
+    if (voice_index == AudioVoices::no_voice) continue;
+
+    AudioVoices::Voice& voice       = stress_voices.voices[voice_index];
+    const uint32_t      frames_read = read_audio_sample_frames(stress_sample_bank, stress_voices.source_parameters[voice.source_id].sample_index, voice.cursor, voice.is_looping, samples, real_frame_count);
+    accumulate_mono_audio_samples_to_stereo(mix_buffer, samples, voice.next_spatialized_gain, voice.next_spatialized_gain, frames_read);
+    if (frames_read < real_frame_count) stress_voices.stop_voice(voice_index, false);
+  }
+
+  applied_command_count.fetch_add(command_count, std::memory_order_relaxed);
+  callback_count.fetch_add(1, std::memory_order_relaxed);
+}
+
+int main(int argc, char** argv) {
+  const uint32_t commands_per_second = (argc > 1) ? static_cast<uint32_t>(strtoul(argv[1], nullptr, 10)) : 20000;
+  const uint32_t seconds             = (argc > 2) ? static_cast<uint32_t>(strtoul(argv[2], nullptr, 10)) : 5;
+
+  // a quarter second tone every source plays
+  std::vector<float> samples(sample_frame_count);
+  for (uint32_t i=0; i < sample_frame_count; ++i) samples[i] = 0.5f * std::sin(static_cast<float>(i) * 0.05f);
+  stress_sample_bank.add(samples.data(), sample_frame_count);
+  stress_voices.init();
+
+  ma_backend backends[] = { ma_backend_null };
+  ma_context context;
+  ma_device  device;
+  if (ma_context_init(backends, 1, nullptr, &context) != MA_SUCCESS) return 1;
+
+  ma_device_config config = ma_device_config_init(ma_device_type_playback);
+  config.playback.format    = ma_format_f32;
+  config.playback.channels  = channel_count;
+  config.sampleRate         = sample_rate_hz;
+  config.periodSizeInFrames = period_frame_count;
+  config.dataCallback       = stress_data_callback;
+  if (ma_device_init(&context, &config, &device) != MA_SUCCESS) return 1;
+  if (ma_device_start(&device) != MA_SUCCESS) return 1;
+
+  // pushed from a thread of its own like the simulation does
+  uint64_t pushed_command_count = 0;
+  std::thread producer([&]() {
+    std::mt19937 random_engine(1);
+    uint64_t sequence = 0;
+    auto push_random_command = [&]() {
+      const uint32_t id = random_engine() % AudioVoices::max_source_count;
+      AudioCommand command{ static_cast<AudioCommand::Type>(random_engine() % command_type_count), id, (random_engine() & 1) != 0 };
+      command.position   = { static_cast<float>(random_engine() % 64), static_cast<float>(++sequence), -static_cast<float>(random_engine() % 8) };
+      command.parameters = { 0, 4.0f, 16.0f, 0.0f, 1.0f, false, 1.0f };
+      stress_command_queue.push(command);
+      ++pushed_command_count;
+    };
+
+    const uint32_t commands_per_millisecond = std::max(commands_per_second / 1000, 1u);
+    const auto     start                    = std::chrono::steady_clock::now();
+    const auto     end                      = start + std::chrono::seconds(seconds);
+    auto           next_burst               = start + std::chrono::seconds(1);
+    for (auto now = start; now < end; now = std::chrono::steady_clock::now()) {
+      for (uint32_t i=0; i < commands_per_millisecond; ++i) push_random_command();
+      if (now >= next_burst) {
+        for (uint32_t i=0; i < (2 * AudioCommandQueue::max_command_count); ++i) push_random_command();
+        next_burst += std::chrono::seconds(1);
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  });
+  producer.join();
+
+  // the callback drains what's left
+  const auto drain_end = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+  while ( (stress_command_queue.read_index.load() != stress_command_queue.write_index.load()) && (std::chrono::steady_clock::now() < drain_end) ) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  ma_device_uninit(&device);
+  ma_context_uninit(&context);
+
+  const uint64_t applied = applied_command_count.load();
+  const uint64_t dropped = stress_command_queue.dropped_command_count.load();
+  printf("%llu commands pushed in %u s, %llu applied, %llu dropped by full queue\n", (unsigned long long)pushed_command_count, seconds, (unsigned long long)applied, (unsigned long long)dropped);
+  printf("%llu callbacks, at most %u commands in one, %llu out of order\n", (unsigned long long)callback_count.load(), max_commands_per_callback, (unsigned long long)out_of_order_count);
+  printf("applied set parameters %llu, play %llu, fire %llu, stop %llu, move %llu, delete %llu\n", (unsigned long long)applied_type_counts[0], (unsigned long long)applied_type_counts[1],
+         (unsigned long long)applied_type_counts[2], (unsigned long long)applied_type_counts[3], (unsigned long long)applied_type_counts[4], (unsigned long long)applied_type_counts[5]);
+  printf("%u voices stolen, last tiers %u virtual %u panned %u spatialized\n", stress_voices.stolen_voice_count, stress_voices.tier_counts[0], stress_voices.tier_counts[1], stress_voices.tier_counts[2]);
+
+  bool is_every_type_applied = true;
+  for (const uint64_t applied_type_count : applied_type_counts) is_every_type_applied &= applied_type_count > 0;
+  const bool is_passed = ((applied + dropped) == pushed_command_count) && (out_of_order_count == 0) && is_every_type_applied && (callback_count.load() > 0);
+  printf("%s\n", is_passed ? "passed" : "failed");
+  return is_passed ? 0 : 1;
+}
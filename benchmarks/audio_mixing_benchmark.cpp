@@ -0,0 +1,261 @@
+// mixes voices the way audio_data_callback of the device backends does inside the audio callback of a miniaudio null device and reports
+// the time a 10 ms block takes, first the scalar loops the backends used against the kernels of audio_mixer.h on frames decoded up front so
+// only the kernels differ, then every voice through the spatializer against the tiers of AudioVoices, both reading the adpcm sample bank
+// the oculus spatializer isn't available on linux so a mono to stereo pan with a gain per ear stands in for ovrAudio_SpatializeMonoSourceInterleaved
+// usage: audio_mixing_benchmark [block_count]
+
+#define TOM_ENGINE_AUDIO_MIXER_IMPLEMENTATION
+#include "audio_mixer.h"
+
+#define MINIAUDIO_IMPLEMENTATION
+#include <miniaudio.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+constexpr uint32_t sample_rate_hz     = 48000;
+constexpr uint32_t period_frame_count = 480;  // 10 ms like the device backends
+constexpr uint32_t channel_count      = 2;
+constexpr uint32_t sample_count       = 480;  // frames spatialized at a time like SAMPLE_COUNT of the device backends
+constexpr uint32_t voice_counts[]     = { 1, 8, 32, 128 };
+constexpr uint32_t max_voice_count    = 128;
+
+enum class MixMode { ScalarLoops, Kernels, EveryVoiceSpatialized, Tiers };
+
+struct MixingVoice {
+  uint32_t cursor;
+  float    left_gain;
+  float    right_gain;
+};
+
+// only touched by the audio callback while the device is started
+AudioSampleBank        sample_bank;
+AudioSampleBank::Index sample_index;
+std::vector<float>     source_frames;  // the sound decoded whole so the kernels are timed without adpcm decode
+MixingVoice            voices[max_voice_count];
+AudioVoices            tiered_voices;
+uint32_t               voice_count;
+MixMode                mix_mode;
+double                 total_callback_seconds;
+double                 max_callback_seconds;
+float                  last_mix[period_frame_count * channel_count];
+uint32_t               timed_block_count;
+std::atomic<uint32_t>  callback_count{0};
+
+// the same copy for both ways of mixing, wrapping around like a looping voice
+static uint32_t read_source_frames(uint32_t& cursor, float* const output, const uint32_t frame_count) {
+  uint32_t frames_read = 0;
+  while (frames_read < frame_count) {
+    const uint32_t frames_to_copy = std::min(frame_count - frames_read, static_cast<uint32_t>(source_frames.size()) - cursor);
+    memcpy(output + frames_read, source_frames.data() + cursor, frames_to_copy * sizeof(float));
+    frames_read += frames_to_copy;
+    cursor       = (cursor + frames_to_copy) % static_cast<uint32_t>(source_frames.size());
+  }
+  return frames_read;
+}
+
+static void mix_with_scalar_loops(float* const mix_buffer, const uint32_t frame_count) {
+  float original_samples[sample_count];
+  float spatialized_samples[sample_count * channel_count];
+  for (uint32_t v=0; v < voice_count; ++v) {
+    MixingVoice& voice = voices[v];
+    for (uint32_t total_frames_read=0; total_frames_read < frame_count;) {
+      for (size_t i=0; i < sample_count; ++i) original_samples[i] = 0.0f;
+      for (size_t i=0; i < (sample_count * channel_count); ++i) spatialized_samples[i] = 0.0f;
+
+      const uint32_t frames_read = read_source_frames(voice.cursor, original_samples, std::min(frame_count - total_frames_read, sample_count));
+      for (uint32_t i=0; i < sample_count; ++i) {
+        spatialized_samples[(2 * i)]     = original_samples[i] * voice.left_gain;
+        spatialized_samples[(2 * i) + 1] = original_samples[i] * voice.right_gain;
+      }
+
+      const uint32_t offset = total_frames_read * channel_count;
+      for (uint32_t sample_index=0; sample_index < (frames_read * channel_count); ++sample_index) {
+        mix_buffer[offset + sample_index] += spatialized_samples[sample_index];
+      }
+      total_frames_read += frames_read;
+    }
+  }
+  for (uint32_t i=0; i < (frame_count * channel_count); ++i) mix_buffer[i] = std::min(std::max(mix_buffer[i], -1.0f), 1.0f);
+}
+
+static void mix_with_kernels(float* const mix_buffer, const uint32_t frame_count, const bool is_decoding) {
+  float original_samples[sample_count];
+  float spatialized_samples[sample_count * channel_count];
+  for (uint32_t v=0; v < voice_count; ++v) {
+    MixingVoice& voice = voices[v];
+    for (uint32_t total_frames_read=0; total_frames_read < frame_count;) {
+      clear_audio_samples(original_samples, sample_count);
+      clear_audio_samples(spatialized_samples, sample_count * channel_count);
+
+      const uint32_t frames_to_read = std::min(frame_count - total_frames_read, sample_count);
+      const uint32_t frames_read    = is_decoding ? read_audio_sample_frames(sample_bank, sample_index, voice.cursor, true, original_samples, frames_to_read)
+                                                  : read_source_frames(voice.cursor, original_samples, frames_to_read);
+      accumulate_mono_audio_samples_to_stereo(spatialized_samples, original_samples, voice.left_gain, voice.right_gain, sample_count);
+
+      accumulate_audio_samples(mix_buffer + (total_frames_read * channel_count), spatialized_samples, frames_read * channel_count);
+      total_frames_read += frames_read;
+    }
+  }
+  clip_audio_samples(mix_buffer, frame_count * channel_count);
+}
+
+// like audio_data_callback with AudioVoices, the real voices go through the stand-in for the spatializer
+static void mix_tiers(float* const mix_buffer, const uint32_t frame_count) {
+  tiered_voices.update_tiers({ 0.0f, 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f });
+  tiered_voices.is_real_voice_reassigned.reset();  // there's no spatializer to set them up
+  tiered_voices.mix_panned_voices(sample_bank, mix_buffer, frame_count);
+  tiered_voices.advance_virtual_voices(sample_bank, frame_count);
+
+  float original_samples[sample_count];
+  for (AudioVoices::Index real_voice_index=0; real_voice_index < AudioVoices::max_real_count; ++real_voice_index) {
+    const AudioVoices::Index voice_index = tiered_voices.real_voice_owners[real_voice_index];
+    if (voice_index == AudioVoices::no_voice) continue;
+
+    AudioVoices::Voice& voice = tiered_voices.voices[voice_index];
+    for (uint32_t total_frames_read=0; total_frames_read < frame_count;) {
+      const uint32_t frames_read = read_audio_sample_frames(sample_bank, sample_index, voice.cursor, voice.is_looping, original_samples, std::min(frame_count - total_frames_read, sample_count));
+      accumulate_mono_audio_samples_to_stereo(mix_buffer + (total_frames_read * channel_count), original_samples, 0.25f * voice.next_spatialized_gain, 0.25f * voice.next_spatialized_gain, frames_read);
+      total_frames_read += frames_read;
+    }
+  }
+  clip_audio_samples(mix_buffer, frame_count * channel_count);
+}
+
+void mixing_data_callback(ma_device* device, void* output, const void* input, ma_uint32 frame_count) {
+  float* mix_buffer = static_cast<float*>(output);
+  if (callback_count.load(std::memory_order_relaxed) == timed_block_count) return;  // silence until the device is stopped
+
+  const auto start = std::chrono::steady_clock::now();
+  switch (mix_mode) {
+    case MixMode::ScalarLoops           : mix_with_scalar_loops(mix_buffer, frame_count); break;
+    case MixMode::Kernels               : mix_with_kernels(mix_buffer, frame_count, false); break;
+    case MixMode::EveryVoiceSpatialized : mix_with_kernels(mix_buffer, frame_count, true); break;
+    case MixMode::Tiers                 : mix_tiers(mix_buffer, frame_count); break;
+  }
+  const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  total_callback_seconds += seconds;
+  max_callback_seconds    = std::max(max_callback_seconds, seconds);
+  memcpy(last_mix, mix_buffer, std::min(frame_count, period_frame_count) * channel_count * sizeof(float));
+  callback_count.fetch_add(1, std::memory_order_release);
+}
+
+// runs the device until block_count callbacks are timed, the voices restart at the same cursors so every way mixes the same samples
+static bool run_blocks(ma_device& device, const MixMode mode, const uint32_t block_count, double& mean_seconds, double& max_seconds) {
+  for (uint32_t v=0; v < voice_count; ++v) {
+    const float pan = static_cast<float>(v) / static_cast<float>(max_voice_count);  // 0 is left
+    voices[v] = { (v * 997) % sample_bank.frame_counts[sample_index], 0.25f * std::cos(pan * 1.5707964f), 0.25f * std::sin(pan * 1.5707964f) };
+  }
+
+  // looping voices around the listener from 1 m to 40 m, the near ones are spatialized, the ones past the 30 m range virtual and the others panned
+  tiered_voices.init();
+  for (uint32_t i=0; i < AudioVoices::max_source_count; ++i) tiered_voices.source_parameters[i] = { sample_index, 1.0f, 30.0f, 0.0f, 0.0f, false, 1.0f };
+  for (uint32_t v=0; v < voice_count; ++v) {
+    const float distance = 1.0f + (39.0f * static_cast<float>(v) / static_cast<float>(max_voice_count));
+    const float angle    = static_cast<float>(v) * 2.3999632f;
+    const AudioVoices::Index voice_index = tiered_voices.start_voice(v % AudioVoices::max_source_count, { distance * std::cos(angle), 0.0f, distance * std::sin(angle) }, true, false);
+    tiered_voices.voices[voice_index].cursor = voices[v].cursor;
+  }
+
+  mix_mode               = mode;
+  timed_block_count      = block_count;
+  total_callback_seconds = 0.0;
+  max_callback_seconds   = 0.0;
+  callback_count.store(0, std::memory_order_relaxed);
+
+  if (ma_device_start(&device) != MA_SUCCESS) return false;
+  while (callback_count.load(std::memory_order_acquire) < block_count) ma_sleep(5);
+  if (ma_device_stop(&device) != MA_SUCCESS) return false;
+
+  mean_seconds = total_callback_seconds / block_count;
+  max_seconds  = max_callback_seconds;
+  return true;
+}
+
+int main(int argc, char** argv) {
+  const uint32_t block_count = (argc > 1) ? static_cast<uint32_t>(strtoul(argv[1], nullptr, 10)) : 200;
+
+  const std::string file_path = std::string(BENCHMARK_ASSET_DIRECTORY) + "assets/sounds/explosion.adpcm";
+  sample_index = sample_bank.load_from_file(file_path.c_str(), sample_rate_hz);
+  if (sample_index == AudioSampleBank::Index(-1)) {
+    printf("failed to decode: %s\n", file_path.c_str());
+    return 1;
+  }
+  source_frames.resize(sample_bank.frame_counts[sample_index]);
+  uint32_t source_cursor = 0;
+  read_audio_sample_frames(sample_bank, sample_index, source_cursor, false, source_frames.data(), static_cast<uint32_t>(source_frames.size()));
+
+  ma_backend backends[] = { ma_backend_null };
+  ma_context context;
+  ma_device  device;
+  if (ma_context_init(backends, 1, nullptr, &context) != MA_SUCCESS) return 1;
+
+  ma_device_config config = ma_device_config_init(ma_device_type_playback);
+  config.playback.format    = ma_format_f32;
+  config.playback.channels  = channel_count;
+  config.sampleRate         = sample_rate_hz;
+  config.periodSizeInFrames = period_frame_count;
+  config.dataCallback       = mixing_data_callback;
+  config.noClip             = MA_TRUE;
+  if (ma_device_init(&context, &config, &device) != MA_SUCCESS) return 1;
+
+#if defined(__ARM_NEON)
+  const char* kernel_name = "neon";
+#elif defined(__SSE__) || defined(_M_X64)
+  const char* kernel_name = "sse";
+#else
+  const char* kernel_name = "scalar fallback";
+#endif
+  printf("%u blocks of %u frames at %u Hz per voice count, kernels use %s\n\n", block_count, period_frame_count, sample_rate_hz, kernel_name);
+  printf("kernels on decoded f32 frames\n");
+  printf("voices  scalar mean   max      kernels mean  max      speedup  max difference\n");
+
+  uint32_t error_count = 0;
+  for (const uint32_t count : voice_counts) {
+    voice_count = count;
+
+    double scalar_seconds[2];
+    double kernel_seconds[2];
+    float  scalar_mix[period_frame_count * channel_count];
+    if (!run_blocks(device, MixMode::ScalarLoops, block_count, scalar_seconds[0], scalar_seconds[1])) return 1;
+    memcpy(scalar_mix, last_mix, sizeof(scalar_mix));
+    if (!run_blocks(device, MixMode::Kernels, block_count, kernel_seconds[0], kernel_seconds[1])) return 1;
+
+    // both mixed the same samples in their last block
+    float max_difference = 0.0f;
+    for (uint32_t i=0; i < (period_frame_count * channel_count); ++i) max_difference = std::max(max_difference, std::abs(scalar_mix[i] - last_mix[i]));
+    if (max_difference > 1e-5f) ++error_count;
+
+    printf("%6u  %8.2f us  %8.2f us  %8.2f us  %8.2f us  %5.2fx  %g\n", count, scalar_seconds[0] * 1e6, scalar_seconds[1] * 1e6,
+           kernel_seconds[0] * 1e6, kernel_seconds[1] * 1e6, scalar_seconds[0] / kernel_seconds[0], max_difference);
+  }
+
+  printf("\nevery voice spatialized against the tiers, decoding adpcm\n");
+  printf("voices  spatialized mean  max   tiers mean    max      speedup  virtual panned spatialized\n");
+  for (const uint32_t count : voice_counts) {
+    voice_count = count;
+
+    double spatialized_seconds[2];
+    double tier_seconds[2];
+    if (!run_blocks(device, MixMode::EveryVoiceSpatialized, block_count, spatialized_seconds[0], spatialized_seconds[1])) return 1;
+    if (!run_blocks(device, MixMode::Tiers, block_count, tier_seconds[0], tier_seconds[1])) return 1;
+
+    // every voice loops so each has a tier, no more than max_real_count of them spatialized
+    const uint32_t* tier_counts = tiered_voices.tier_counts;
+    if ( ((tier_counts[0] + tier_counts[1] + tier_counts[2]) != count) || (tier_counts[2] > AudioVoices::max_real_count) ) ++error_count;
+
+    printf("%6u  %8.2f us  %8.2f us  %8.2f us  %8.2f us  %5.2fx  %7u %6u %11u\n", count, spatialized_seconds[0] * 1e6, spatialized_seconds[1] * 1e6,
+           tier_seconds[0] * 1e6, tier_seconds[1] * 1e6, spatialized_seconds[0] / tier_seconds[0], tier_counts[0], tier_counts[1], tier_counts[2]);
+  }
+
+  ma_device_uninit(&device);
+  ma_context_uninit(&context);
+
+  printf("\n%u errors\n", error_count);
+  return (error_count == 0) ? 0 : 1;
+}
@@ -0,0 +1,124 @@
+// streams a sound through AudioStreams while the audio callback of a miniaudio null device mixes it like the device backends do,
+// every mixed frame is checked against the sound decoded whole like the sample bank does so a frame skipped, repeated or torn by a race fails
+// the run, it's built with ThreadSanitizer and the stream is started over every so often from a third thread like the simulation would, which
+// opens its decoder again. the default is ogg vorbis like the music the game streams, decoded by stb_vorbis through ma_decoder
+// usage: audio_stream_stress [seconds] [restarts_per_second] [file_path]
+
+#define TOM_ENGINE_AUDIO_MIXER_IMPLEMENTATION
+#include "audio_mixer.h"
+
+#define STB_VORBIS_HEADER_ONLY
+#include <stb_vorbis.c>  // decodes ogg vorbis for miniaudio's decoder like core_header_implementations.cpp
+#define MINIAUDIO_IMPLEMENTATION
+#include <miniaudio.h>
+#undef STB_VORBIS_HEADER_ONLY
+#include <stb_vorbis.c>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+constexpr uint32_t sample_rate_hz     = 48000;
+constexpr uint32_t period_frame_count = 480;  // 10 ms like the device backends
+constexpr uint32_t channel_count      = 2;
+
+AudioStreams          stress_streams;
+std::vector<float>    expected_frames;  // the same sound decoded whole to check against
+std::atomic<uint64_t> mixed_frame_count{0};
+std::atomic<uint64_t> mismatched_frame_count{0};
+std::atomic<uint64_t> callback_count{0};
+
+void stress_data_callback(ma_device* device, void* output, const void* input, ma_uint32 frame_count) {
+  float*       mix_buffer = static_cast<float*>(output);
+  AudioStream& stream     = stress_streams.streams[0];
+
+  const uint64_t start_before = stream.start_frame.load(std::memory_order_relaxed);
+  const uint64_t read_before  = stream.read_frame.load(std::memory_order_relaxed);
+  stress_streams.mix(mix_buffer, frame_count);
+  const uint64_t read_after   = stream.read_frame.load(std::memory_order_relaxed);
+  const uint64_t start        = stream.start_frame.load(std::memory_order_relaxed);
+  if ( (start != start_before) || (read_after == read_before) ) {  // started over by the decode thread meanwhile or nothing mixed
+    callback_count.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  // a start moves the read frame forward to where it was decoded before any of it is mixed
+  const uint32_t frames_mixed         = static_cast<uint32_t>(read_after - std::max(read_before, start));
+  const uint64_t expected_frame_count = expected_frames.size() / channel_count;
+  uint64_t       track_frame          = std::max(read_before, start) - start;
+  uint64_t       mismatch_count       = 0;
+  for (uint32_t i=0; i < frames_mixed; ++i, ++track_frame) {
+    const float* expected = &expected_frames[(track_frame % expected_frame_count) * channel_count];
+    if ( (std::abs(mix_buffer[(i * channel_count)] - expected[0]) > 1e-6f) || (std::abs(mix_buffer[(i * channel_count) + 1] - expected[1]) > 1e-6f) ) ++mismatch_count;
+  }
+
+  mixed_frame_count.fetch_add(frames_mixed, std::memory_order_relaxed);
+  mismatched_frame_count.fetch_add(mismatch_count, std::memory_order_relaxed);
+  callback_count.fetch_add(1, std::memory_order_relaxed);
+}
+
+int main(int argc, char** argv) {
+  const uint32_t    seconds             = (argc > 1) ? static_cast<uint32_t>(strtoul(argv[1], nullptr, 10)) : 5;
+  const uint32_t    restarts_per_second = (argc > 2) ? static_cast<uint32_t>(strtoul(argv[2], nullptr, 10)) : 3;
+  const std::string file_path           = (argc > 3) ? argv[3] : std::string(BENCHMARK_ASSET_DIRECTORY) + "benchmarks/fixtures/explosion.ogg";  // explosion.wav encoded as vorbis
+
+  ma_decoder_config decoder_config = ma_decoder_config_init(ma_format_f32, channel_count, sample_rate_hz);
+  ma_uint64         frame_count;
+  void*             frames;
+  if (ma_decode_file(file_path.c_str(), &decoder_config, &frame_count, &frames) != MA_SUCCESS) {
+    printf("failed to decode: %s\n", file_path.c_str());
+    return 1;
+  }
+  expected_frames.assign(static_cast<float*>(frames), static_cast<float*>(frames) + (frame_count * channel_count));
+  ma_free(frames, nullptr);
+
+  ma_backend backends[] = { ma_backend_null };
+  ma_context context;
+  ma_device  device;
+  if (ma_context_init(backends, 1, nullptr, &context) != MA_SUCCESS) return 1;
+
+  ma_device_config config = ma_device_config_init(ma_device_type_playback);
+  config.playback.format    = ma_format_f32;
+  config.playback.channels  = channel_count;
+  config.sampleRate         = sample_rate_hz;
+  config.periodSizeInFrames = period_frame_count;
+  config.dataCallback       = stress_data_callback;
+  config.noClip             = MA_TRUE;
+  if (ma_device_init(&context, &config, &device) != MA_SUCCESS) return 1;
+
+  stress_streams.start_decode_thread(sample_rate_hz, device.playback.internalPeriodSizeInFrames);
+  if (stress_streams.open(file_path.c_str(), 1.0f) == AudioStreams::max_count) return 1;
+  if (ma_device_start(&device) != MA_SUCCESS) return 1;
+
+  // started over and stopped from a thread of its own like the simulation does
+  uint32_t restart_count = 0;
+  std::thread controller([&]() {
+    const auto end = std::chrono::steady_clock::now() + std::chrono::seconds(seconds);
+    stress_streams.streams[0].play(true);
+    while (std::chrono::steady_clock::now() < end) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1000 / std::max(restarts_per_second, 1u)));
+      if ((restart_count % 4) == 3) {
+        stress_streams.streams[0].stop();
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      }
+      stress_streams.streams[0].play((restart_count % 2) == 0);
+      ++restart_count;
+    }
+  });
+  controller.join();
+
+  ma_device_uninit(&device);
+  stress_streams.stop_decode_thread();
+  ma_context_uninit(&context);
+
+  const AudioStream& stream = stress_streams.streams[0];
+  printf("%s\n%llu frames mixed in %llu callbacks, %u restarts\n", file_path.c_str(), (unsigned long long)mixed_frame_count.load(), (unsigned long long)callback_count.load(), restart_count);
+  printf("ring of %u frames (%.1f KiB) against %.1f KiB decoded whole, %u underruns, %llu mismatched frames\n", stream.frame_capacity,
+         (stream.ring.size() * sizeof(float)) / 1024.0, (expected_frames.size() * sizeof(float)) / 1024.0, stream.underrun_count.load(), (unsigned long long)mismatched_frame_count.load());
+  stress_streams.streams[0].close();
+
+  const bool is_passed = (mismatched_frame_count.load() == 0) && (stream.underrun_count.load() == 0) && (mixed_frame_count.load() > 0);
+  printf("%s\n", is_passed ? "passed" : "failed");
+  return is_passed ? 0 : 1;
+}
@@ -0,0 +1,267 @@
+// fills random boards with bricks, bombs, fire and players and checks BombSystem::propagate_blast against the per-tile ray walk
+// it replaced, every ray from every tile first, then a tick of detonations resolved by BombSystem::update against the ray walk resolving
+// the same chain reactions on a copy of the board: tile states, eliminated players and chained detonations have to be identical
+// simulation.cpp is included rather than linked so the systems it keeps to itself can be set up directly
+// usage: bomb_blast_benchmark [trial_count] [seed] [board_width] [board_height] [player_count]
+
+#include "simulation.cpp"
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+
+// the board as the ray walk sees it, players are counted per tile like MovementSystem did before the occupancy planes
+struct ReferenceBoard {
+  std::vector<Board::TileState> tile_states;
+  std::vector<uint32_t>         player_counts;
+  std::vector<uint32_t>         player_tile_indexes;
+  std::vector<bool>             is_player_alive;
+  std::vector<bool>             is_bomb_scheduled;
+  std::vector<uint32_t>         detonating_tile_indexes;
+  size_t row_count;
+  size_t column_count;
+  uint32_t blast_radius_tiles;
+
+  // the ray walk of BombSystem::update before the bitplanes: stops before a stone and on the first brick, bomb or player
+  uint32_t count_blast_tiles(const uint32_t tile_index, const int32_t row_step, const int32_t column_step) const {
+    const int32_t row_index    = static_cast<int32_t>(tile_index / column_count);
+    const int32_t column_index = static_cast<int32_t>(tile_index % column_count);
+
+    uint32_t count = 0;
+    for (int32_t i=1; i <= int32_t(blast_radius_tiles); ++i) {
+      const int32_t target_row_index    = row_index + (i * row_step);
+      const int32_t target_column_index = column_index + (i * column_step);
+      if ( (target_row_index < 0) || (target_row_index >= int32_t(row_count)) || (target_column_index < 0) || (target_column_index >= int32_t(column_count)) ) break;
+
+      const size_t target_tile_index = (size_t(target_row_index) * column_count) + size_t(target_column_index);
+      if (tile_states[target_tile_index] == Board::TileState::Stone) break;
+
+      ++count;
+      if ( (tile_states[target_tile_index] == Board::TileState::Brick) || (tile_states[target_tile_index] == Board::TileState::Bomb) ) break;
+      if (player_counts[target_tile_index] > 0) break;
+    }
+    return count;
+  }
+
+  void explode_tile(const uint32_t tile_index) {
+    if (tile_states[tile_index] == Board::TileState::Bomb && is_bomb_scheduled[tile_index]) {
+      is_bomb_scheduled[tile_index] = false;
+      detonating_tile_indexes.push_back(tile_index);
+    }
+    for (uint32_t player_index=0; (player_index < player_tile_indexes.size()) && (player_counts[tile_index] > 0); ++player_index) {
+      if (player_tile_indexes[player_index] != tile_index) continue;
+      is_player_alive[player_index]     = false;
+      player_tile_indexes[player_index] = MovementSystem::hide_tile_index;
+      player_counts[tile_index]        -= 1;
+    }
+    tile_states[tile_index] = Board::TileState::Fire;
+  }
+
+  // breadth first through chain reactions like BombSystem::update, rays go up, down, right then left
+  void resolve(const uint32_t* const first_tile_indexes, const size_t first_count) {
+    detonating_tile_indexes.assign(first_tile_indexes, first_tile_indexes + first_count);
+    for (size_t i=0; i < first_count; ++i) is_bomb_scheduled[first_tile_indexes[i]] = false;
+
+    for (size_t i=0; i < detonating_tile_indexes.size(); ++i) {
+      const uint32_t tile_index = detonating_tile_indexes[i];
+      tile_states[tile_index] = Board::TileState::Empty;
+
+      const uint32_t counts[4] = { count_blast_tiles(tile_index, -1, 0), count_blast_tiles(tile_index, 1, 0), count_blast_tiles(tile_index, 0, 1), count_blast_tiles(tile_index, 0, -1) };
+      const int32_t  steps[4]  = { -int32_t(column_count), int32_t(column_count), 1, -1 };
+      explode_tile(tile_index);
+      for (uint32_t direction=0; direction < 4; ++direction) {
+        for (uint32_t j=1; j <= counts[direction]; ++j) explode_tile(static_cast<uint32_t>(int32_t(tile_index) + (int32_t(j) * steps[direction])));
+      }
+    }
+  }
+};
+
+// the four rays of a tile through propagate_blast, in the order detonate asks for them
+static void count_propagated_blast_tiles(const uint32_t tile_index, uint32_t counts[4]) {
+  const int32_t column_index = static_cast<int32_t>(board->calculate_column_index_from_tile_index(tile_index));
+  const int32_t row_index    = static_cast<int32_t>(board->calculate_row_index_from_tile_index(tile_index));
+  counts[0] = bomb_system->propagate_blast(tile_index, -int32_t(board->floor_column_count), row_index);
+  counts[1] = bomb_system->propagate_blast(tile_index, int32_t(board->floor_column_count), (int32_t(board->floor_row_count) - 1) - row_index);
+  counts[2] = bomb_system->propagate_blast(tile_index, 1, (int32_t(board->floor_column_count) - 1) - column_index);
+  counts[3] = bomb_system->propagate_blast(tile_index, -1, column_index);
+}
+
+// a random mix of bricks, bombs and fire on every tile but the stones, players on distinct tiles without a brick or fire
+static void fill_random_board(tom::Random& random, std::vector<uint32_t>& first_detonations) {
+  movement_system->reset(game_state, board, players.data(), sim_state.player_count);
+  bomb_system->reset(game_state, board, movement_system, sound_system);
+  game_state->restart_game();
+  first_detonations.clear();
+
+  const uint32_t brick_percent = random.next_below(50);
+  const uint32_t bomb_percent  = 5 + random.next_below(30);
+  const uint32_t fire_percent  = random.next_below(20);
+  for (uint32_t tile_index=0; tile_index < board->tile_count; ++tile_index) {
+    if (board->tile_states[tile_index] == Board::TileState::Stone) continue;
+    board->set_tile_state(tile_index, Board::TileState::Empty);
+
+    const uint32_t roll = random.next_below(100);
+    if (roll < brick_percent) {
+      board->set_tile_state(tile_index, Board::TileState::Brick);
+    } else if (roll < (brick_percent + bomb_percent)) {  // about a third go off this tick, the rest later unless a blast reaches them
+      const bool is_due_now = random.next_below(3) == 0;
+      board->show_bomb(tile_index);
+      bomb_system->detonations.schedule(tile_index, is_due_now ? 1 : (2 + random.next_below(bomb_system->detonation_time_ticks - 1)));
+      if (is_due_now) first_detonations.push_back(tile_index);
+    } else if (roll < (brick_percent + bomb_percent + fire_percent)) {
+      board->show_fire(tile_index);
+      bomb_system->fire_expiries.schedule(tile_index, 2 + random.next_below(bomb_system->explosion_time_ticks - 1));
+    }
+  }
+
+  for (uint32_t tile_index=0; tile_index < board->tile_count; ++tile_index) {  // like reset_tile_states so destroy_brick updates a consistent field
+    board->brick_spot_distances.set_tile_walkable(tile_index, (board->tile_states[tile_index] != Board::TileState::Stone) && (board->tile_states[tile_index] != Board::TileState::Brick));
+    board->brick_spot_distances.set_tile_source(tile_index, board->is_brick_spot(tile_index));
+  }
+  board->brick_spot_distances.rebuild();
+  bomb_system->danger_map.rebuild(bomb_system->detonations);
+
+  for (uint32_t player_index=0; player_index < movement_system->player_count; ++player_index) {
+    MovementSystem::PlayerMovementState& movement_state = movement_system->player_movement_states[player_index];
+    movement_system->set_tile_indexes(movement_state, MovementSystem::hide_tile_index, MovementSystem::hide_tile_index);
+  }
+  for (uint32_t player_index=0; player_index < movement_system->player_count; ++player_index) {
+    MovementSystem::PlayerMovementState& movement_state = movement_system->player_movement_states[player_index];
+    for (uint32_t attempt=0; attempt < 64; ++attempt) {
+      const uint32_t tile_index = random.next_below(static_cast<uint32_t>(board->tile_count));
+      const Board::TileState state = board->tile_states[tile_index];
+      if ( ((state == Board::TileState::Empty) || (state == Board::TileState::Bomb)) && !movement_system->current_tile_bits.test(tile_index) ) {
+        movement_system->set_tile_indexes(movement_state, tile_index, tile_index);
+        break;
+      }
+    }
+    if (movement_state.current_tile_index == MovementSystem::hide_tile_index) game_state->eliminate_player(player_index);  // no room left
+  }
+}
+
+static ReferenceBoard copy_reference_board() {
+  ReferenceBoard reference;
+  reference.tile_states        = board->tile_states;
+  reference.row_count          = board->floor_row_count;
+  reference.column_count       = board->floor_column_count;
+  reference.blast_radius_tiles = bomb_system->blast_radius_tiles;
+  reference.player_counts.assign(board->tile_count, 0);
+  reference.is_player_alive.assign(game_state->is_player_alive.begin(), game_state->is_player_alive.end());
+  for (uint32_t player_index=0; player_index < movement_system->player_count; ++player_index) {
+    const uint32_t tile_index = movement_system->player_movement_states[player_index].current_tile_index;
+    reference.player_tile_indexes.push_back(tile_index);
+    if (tile_index != MovementSystem::hide_tile_index) reference.player_counts[tile_index] += 1;
+  }
+  reference.is_bomb_scheduled.resize(board->tile_count);
+  for (uint32_t tile_index=0; tile_index < board->tile_count; ++tile_index) reference.is_bomb_scheduled[tile_index] = bomb_system->detonations.is_scheduled(tile_index);
+  return reference;
+}
+
+int main(int argc, char** argv) {
+  const uint32_t trial_count = (argc > 1) ? static_cast<uint32_t>(strtoul(argv[1], nullptr, 10)) : 2000;
+  const uint64_t seed        = (argc > 2) ? static_cast<uint64_t>(strtoull(argv[2], nullptr, 10)) : 1;
+  sim_state.board_width  = (argc > 3) ? static_cast<uint32_t>(strtoul(argv[3], nullptr, 10)) : 31;
+  sim_state.board_height = (argc > 4) ? static_cast<uint32_t>(strtoul(argv[4], nullptr, 10)) : 25;
+  sim_state.player_count = (argc > 5) ? static_cast<uint32_t>(strtoul(argv[5], nullptr, 10)) : 16;
+
+  if (chdir(BENCHMARK_ASSET_DIRECTORY) != 0) {  // the simulation loads models with paths relative to the solution directory
+    printf("could not change directory to %s\n", BENCHMARK_ASSET_DIRECTORY);
+    return 1;
+  }
+
+  init_graphics();
+  init_audio();
+  sim_state.is_player_1_ai_controlled = true;
+  sim_state.init(seed);
+
+  tom::Random random;
+  random.seed(seed, 1);
+  std::vector<uint32_t> first_detonations;
+  uint64_t ray_count         = 0;
+  uint64_t ray_error_count   = 0;
+  uint64_t tick_error_count  = 0;
+  uint64_t detonation_count  = 0;
+  uint64_t chained_count     = 0;
+  uint64_t elimination_count = 0;
+  uint64_t walk_nanoseconds      = 0;
+  uint64_t propagate_nanoseconds = 0;
+  uint64_t checksum              = 0;
+  for (uint32_t trial=0; trial < trial_count; ++trial) {
+    fill_random_board(random, first_detonations);
+    const ReferenceBoard initial_reference = copy_reference_board();
+
+    // every ray from every tile that isn't a stone, timed both ways
+    tom::Clock clock;
+    clock.start();
+    for (uint32_t tile_index=0; tile_index < board->tile_count; ++tile_index) {
+      if (initial_reference.tile_states[tile_index] == Board::TileState::Stone) continue;
+      checksum += initial_reference.count_blast_tiles(tile_index, -1, 0) + initial_reference.count_blast_tiles(tile_index, 1, 0) +
+                  initial_reference.count_blast_tiles(tile_index, 0, 1) + initial_reference.count_blast_tiles(tile_index, 0, -1);
+    }
+    clock.stop();
+    walk_nanoseconds += clock.get_elapsed_time_nanoseconds();
+
+    clock.start();
+    for (uint32_t tile_index=0; tile_index < board->tile_count; ++tile_index) {
+      if (board->tile_states[tile_index] == Board::TileState::Stone) continue;
+      uint32_t counts[4];
+      count_propagated_blast_tiles(tile_index, counts);
+      checksum -= counts[0] + counts[1] + counts[2] + counts[3];
+    }
+    clock.stop();
+    propagate_nanoseconds += clock.get_elapsed_time_nanoseconds();
+
+    for (uint32_t tile_index=0; tile_index < board->tile_count; ++tile_index) {
+      if (board->tile_states[tile_index] == Board::TileState::Stone) continue;
+      uint32_t counts[4];
+      count_propagated_blast_tiles(tile_index, counts);
+      const uint32_t expected[4] = { initial_reference.count_blast_tiles(tile_index, -1, 0), initial_reference.count_blast_tiles(tile_index, 1, 0),
+                                     initial_reference.count_blast_tiles(tile_index, 0, 1), initial_reference.count_blast_tiles(tile_index, 0, -1) };
+      for (uint32_t direction=0; direction < 4; ++direction) {
+        ++ray_count;
+        if (counts[direction] == expected[direction]) continue;
+        if (ray_error_count < 8) printf("trial %u tile %u direction %u: propagate_blast %u, ray walk %u\n", trial, tile_index, direction, counts[direction], expected[direction]);
+        ++ray_error_count;
+      }
+    }
+
+    // one tick of detonations, the wheel decides the order the first bombs go off in so the ray walk starts from the same order
+    bomb_system->update();
+    ReferenceBoard reference = initial_reference;
+    const size_t   first_count = first_detonations.size();
+    bool is_matching = bomb_system->detonating_tile_indexes.size() >= first_count;
+    if (is_matching) {
+      std::vector<uint32_t> popped(bomb_system->detonating_tile_indexes.begin(), bomb_system->detonating_tile_indexes.begin() + first_count);
+      std::sort(popped.begin(), popped.end());
+      is_matching = popped == first_detonations;
+    }
+    if (is_matching) {
+      reference.resolve(bomb_system->detonating_tile_indexes.data(), first_count);
+      is_matching = (reference.detonating_tile_indexes == bomb_system->detonating_tile_indexes) && (reference.tile_states == board->tile_states) &&
+                    std::equal(reference.is_player_alive.begin(), reference.is_player_alive.end(), game_state->is_player_alive.begin());
+    }
+    if (!is_matching) {
+      if (tick_error_count < 8) printf("trial %u: the tick differs from the ray walk\n", trial);
+      ++tick_error_count;
+    }
+
+    detonation_count += bomb_system->detonating_tile_indexes.size();
+    chained_count    += bomb_system->detonating_tile_indexes.size() - first_count;
+    for (uint32_t player_index=0; player_index < movement_system->player_count; ++player_index) {
+      elimination_count += static_cast<uint64_t>(initial_reference.is_player_alive[player_index] && !game_state->is_player_alive[player_index]);
+    }
+  }
+
+  printf("board %ux%u, %u players, %u random boards (seed %llu)\n", sim_state.board_width, sim_state.board_height, sim_state.player_count, trial_count, static_cast<unsigned long long>(seed));
+  printf("rays: %llu compared, %llu differ\n", static_cast<unsigned long long>(ray_count), static_cast<unsigned long long>(ray_error_count));
+  printf("ticks: %llu detonations of which %llu chained, %llu players eliminated, %llu ticks differ\n", static_cast<unsigned long long>(detonation_count),
+         static_cast<unsigned long long>(chained_count), static_cast<unsigned long long>(elimination_count), static_cast<unsigned long long>(tick_error_count));
+  printf("ray walk %.2f ns per ray, propagate_blast %.2f ns per ray (checksum %lld)\n", static_cast<double>(walk_nanoseconds) / static_cast<double>(ray_count),
+         static_cast<double>(propagate_nanoseconds) / static_cast<double>(ray_count), static_cast<long long>(checksum));
+
+  deactivate_audio();
+  deactivate_graphics();
+
+  const bool is_passed = (ray_error_count == 0) && (tick_error_count == 0) && (chained_count > 0) && (elimination_count > 0);
+  printf("%s\n", is_passed ? "passed" : "failed");
+  return is_passed ? 0 : 1;
+}
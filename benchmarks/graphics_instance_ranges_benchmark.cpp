@@ -0,0 +1,134 @@
+// checks GraphicsInstanceRanges: a freed range is handed out again to the next request of its size class and not to another class,
+// freeing the topmost range gives its slots back to the end, and every free bumps the generation so a handle kept from before is
+// rejected by is_current like update_graphics_mesh_instance_array asserts, then allocates and frees random sizes against an owner per
+// slot so live ranges never overlap, and times the allocate and free pairs
+// usage: graphics_instance_ranges_benchmark [operation_count] [seed]
+
+#include "graphics.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+constexpr uint32_t max_count       = 1 << 16;
+constexpr uint32_t max_live_count  = 256;  // ranges of up to max_range_size so the size classes can't carve out more than max_count
+constexpr uint32_t max_range_size  = 64;
+constexpr uint32_t no_owner        = uint32_t(-1);
+
+struct Handle {  // what a GraphicsMeshInstanceArray keeps
+  uint32_t first;
+  uint32_t size;
+  uint32_t generation;
+};
+
+static GraphicsInstanceRanges<max_count> ranges;  // zeroed like graphics_all_mesh_instances
+
+static uint32_t error_count = 0;
+
+static void check(const bool is_passed, const char* const description) {
+  if (is_passed) return;
+  printf("  failed: %s\n", description);
+  ++error_count;
+}
+
+static Handle allocate(const uint32_t size) {
+  const uint32_t first = ranges.allocate(size);
+  return { first, size, ranges.generations[first] };
+}
+
+static void run_checks() {
+  const Handle a = allocate(3);
+  const Handle b = allocate(4);
+  const Handle c = allocate(1);
+  check(ranges.get_range_size(a.first) == 4, "3 slots are rounded up to a range of 4");
+  check((b.first == a.first + 4) && (c.first == b.first + 4), "ranges are handed out from the end one after the other");
+
+  ranges.free(a.first);
+  check(!ranges.is_current(a.first, a.generation), "freeing a range bumps its generation");
+  const Handle other_class = allocate(8);
+  check(other_class.first != a.first, "a free range isn't handed out to another size class");
+  const Handle reused = allocate(4);
+  check(reused.first == a.first, "a free range is handed out again to its size class");
+  check(reused.generation != a.generation, "a reused range has a new generation");
+  check(!ranges.is_current(a.first, a.generation), "the handle from before the free is rejected");
+  check(ranges.is_current(reused.first, reused.generation), "the handle of the reused range is accepted");
+
+  const uint32_t end = ranges.end;
+  ranges.free(other_class.first);
+  check(ranges.end == other_class.first, "freeing the topmost range gives its slots back to the end");
+  const Handle from_end = allocate(5);
+  check(from_end.first == other_class.first, "slots given back to the end are handed out again");
+  check(!ranges.is_current(other_class.first, other_class.generation), "the handle of the range given back to the end is rejected");
+  check(ranges.end == end, "the end is back where it was");
+
+  ranges.free(from_end.first);
+  ranges.free(reused.first);
+  ranges.free(b.first);
+  ranges.free(c.first);
+  ranges = {};
+}
+
+int main(int argc, char** argv) {
+  const uint32_t operation_count = (argc > 1) ? static_cast<uint32_t>(strtoul(argv[1], nullptr, 10)) : 1000000;
+  const uint32_t seed            = (argc > 2) ? static_cast<uint32_t>(strtoul(argv[2], nullptr, 10)) : 1;
+
+  run_checks();
+
+  std::mt19937          random(seed);
+  std::vector<Handle>   live_handles;
+  std::vector<Handle>   stale_handles;  // the last freed ones, checked to stay rejected while their slots are handed out again
+  std::vector<uint32_t> slot_owners(max_count, no_owner);
+  live_handles.reserve(max_live_count);
+  uint64_t allocate_count = 0;
+  uint64_t free_count     = 0;
+  uint64_t nanoseconds    = 0;
+  for (uint32_t operation=0; operation < operation_count; ++operation) {
+    const bool is_allocating = live_handles.empty() || ((live_handles.size() < max_live_count) && (random() % 2 == 0));
+    if (is_allocating) {
+      const uint32_t size  = 1 + (random() % max_range_size);
+      const auto     start = std::chrono::steady_clock::now();
+      const Handle handle  = allocate(size);
+      nanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+      ++allocate_count;
+
+      check(ranges.get_range_size(handle.first) >= size, "a range holds the slots asked for");
+      for (uint32_t slot=handle.first; slot < handle.first + ranges.get_range_size(handle.first); ++slot) {
+        if (slot_owners[slot] == no_owner) {
+          slot_owners[slot] = handle.first;
+        } else {
+          check(false, "live ranges don't overlap");
+          break;
+        }
+      }
+      live_handles.push_back(handle);
+    } else {
+      const size_t handle_index = random() % live_handles.size();
+      const Handle handle       = live_handles[handle_index];
+      check(ranges.is_current(handle.first, handle.generation), "a live handle is accepted");
+      for (uint32_t slot=handle.first; slot < handle.first + ranges.get_range_size(handle.first); ++slot) slot_owners[slot] = no_owner;
+
+      const auto start = std::chrono::steady_clock::now();
+      ranges.free(handle.first);
+      nanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+      ++free_count;
+
+      live_handles[handle_index] = live_handles.back();
+      live_handles.pop_back();
+      if (stale_handles.size() == max_live_count) stale_handles.erase(stale_handles.begin());
+      stale_handles.push_back(handle);
+    }
+
+    for (const Handle& stale_handle : stale_handles) {
+      if (ranges.is_current(stale_handle.first, stale_handle.generation)) {
+        check(false, "a handle kept after its range was freed is rejected");
+        break;
+      }
+    }
+  }
+
+  printf("%llu allocations and %llu frees of 1 to %u slots, %.1f ns per operation with the clock reads, %u slots carved out of %u\n", static_cast<unsigned long long>(allocate_count),
+         static_cast<unsigned long long>(free_count), max_range_size, static_cast<double>(nanoseconds) / static_cast<double>(allocate_count + free_count), ranges.end, max_count);
+  printf("%u errors\n", error_count);
+
+  return (error_count == 0) ? 0 : 1;
+}
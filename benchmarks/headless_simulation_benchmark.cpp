@@ -0,0 +1,149 @@
+// plays AI-vs-AI matches on the headless platform as fast as possible and reports the cost of a simulation tick
+// usage: headless_simulation_benchmark [match_count] [seed] [board_width] [board_height] [player_count] [ai_rollout_count]
+// a big arena is for example: headless_simulation_benchmark 1 1 128 128 64, AIs only using the planner: headless_simulation_benchmark 20 1 15 13 4 0
+
+#include "tom_engine.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <unistd.h>
+
+constexpr uint32_t default_match_count       = 20;
+constexpr uint64_t default_seed              = 1;
+constexpr float    max_match_duration_seconds = 600.0f;  // a match where the AIs never meet is stopped instead of running forever
+constexpr uint32_t max_scope_name_count       = 16;
+
+struct ScopeTotals {
+  const char* names[max_scope_name_count];
+  uint64_t    total_profiler_ticks[max_scope_name_count];  // of the profiler's clock, not simulation ticks
+  uint64_t    call_counts[max_scope_name_count];
+  uint32_t    name_count = 0;
+
+  void add(const char* name, const uint64_t profiler_ticks) {
+    uint32_t index = 0;
+    while ( (index < name_count) && (strcmp(names[index], name) != 0) ) ++index;
+    if (index == name_count) {
+      if (name_count == max_scope_name_count) return;
+      names[index]                = name;
+      total_profiler_ticks[index] = 0;
+      call_counts[index]          = 0;
+      ++name_count;
+    }
+    total_profiler_ticks[index] += profiler_ticks;
+    call_counts[index]          += 1;
+  }
+};
+
+std::atomic<uint64_t> allocation_count{0};
+
+void* operator new(size_t size) {
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+  void* memory = malloc(size ? size : 1);
+  if (!memory) abort();
+  return memory;
+}
+void operator delete(void* memory) noexcept { free(memory); }
+void operator delete(void* memory, size_t) noexcept { free(memory); }
+
+// pairs the begin/end events recorded on this thread since the last call, the ring buffer is drained every tick so it never wraps
+static void accumulate_profiler_scopes(ScopeTotals& totals, uint64_t& read_index) {
+  const ProfilerThreadBuffer* buffer = profiler_current_thread_buffer;
+  if (!buffer) return;
+
+  struct OpenScope { const char* name; uint64_t begin_profiler_ticks; };
+  OpenScope open_scopes[32];
+  uint32_t  open_scope_count = 0;
+
+  const uint64_t write_index = buffer->write_index.load(std::memory_order_acquire);
+  for (; read_index < write_index; ++read_index) {
+    const ProfilerEvent& event = buffer->events[read_index & (ProfilerThreadBuffer::max_event_count - 1)];
+    if ( (event.type == ProfilerEvent::Type::Begin) && (open_scope_count < std::size(open_scopes)) ) {
+      open_scopes[open_scope_count++] = { event.name, event.timestamp_ticks };
+    } else if ( (event.type == ProfilerEvent::Type::End) && (open_scope_count > 0) ) {
+      const OpenScope& scope = open_scopes[--open_scope_count];
+      totals.add(scope.name, event.timestamp_ticks - scope.begin_profiler_ticks);
+    }
+  }
+}
+
+int main(int argc, char** argv) {
+  const uint32_t match_count = (argc > 1) ? static_cast<uint32_t>(strtoul(argv[1], nullptr, 10)) : default_match_count;
+  const uint64_t seed        = (argc > 2) ? static_cast<uint64_t>(strtoull(argv[2], nullptr, 10)) : default_seed;
+  if (argc > 3) sim_state.board_width  = static_cast<uint32_t>(strtoul(argv[3], nullptr, 10));
+  if (argc > 4) sim_state.board_height = static_cast<uint32_t>(strtoul(argv[4], nullptr, 10));
+  if (argc > 5) sim_state.player_count = static_cast<uint32_t>(strtoul(argv[5], nullptr, 10));
+  if (argc > 6) sim_state.ai_rollout_count = static_cast<uint32_t>(strtoul(argv[6], nullptr, 10));
+
+  if (chdir(BENCHMARK_ASSET_DIRECTORY) != 0) {  // the simulation loads models with paths relative to the solution directory
+    printf("could not change directory to %s\n", BENCHMARK_ASSET_DIRECTORY);
+    return 1;
+  }
+
+  init_graphics();
+  init_audio();
+  sim_state.is_player_1_ai_controlled = true;
+  sim_state.init(seed);
+
+  const uint32_t max_match_tick_count = static_cast<uint32_t>(max_match_duration_seconds * SimulationState::tick_rate_hz);
+  ScopeTotals scope_totals;
+  uint64_t profiler_read_index = 0;
+  uint64_t tick_count          = 0;
+  uint32_t timed_out_count     = 0;
+
+  auto tick = [&]() {
+    sim_state.advance(SimulationState::tick_duration_seconds);
+    accumulate_profiler_scopes(scope_totals, profiler_read_index);
+    ++tick_count;
+  };
+
+  tick();  // first tick allocates the profiler's thread buffer so it isn't counted
+  tick_count = 0;
+  scope_totals.name_count = 0;
+
+  const uint64_t start_allocation_count = allocation_count.load(std::memory_order_relaxed);
+  const uint64_t start_profiler_ticks   = profiler_get_ticks();
+  const uint64_t start_nanoseconds      = tom::get_steady_nanoseconds();
+
+  for (uint32_t match_index=0; match_index < match_count; ++match_index) {
+    input_state = {};
+    input_state.action_button = true;  // starts the next match
+    tick();
+    input_state.action_button = false;
+
+    uint32_t match_tick_count = 0;
+    while ( sim_state.is_match_active() && (match_tick_count < max_match_tick_count) ) {
+      tick();
+      ++match_tick_count;
+    }
+    timed_out_count += static_cast<uint32_t>(match_tick_count == max_match_tick_count);
+  }
+
+  const uint64_t end_nanoseconds               = tom::get_steady_nanoseconds();
+  const uint64_t end_profiler_ticks            = profiler_get_ticks();
+  const uint64_t total_allocations             = allocation_count.load(std::memory_order_relaxed) - start_allocation_count;
+  const double   elapsed_seconds               = static_cast<double>(end_nanoseconds - start_nanoseconds) / 1000000000.0;
+  const double   nanoseconds_per_profiler_tick = static_cast<double>(end_nanoseconds - start_nanoseconds) / static_cast<double>(end_profiler_ticks - start_profiler_ticks);  // scope totals are in ticks of the profiler's clock (rdtsc or cntvct)
+  const double   simulated_seconds             = static_cast<double>(tick_count) * SimulationState::tick_duration_seconds;
+
+  const uint32_t floor_tile_count = (sim_state.board_width - 2) * (sim_state.board_height - 2);  // like AISystem::can_look_ahead
+  const bool     is_looking_ahead = (sim_state.ai_rollout_count > 0) && (floor_tile_count <= MatchState::max_tile_count) && (sim_state.player_count <= MatchState::max_player_count);
+  printf("board %ux%u, %u players, %u AI rollouts per action (%s)\n", sim_state.board_width, sim_state.board_height, sim_state.player_count, sim_state.ai_rollout_count,
+         is_looking_ahead ? "looking ahead" : "danger map planner");
+  printf("matches %u (%u timed out), %llu ticks (%.1f s simulated) in %.3f s\n", match_count, timed_out_count, static_cast<unsigned long long>(tick_count), simulated_seconds, elapsed_seconds);
+  printf("ticks per second %.0f (%.0fx real time), %.3f us per tick, %.3f allocations per tick\n", static_cast<double>(tick_count) / elapsed_seconds, simulated_seconds / elapsed_seconds,
+         (elapsed_seconds * 1000000.0) / static_cast<double>(tick_count), static_cast<double>(total_allocations) / static_cast<double>(tick_count));
+  printf("profiler clock %.3f ns per profiler tick, the scope times below are converted with it\n", nanoseconds_per_profiler_tick);
+  printf("%-28s %12s %12s\n", "scope", "us per tick", "us per call");
+  for (uint32_t i=0; i < scope_totals.name_count; ++i) {
+    const double total_microseconds = (static_cast<double>(scope_totals.total_profiler_ticks[i]) * nanoseconds_per_profiler_tick) / 1000.0;
+    printf("%-28s %12.3f %12.3f\n", scope_totals.names[i], total_microseconds / static_cast<double>(tick_count), total_microseconds / static_cast<double>(scope_totals.call_counts[i]));
+  }
+  printf("checksum %016llx (seed %llu)\n", static_cast<unsigned long long>(sim_state.compute_checksum()), static_cast<unsigned long long>(seed));
+
+  sim_state.exit();
+  deactivate_audio();
+  deactivate_graphics();
+  return 0;
+}
@@ -0,0 +1,138 @@
+// feeds FrameMetrics synthetic frame timings and predicted display times like the platform layer does each frame and checks the nearest-rank
+// percentiles, the rolling window wrapping at RollingHistogram::window_size and the missed display deadline count against known answers,
+// then reports what recording a frame and writing a summary cost on the main thread
+// usage: metrics_benchmark [frame_count]
+
+#define TOM_ENGINE_METRICS_IMPLEMENTATION
+#include "metrics.h"
+#include "tom_std.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+uint32_t error_count = 0;
+
+static void check_summary(const char* name, const RollingHistogram::Summary& summary, const RollingHistogram::Summary& expected) {
+  const bool is_matching = (summary.p50 == expected.p50) && (summary.p90 == expected.p90) && (summary.p99 == expected.p99) && (summary.max == expected.max);
+  printf("%-28s p50 %7.1f p90 %7.1f p99 %7.1f max %7.1f %s\n", name, summary.p50, summary.p90, summary.p99, summary.max, is_matching ? "ok" : "FAILED");
+  if (!is_matching) {
+    printf("  expected p50 %7.1f p90 %7.1f p99 %7.1f max %7.1f\n", expected.p50, expected.p90, expected.p99, expected.max);
+    ++error_count;
+  }
+}
+
+static void check_count(const char* name, const uint64_t count, const uint64_t expected) {
+  printf("%-28s %llu %s\n", name, static_cast<unsigned long long>(count), (count == expected) ? "ok" : "FAILED");
+  if (count != expected) {
+    printf("  expected %llu\n", static_cast<unsigned long long>(expected));
+    ++error_count;
+  }
+}
+
+// a frame of a display with period_milliseconds that's shown periods after the previous one
+static FrameTimingSample make_sample(const float frame_milliseconds, const float period_milliseconds, int64_t& display_time_nanoseconds, const int64_t delta_nanoseconds) {
+  display_time_nanoseconds += delta_nanoseconds;
+  FrameTimingSample sample = {};
+  sample.sim_update_milliseconds               = frame_milliseconds * 0.25f;
+  sample.render_sync_wait_milliseconds         = 0.0f;
+  sample.render_thread_cpu_milliseconds        = frame_milliseconds * 0.5f;
+  sample.xr_wait_frame_milliseconds            = frame_milliseconds * 0.25f;
+  sample.frame_milliseconds                    = frame_milliseconds;
+  sample.predicted_display_period_milliseconds = period_milliseconds;
+  sample.predicted_display_time_nanoseconds    = display_time_nanoseconds;
+  sample.should_render                         = true;
+  return sample;
+}
+
+int main(int argc, char** argv) {
+  const uint32_t frame_count = (argc > 1) ? static_cast<uint32_t>(strtoul(argv[1], nullptr, 10)) : 100000;
+
+  RollingHistogram histogram;
+  check_summary("empty", histogram.summarize(), { 0.0f, 0.0f, 0.0f, 0.0f });
+
+  // 1 to 100 added out of order, the nearest rank of p is the ceil(p * count)th smallest
+  for (uint32_t i=0; i < 100; ++i) histogram.add(static_cast<float>(((i * 37) % 100) + 1));
+  check_summary("1 to 100", histogram.summarize(), { 50.0f, 90.0f, 99.0f, 100.0f });
+
+  histogram.reset();
+  histogram.add(7.0f);
+  check_summary("one value", histogram.summarize(), { 7.0f, 7.0f, 7.0f, 7.0f });
+
+  // 0 to 1023 only keep the last window_size of 512 so the window holds 512 to 1023, ranks 256, 461 and 507
+  histogram.reset();
+  for (uint32_t i=0; i < 1024; ++i) histogram.add(static_cast<float>(i));
+  check_count("count after wrap", histogram.count, RollingHistogram::window_size);
+  check_summary("0 to 1023 wrapped", histogram.summarize(), { 767.0f, 972.0f, 1018.0f, 1023.0f });
+
+  // a spike is forgotten once window_size values were added after it
+  histogram.reset();
+  histogram.add(500.0f);
+  for (uint32_t i=0; i < (RollingHistogram::window_size - 1); ++i) histogram.add(1.0f);
+  check_summary("spike in window", histogram.summarize(), { 1.0f, 1.0f, 1.0f, 500.0f });
+  histogram.add(1.0f);
+  check_summary("spike wrapped out", histogram.summarize(), { 1.0f, 1.0f, 1.0f, 1.0f });
+
+  // display time jumps at a 10 ms period, a jump of 1.5 periods or more misses round(periods) - 1 deadlines
+  FrameMetrics metrics;
+  int64_t display_time_nanoseconds = 1000000000;
+  const int64_t jumps_nanoseconds[]  = { 10000000, 10000000, 14000000, 15000000, 20000000, 30000000, 46000000, 10000000 };
+  const uint64_t expected_misses     = 0 + 0 + 0 + 1 + 1 + 2 + 4 + 0;
+  metrics.record_frame(make_sample(10.0f, 10.0f, display_time_nanoseconds, 0));  // the first frame has nothing to compare against
+  for (const int64_t jump_nanoseconds : jumps_nanoseconds) metrics.record_frame(make_sample(10.0f, 10.0f, display_time_nanoseconds, jump_nanoseconds));
+  check_count("missed at 100 Hz", metrics.missed_display_deadline_count, expected_misses);
+
+  // a frame without a predicted period is never counted but still moves the previous display time
+  metrics.record_frame(make_sample(10.0f, 0.0f, display_time_nanoseconds, 50000000));
+  metrics.record_frame(make_sample(10.0f, 10.0f, display_time_nanoseconds, 10000000));
+  check_count("missed without a period", metrics.missed_display_deadline_count, expected_misses);
+
+  // 90 Hz with a third of a period of jitter each way never misses, the 16 frames that took two periods do
+  metrics.reset();
+  const float   period_milliseconds = 1000.0f / 90.0f;
+  const int64_t period_nanoseconds  = 11111111;
+  tom::Random   random;
+  random.seed(1);
+  uint32_t summary_count = 0;
+  for (uint32_t i=0; i < 900; ++i) {
+    const int64_t jitter_nanoseconds = static_cast<int64_t>(random.next_below(2 * (period_nanoseconds / 3))) - (period_nanoseconds / 3);
+    const int64_t jump_nanoseconds   = (((i % 53) == 52) ? (2 * period_nanoseconds) : period_nanoseconds) + jitter_nanoseconds;
+    FrameTimingSample sample = make_sample(static_cast<float>(2 + (i % 10)), period_milliseconds, display_time_nanoseconds, jump_nanoseconds);
+    sample.should_render = (i % 100) != 0;
+    summary_count += static_cast<uint32_t>(metrics.record_frame(sample));
+  }
+  check_count("missed at 90 Hz with jitter", metrics.missed_display_deadline_count, 900 / 53);
+  check_count("skipped renders", metrics.skipped_render_count, 9);
+  check_count("summaries in 900 frames", summary_count, 1);  // 900 frames of 6.5 ms on average are 5.85 s, a summary is due every 5 s
+
+  // the window holds frames 388 to 899, 2 to 11 ms in turn starting at 10 ms, so 10 and 11 ms occur 52 times and the others 51
+  check_summary("frame ms 2 to 11", metrics.histograms[FrameMetrics::Frame].summarize(), { 7.0f, 11.0f, 11.0f, 11.0f });
+
+  char summary[512];
+  metrics.write_summary(summary, sizeof(summary));
+  printf("%s\n", summary);
+  if (strstr(summary, "frames 900 missed 16 skipped 9") == nullptr) ++error_count;
+
+  // what the main loop pays per frame and every summary interval
+  metrics.reset();
+  display_time_nanoseconds = 0;
+  tom::Clock record_clock;
+  record_clock.start();
+  for (uint32_t i=0; i < frame_count; ++i) {
+    metrics.record_frame(make_sample(static_cast<float>(random.next_below(1000)) * 0.02f, period_milliseconds, display_time_nanoseconds, period_nanoseconds));
+  }
+  record_clock.stop();
+
+  constexpr uint32_t summary_repetitions = 100;
+  tom::Clock summary_clock;
+  summary_clock.start();
+  for (uint32_t i=0; i < summary_repetitions; ++i) metrics.write_summary(summary, sizeof(summary));
+  summary_clock.stop();
+
+  printf("\nrecord_frame: %.1f ns per frame over %u frames\n", static_cast<double>(record_clock.get_elapsed_time_nanoseconds()) / frame_count, frame_count);
+  printf("write_summary: %.1f us for %u metrics of %u values\n", static_cast<double>(summary_clock.get_elapsed_time_nanoseconds()) / (summary_repetitions * 1000.0),
+         static_cast<uint32_t>(FrameMetrics::MetricCount), RollingHistogram::window_size);
+  printf("%u errors\n", error_count);
+
+  return (error_count == 0) ? 0 : 1;
+}
@@ -0,0 +1,110 @@
+// clears every brick of a board one at a time in random order, keeping a distance field to the closest spot next to a brick
+// the incremental updates are checked against a breadth first search from scratch after every brick and timed against it
+// usage: navigation_benchmark [seed]
+
+#define TOM_ENGINE_NAVIGATION_IMPLEMENTATION
+#include "navigation.h"
+#include "tom_std.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+struct BoardSize { uint32_t column_count; uint32_t row_count; };
+
+constexpr BoardSize board_sizes[]         = { {13, 11}, {61, 61}, {126, 126}, {254, 254} };  // floors of the default 15x13 board up to a 256x256 arena
+constexpr uint32_t  brick_percentage      = 60;
+
+struct Grid {  // the simulation's board layout: stones on odd rows and columns, bricks everywhere else but the corners
+  enum class TileState : uint8_t { Stone, Brick, Empty };
+
+  uint32_t column_count;
+  uint32_t row_count;
+  std::vector<TileState> tile_states;
+
+  bool is_walkable(const uint32_t tile_index) const { return tile_states[tile_index] == TileState::Empty; }
+
+  bool is_brick_spot(const uint32_t tile_index) const {
+    if (!is_walkable(tile_index)) return false;
+    bool is_spot = false;
+    for_each_grid_neighbour(tile_index, column_count, row_count, [&](const uint32_t neighbour_tile_index) { is_spot |= tile_states[neighbour_tile_index] == TileState::Brick; });
+    return is_spot;
+  }
+};
+
+static bool run(const BoardSize size, std::mt19937& random) {
+  Grid grid = { size.column_count, size.row_count };
+  const uint32_t tile_count = size.column_count * size.row_count;
+  grid.tile_states.assign(tile_count, Grid::TileState::Empty);
+
+  std::vector<uint32_t> brick_tile_indexes;
+  for (uint32_t tile_index=0; tile_index < tile_count; ++tile_index) {
+    const uint32_t row_index    = tile_index / size.column_count;
+    const uint32_t column_index = tile_index % size.column_count;
+    const bool     is_corner    = ( (row_index < 2) || (row_index >= size.row_count - 2) ) && ( (column_index < 2) || (column_index >= size.column_count - 2) );
+    if ( (row_index & 1) && (column_index & 1) ) {
+      grid.tile_states[tile_index] = Grid::TileState::Stone;
+    } else if ( !is_corner && ((random() % 100) < brick_percentage) ) {
+      grid.tile_states[tile_index] = Grid::TileState::Brick;
+      brick_tile_indexes.push_back(tile_index);
+    }
+  }
+  std::shuffle(brick_tile_indexes.begin(), brick_tile_indexes.end(), random);
+
+  DistanceField field;
+  field.init(size.column_count, size.row_count);
+  for (uint32_t tile_index=0; tile_index < tile_count; ++tile_index) {
+    field.set_tile_walkable(tile_index, grid.is_walkable(tile_index));
+    field.set_tile_source(tile_index, grid.is_brick_spot(tile_index));
+  }
+  field.rebuild();
+
+  uint64_t incremental_nanoseconds = 0;
+  uint64_t rebuild_nanoseconds     = 0;
+  uint32_t mismatch_count          = 0;
+  std::vector<uint32_t> expected_distances;
+
+  for (const uint32_t brick_tile_index : brick_tile_indexes) {  // the same updates as Board::destroy_brick
+    grid.tile_states[brick_tile_index] = Grid::TileState::Empty;
+
+    const uint64_t start_nanoseconds = tom::get_steady_nanoseconds();
+    field.open_tile(brick_tile_index);
+    auto update_brick_spot = [&](const uint32_t tile_index) {
+      const bool is_spot = grid.is_brick_spot(tile_index);
+      if (is_spot == field.is_tile_source[tile_index]) return;
+      if (is_spot) field.add_source(tile_index);
+      else         field.remove_source(tile_index);
+    };
+    update_brick_spot(brick_tile_index);
+    for_each_grid_neighbour(brick_tile_index, size.column_count, size.row_count, update_brick_spot);
+    const uint64_t middle_nanoseconds = tom::get_steady_nanoseconds();
+    field.compute_distances_with_breadth_first_search(expected_distances);
+    const uint64_t end_nanoseconds = tom::get_steady_nanoseconds();
+
+    incremental_nanoseconds += middle_nanoseconds - start_nanoseconds;
+    rebuild_nanoseconds     += end_nanoseconds - middle_nanoseconds;
+    mismatch_count          += static_cast<uint32_t>(expected_distances != field.distances);
+  }
+
+  const double brick_count = static_cast<double>(std::max<size_t>(brick_tile_indexes.size(), 1));
+  const double incremental_microseconds = (static_cast<double>(incremental_nanoseconds) / 1000.0) / brick_count;
+  const double rebuild_microseconds     = (static_cast<double>(rebuild_nanoseconds) / 1000.0) / brick_count;
+  printf("%4ux%-4u %8zu bricks %12.3f %12.3f %9.1fx %10u\n", size.column_count, size.row_count, brick_tile_indexes.size(), incremental_microseconds, rebuild_microseconds,
+         rebuild_microseconds / std::max(incremental_microseconds, 0.001), mismatch_count);
+  return mismatch_count == 0;
+}
+
+int main(int argc, char** argv) {
+  const uint32_t seed = (argc > 1) ? static_cast<uint32_t>(strtoul(argv[1], nullptr, 10)) : 1;
+  std::mt19937 random(seed);
+
+  printf("%-9s %15s %12s %12s %10s %10s\n", "floor", "", "us update", "us rebuild", "speedup", "mismatches");
+  bool is_matching = true;
+  for (const BoardSize size : board_sizes) {
+    is_matching &= run(size, random);
+  }
+
+  printf("%s (incremental distances %s a breadth first search from scratch after every brick)\n", is_matching ? "PASS" : "FAIL", is_matching ? "match" : "differ from");
+  return is_matching ? 0 : 1;
+}
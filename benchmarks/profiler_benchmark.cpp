@@ -0,0 +1,52 @@
+#define TOM_ENGINE_PROFILER_IMPLEMENTATION
+#include "profiler.h"
+
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+constexpr uint64_t scope_count              = 10000000;
+constexpr double   max_nanoseconds_per_scope = 50.0;
+
+static double measure_nanoseconds_per_scope() {
+  using namespace std::chrono;
+  const auto start_time_point = steady_clock::now();
+  for (uint64_t i=0; i < scope_count; ++i) {
+    PROFILE_SCOPE("benchmark_scope");
+  }
+  const auto end_time_point = steady_clock::now();
+
+  return static_cast<double>(duration_cast<nanoseconds>(end_time_point - start_time_point).count()) / static_cast<double>(scope_count);
+}
+
+int main(int argument_count, char** arguments) {
+  PROFILE_THREAD("MainThread");
+  measure_nanoseconds_per_scope();  // warm up the thread buffer and caches
+
+  const double main_thread_nanoseconds = measure_nanoseconds_per_scope();
+
+  double worker_thread_nanoseconds = 0.0;
+  std::thread worker_thread([&]() {
+    PROFILE_THREAD("WorkerThread");
+    worker_thread_nanoseconds = measure_nanoseconds_per_scope();
+  });
+  worker_thread.join();
+
+  for (uint32_t i=0; i < 1000; ++i) PROFILE_COUNTER("benchmark_counter", i);
+
+  printf("main thread:   %.2f ns per scope\n", main_thread_nanoseconds);
+  printf("worker thread: %.2f ns per scope\n", worker_thread_nanoseconds);
+
+  if (argument_count > 1) {  // optional chrome trace output path
+    if (!profiler_write_chrome_trace(arguments[1])) {
+      printf("failed to write %s\n", arguments[1]);
+      return 1;
+    }
+    printf("wrote %s\n", arguments[1]);
+  }
+
+  const bool is_within_budget = (main_thread_nanoseconds < max_nanoseconds_per_scope) && (worker_thread_nanoseconds < max_nanoseconds_per_scope);
+  printf("%s (budget is %.0f ns per scope)\n", is_within_budget ? "PASS" : "FAIL", max_nanoseconds_per_scope);
+
+  return is_within_budget ? 0 : 1;
+}
@@ -0,0 +1,74 @@
+// measures how many MatchState steps per second the rollout AI gets through on one core and on every core,
+// each thread decides actions for the players of its own copy of a default 13x11 floor with 4 players, the threads only run with more than one hardware thread
+// usage: rollout_benchmark [seed] [thread_count]
+
+#define TOM_ENGINE_MATCH_STATE_IMPLEMENTATION
+#include "match_state.h"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+constexpr uint32_t rollout_count             = 8;
+constexpr uint32_t depth_steps               = 16;
+constexpr double   measure_seconds           = 1.0;
+constexpr double   min_steps_per_second_core = 100000.0;
+
+// plays whole matches where every player picks its action by rollouts, restarting when a match ends
+static uint64_t run_rollouts(const uint64_t seed, const double seconds) {
+  using namespace std::chrono;
+  tom::Random random;
+  random.seed(seed, 1);
+  MatchState state;
+  init_default_match_state(state, seed);
+  MatchState::Action actions[MatchState::max_player_count];
+  uint64_t step_count = 0;
+
+  const auto end_time_point = steady_clock::now() + duration<double>(seconds);
+  while (steady_clock::now() < end_time_point) {
+    for (uint32_t i=0; i < state.player_count; ++i) {
+      actions[i] = state.is_player_alive(i) ? choose_match_action_by_rollouts(state, i, rollout_count, depth_steps, random, step_count) : MatchState::Action::Wait;
+    }
+    step_match(state, actions);
+    if ( (std::popcount(static_cast<uint32_t>(state.alive_player_bits)) <= 1) || (state.step_count > 2400) ) init_default_match_state(state, random.next());
+  }
+  return step_count;
+}
+
+int main(int argc, char** argv) {
+  const uint64_t seed         = (argc > 1) ? static_cast<uint64_t>(strtoull(argv[1], nullptr, 10)) : 1;
+  const uint32_t hardware_thread_count = std::thread::hardware_concurrency();
+  const uint32_t thread_count          = (argc > 2) ? static_cast<uint32_t>(strtoul(argv[2], nullptr, 10)) : std::max(hardware_thread_count, 1u);
+
+  printf("match state is %zu bytes, %u rollouts of %u steps per action, %u hardware threads\n", sizeof(MatchState), rollout_count, depth_steps, hardware_thread_count);
+
+  const double single_steps_per_second = static_cast<double>(run_rollouts(seed, measure_seconds)) / measure_seconds;
+  printf("1 thread:   %12.0f steps per second\n", single_steps_per_second);
+
+  // threads sharing one core would only measure the scheduler
+  if ( (thread_count > 1) && (hardware_thread_count > 1) ) {
+    std::vector<uint64_t> step_counts(thread_count, 0);
+    std::vector<std::thread> threads;
+    for (uint32_t i=0; i < thread_count; ++i) {
+      threads.emplace_back([&, i]() { step_counts[i] = run_rollouts(seed + i, measure_seconds); });
+    }
+    uint64_t total_step_count = 0;
+    for (uint32_t i=0; i < thread_count; ++i) {
+      threads[i].join();
+      total_step_count += step_counts[i];
+    }
+    const double total_steps_per_second = static_cast<double>(total_step_count) / measure_seconds;
+    printf("%u threads: %12.0f steps per second (%.0f per thread, %.2fx 1 thread)\n", thread_count, total_steps_per_second, total_steps_per_second / thread_count,
+           total_steps_per_second / single_steps_per_second);
+  } else {
+    printf("scaling across threads not measured with %u threads on %u hardware threads\n", thread_count, hardware_thread_count);
+  }
+
+  const bool is_within_budget = single_steps_per_second >= min_steps_per_second_core;
+  printf("%s (budget is %.0f steps per second per core)\n", is_within_budget ? "PASS" : "FAIL", min_steps_per_second_core);
+  return is_within_budget ? 0 : 1;
+}
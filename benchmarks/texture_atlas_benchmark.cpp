@@ -0,0 +1,127 @@
+// packs the game's base color textures into the atlas the device backends use and reports its memory against a 1024x1024 layer per texture
+// the padded rects are checked not to overlap and every padding texel against the texel it wraps to
+// the texture array is reported with its full mip chain and at the atlas' mip depth so the saving isn't only the missing small levels
+// usage: texture_atlas_benchmark [page_count]
+
+#define TOM_ENGINE_TEXTURE_ATLAS_IMPLEMENTATION
+#include "texture_atlas.h"
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+#define STB_IMAGE_RESIZE_IMPLEMENTATION
+#include <stb_image_resize.h>
+#define STB_RECT_PACK_IMPLEMENTATION
+#include <stb_rect_pack.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+constexpr const char* texture_file_names[] = { "quest_2_controllers.png", "block_rock.jpeg", "brick_texture_0.png", "brick_texture_1.png", "bomb.png", "fire.jpeg", "bomberman.png" };
+constexpr uint32_t    texture_count        = sizeof(texture_file_names) / sizeof(texture_file_names[0]);
+constexpr uint32_t    page_size            = 2 * (1024 + (2 * TextureAtlas::padding));  // init_graphics of the device backends
+constexpr uint32_t    layer_size           = 1024;  // of the texture array used before the atlas
+constexpr uint32_t    layer_count          = 16;
+constexpr double      bytes_per_mib        = 1024.0 * 1024.0;
+
+static bool read_binary_file(const char* file_path, std::vector<uint8_t>& bytes) {
+  FILE* file = fopen(file_path, "rb");
+  if (file == nullptr) return false;
+
+  fseek(file, 0, SEEK_END);
+  bytes.resize(static_cast<size_t>(ftell(file)));
+  fseek(file, 0, SEEK_SET);
+  const size_t read_count = fread(bytes.data(), 1, bytes.size(), file);
+  fclose(file);
+
+  return read_count == bytes.size();
+}
+
+static bool is_padding_wrapped(const TextureAtlas::Rect& rect, const std::vector<uint8_t>& mip_levels) {
+  size_t level_offset = 0;
+  for (uint32_t mip_level=0; mip_level < TextureAtlas::mip_level_count; ++mip_level) {
+    const uint32_t padded_width  = rect.get_padded_width(mip_level);
+    const uint32_t padded_height = rect.get_padded_height(mip_level);
+    const uint32_t level_width   = rect.width >> mip_level;
+    const uint32_t level_height  = rect.height >> mip_level;
+    const uint32_t level_padding = TextureAtlas::padding >> mip_level;
+    auto texel = [&](const uint32_t x, const uint32_t y) { return &mip_levels[level_offset + ((size_t(y) * padded_width) + x) * TextureAtlas::bytes_per_texel]; };
+
+    for (uint32_t y=0; y < padded_height; ++y) {
+      for (uint32_t x=0; x < padded_width; ++x) {
+        const bool is_padding = (x < level_padding) || (y < level_padding) || (x >= (level_padding + level_width)) || (y >= (level_padding + level_height));
+        if (!is_padding) continue;
+        const uint32_t wrapped_x = level_padding + ((x + level_width - level_padding) % level_width);
+        const uint32_t wrapped_y = level_padding + ((y + level_height - level_padding) % level_height);
+        if (memcmp(texel(x, y), texel(wrapped_x, wrapped_y), TextureAtlas::bytes_per_texel) != 0) return false;
+      }
+    }
+    level_offset += size_t(padded_width) * padded_height * TextureAtlas::bytes_per_texel;
+  }
+  return level_offset == mip_levels.size();
+}
+
+static bool is_overlapping(const TextureAtlas::Rect& a, const TextureAtlas::Rect& b) {
+  if (a.page_index != b.page_index) return false;
+  return (a.x - TextureAtlas::padding < b.x + b.width + TextureAtlas::padding) && (b.x - TextureAtlas::padding < a.x + a.width + TextureAtlas::padding) &&
+         (a.y - TextureAtlas::padding < b.y + b.height + TextureAtlas::padding) && (b.y - TextureAtlas::padding < a.y + a.height + TextureAtlas::padding);
+}
+
+int main(int argc, char** argv) {
+  const uint32_t page_count = (argc > 1) ? static_cast<uint32_t>(strtoul(argv[1], nullptr, 10)) : 2;
+
+  TextureAtlas atlas;
+  atlas.init(page_size, page_size, page_count);
+
+  TextureAtlas::Rect   rects[texture_count];
+  std::vector<uint8_t> file_bytes;
+  std::vector<uint8_t> mip_levels;
+  uint32_t error_count  = 0;
+  double   pack_seconds = 0.0;
+  for (uint32_t i=0; i < texture_count; ++i) {
+    const std::string file_path = std::string(BENCHMARK_ASSET_DIRECTORY) + "assets/textures/" + texture_file_names[i];
+    if (!read_binary_file(file_path.c_str(), file_bytes)) {
+      printf("failed to open: %s\n", file_path.c_str());
+      return 1;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const bool is_packed = atlas.add_texture_from_file_bytes(file_bytes.data(), file_bytes.size(), rects[i], mip_levels);
+    pack_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (!is_packed) {
+      printf("%-24s doesn't fit in %u pages\n", texture_file_names[i], page_count);
+      return 1;
+    }
+
+    const TextureAtlas::UvRect uv_rect = atlas.get_uv_rect(rects[i]);
+    printf("%-24s page %u at %4u,%4u size %4ux%-4u uv offset %.4f,%.4f scale %.4f,%.4f\n", texture_file_names[i], rects[i].page_index, rects[i].x, rects[i].y,
+           rects[i].width, rects[i].height, uv_rect.offset_u, uv_rect.offset_v, uv_rect.scale_u, uv_rect.scale_v);
+
+    if (!is_padding_wrapped(rects[i], mip_levels)) {
+      printf("  padding doesn't wrap\n");
+      ++error_count;
+    }
+    for (uint32_t j=0; j < i; ++j) {
+      if (is_overlapping(rects[i], rects[j])) {
+        printf("  overlaps %s\n", texture_file_names[j]);
+        ++error_count;
+      }
+    }
+  }
+
+  const uint32_t layer_mip_level_count  = static_cast<uint32_t>(std::floor(std::log2(layer_size))) + 1;
+  const uint64_t layer_byte_count       = calculate_texture_mip_chain_byte_count(layer_size, layer_size, layer_mip_level_count);
+  const uint64_t layer_atlas_byte_count = calculate_texture_mip_chain_byte_count(layer_size, layer_size, TextureAtlas::mip_level_count);
+  printf("\ndecoded, padded and packed %u textures in %.1f ms\n", atlas.texture_count, pack_seconds * 1000.0);
+  printf("texture array: %u layers of %ux%u with %2u mip levels allocate %.1f MiB, the textures use %.1f MiB\n", layer_count, layer_size, layer_size, layer_mip_level_count,
+         (layer_count * layer_byte_count) / bytes_per_mib, (atlas.texture_count * layer_byte_count) / bytes_per_mib);
+  printf("texture array: %u layers of %ux%u with %2u mip levels allocate %.1f MiB, the textures use %.1f MiB\n", layer_count, layer_size, layer_size, TextureAtlas::mip_level_count,
+         (layer_count * layer_atlas_byte_count) / bytes_per_mib, (atlas.texture_count * layer_atlas_byte_count) / bytes_per_mib);
+  printf("atlas:         %u pages of %ux%u with %2u mip levels allocate %.1f MiB, the textures use %.1f MiB\n", page_count, page_size, page_size, TextureAtlas::mip_level_count,
+         atlas.get_allocated_byte_count() / bytes_per_mib, atlas.used_byte_count / bytes_per_mib);
+  printf("%u errors\n", error_count);
+
+  return (error_count == 0) ? 0 : 1;
+}
@@ -16,7 +16,6 @@ layout(binding = 0) uniform sampler2DArray base_color_map_array;
 
 layout(location = 0) out vec4 out_frag_color;
 
-const uint  max_material_count = 16;
 const float minimum_roughness  = 0.025;
 const vec3  F0                 = vec3(0.04);
 const float PI                 = 3.141592653589;
@@ -27,6 +26,7 @@ struct Material {
   float metallic_factor;
   float roughness_factor;
   uint  base_color_map_index;
+  vec4  base_color_map_uv_rect;
 };
 
 layout (std140, binding = 1) uniform GlobalUniformBuffer {
@@ -37,18 +37,22 @@ layout (std140, binding = 1) uniform GlobalUniformBuffer {
   float ambient_light_factor;
 } global_uniform_buffer;
 
-layout (std140, binding = 2) uniform MaterialUniformBuffer {
-  Material materials[max_material_count];
-} material_uniform_buffer;
+layout (std430, binding = 2) readonly buffer MaterialStorageBuffer {
+  Material materials[];  // sized by init_graphics
+} material_storage_buffer;
 
 
 void main() {
-  const Material material = material_uniform_buffer.materials[material_index];
+  const Material material = material_storage_buffer.materials[material_index];
 
   // base color textures are automatically converted to linear space due to using _SRGB suffix image format (Vulkan)
   vec4 base_color;
   if (material.base_color_map_index != -1) {
-    base_color = texture(base_color_map_array, vec3(texture_coordinates, material.base_color_map_index)) * material.base_color_factor;
+    // textures share pages of an atlas so repeating is done here, gradients come from the unwrapped coordinates so fract doesn't pick the smallest mip level at the seams
+    const vec2 atlas_coordinates = (fract(texture_coordinates) * material.base_color_map_uv_rect.zw) + material.base_color_map_uv_rect.xy;
+    const vec2 atlas_dx          = dFdx(texture_coordinates) * material.base_color_map_uv_rect.zw;
+    const vec2 atlas_dy          = dFdy(texture_coordinates) * material.base_color_map_uv_rect.zw;
+    base_color = textureGrad(base_color_map_array, vec3(atlas_coordinates, material.base_color_map_index), atlas_dx, atlas_dy) * material.base_color_factor;
   } else {
     base_color = material.base_color_factor;
   }
@@ -16,6 +16,7 @@ layout(location = 7)  in vec3 instance_model_matrix_column_2;
 layout(location = 8)  in vec3 instance_model_matrix_column_3;
 layout(location = 9)  in uint material_index;
 layout(location = 10) in uint joint_index;
+layout(location = 11) in uint vertex_material_index;
 
 layout(location = 0) out vec3 out_normal;
 layout(location = 1) out vec2 out_texture_coordinates;
@@ -70,7 +71,7 @@ void main() {
   }
 
   out_texture_coordinates = texture_coordinates;
-  out_material_index      = material_index;
+  out_material_index      = (vertex_material_index != -1) ? vertex_material_index : material_index;
 
   vec4 global_position = instance_model_matrix * local_position;
   out_global_position  = global_position.xyz;
@@ -3,11 +3,15 @@
 
 bool init_audio();
 void deactivate_audio();
-uint32_t create_audio_source(const char* file_path, const float attenuation_range_min_meters, const float attenuation_range_max_meters, const float radius_meters, const float reverb_send_level, const bool is_narrow_band=false);
+uint32_t create_audio_source(const char* file_path, const float attenuation_range_min_meters, const float attenuation_range_max_meters, const float radius_meters, const float reverb_send_level, const bool is_narrow_band=false, const float priority=1.0f);
 void update_audio_source(const uint32_t id, const Vector3f position);
 void delete_audio_source(const uint32_t id);
 void play_audio_source(const uint32_t id, const bool should_loop=false);
+void fire_audio_source(const uint32_t id, const Vector3f position);  // plays the source once more at position, however many overlap
 void stop_audio_source(const uint32_t id);
+uint32_t create_audio_stream(const char* file_path, const float gain=1.0f);  // long music or ambience decoded from the file as it plays, not spatialized
+void play_audio_stream(const uint32_t id, const bool should_loop=false);     // from the start
+void stop_audio_stream(const uint32_t id);
 void play_audio_device();
 void stop_audio_device();
 
@@ -25,6 +29,8 @@ void stop_audio_device();
   #include "audio_oculus_pc.cpp"
 #elif defined(OCULUS_QUEST_2)
   #include "audio_oculus_quest_2.cpp"
+#elif defined(HEADLESS)
+  #include "audio_headless.cpp"
 #endif
 
 #endif  // TOM_ENGINE_AUDIO_IMPLEMENTATION_SINGLE
@@ -0,0 +1,69 @@
+#include <bitset>
+#include "maths.h"
+#include "platform.h"
+
+// sources are tracked so ids stay valid but nothing is decoded or mixed
+
+struct AudioSources {
+  typedef uint32_t Index;
+  static constexpr uint32_t max_count = 32;
+
+  std::bitset<max_count> is_audio_source_playing;
+  std::bitset<max_count> is_audio_source_looping;
+  Vector3f global_positions[max_count];
+
+  uint32_t current_available_id = 0;
+  uint32_t current_available_stream_id = 0;
+};
+
+AudioSources all_audio_sources;
+
+bool init_audio() {
+  return true;
+}
+
+void play_audio_device() {
+}
+
+void stop_audio_device() {
+}
+
+void deactivate_audio() {
+}
+
+uint32_t create_audio_source(const char* file_path, const float attenuation_range_min_meters, const float attenuation_range_max_meters, const float radius_meters, const float reverb_send_level, const bool is_narrow_band, const float priority) {
+  assert(all_audio_sources.current_available_id < AudioSources::max_count);
+  return all_audio_sources.current_available_id++;
+}
+
+void update_audio_source(const uint32_t id, const Vector3f position) {
+  all_audio_sources.global_positions[id] = position;
+}
+
+void delete_audio_source(const uint32_t id) {
+  all_audio_sources.is_audio_source_playing[id] = false;
+  all_audio_sources.is_audio_source_looping[id] = false;
+}
+
+void play_audio_source(const uint32_t id, const bool should_loop) {
+  all_audio_sources.is_audio_source_playing[id] = true;
+  all_audio_sources.is_audio_source_looping[id] = should_loop;
+}
+
+void fire_audio_source(const uint32_t id, const Vector3f position) {
+  assert(id < all_audio_sources.current_available_id);
+}
+
+void stop_audio_source(const uint32_t id) {
+  all_audio_sources.is_audio_source_playing[id] = false;
+}
+
+uint32_t create_audio_stream(const char* file_path, const float gain) {
+  return all_audio_sources.current_available_stream_id++;
+}
+
+void play_audio_stream(const uint32_t id, const bool should_loop) {
+}
+
+void stop_audio_stream(const uint32_t id) {
+}
@@ -0,0 +1,941 @@
+#ifndef INCLUDE_TOM_ENGINE_AUDIO_MIXER_H
+#define INCLUDE_TOM_ENGINE_AUDIO_MIXER_H
+
+#include <atomic>
+#include <bitset>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "maths.h"
+
+// the part of the device audio backends that doesn't depend on a spatializer, so it's shared by them and can run offline
+
+// every sound is kept in memory as mono ima adpcm at the device's sample rate, a quarter of 16 bit pcm and an eighth of f32, and decoded by
+// the audio callback as it plays, sources playing it only keep a cursor. a block starts from its own predictor and step index so reading can
+// start at any block and only decodes the frames before the cursor in its first block again
+struct AudioSampleBank {
+  typedef uint32_t Index;
+  static constexpr uint32_t max_count         = 32;
+  static constexpr uint32_t block_frame_count = 64;
+  static constexpr uint32_t block_byte_count  = 4 + (block_frame_count / 2);  // int16 predictor, step index, a byte of padding then a nibble per frame
+  static constexpr uint32_t file_magic        = 0x43504441;                   // "ADPC", followed by the sample rate, the frame count then the blocks
+
+  std::vector<uint8_t> blocks[max_count];  // a buffer per sound so loading one never moves another the audio thread is reading
+  uint32_t             frame_counts[max_count];
+  std::unordered_map<std::string, Index> file_path_to_index;
+  uint32_t count = 0;
+
+  // .adpcm files written by adpcm_converter are read as they are, any other sound miniaudio decodes is encoded at load
+  Index    load_from_file(const char* file_path, const uint32_t sample_rate_hz);  // Index(-1) when it can't be read or is at another sample rate
+  Index    add(const float* const samples, const uint32_t sample_count);
+  uint64_t get_byte_count() const;
+};
+
+// decodes frames of a sound from cursor on and moves it, wraps around to the start when looping, returns how many frames were decoded
+uint32_t read_audio_sample_frames(const AudioSampleBank& sample_bank, const AudioSampleBank::Index sample_index, uint32_t& cursor, const bool is_looping, float* const output, const uint32_t frame_count);
+
+void encode_ima_adpcm(const float* const samples, const uint32_t sample_count, std::vector<uint8_t>& blocks);  // in AudioSampleBank's blocks
+void decode_ima_adpcm(const uint8_t* const block, const uint32_t first_frame, const uint32_t frame_count, float* const output);  // frames of one block
+
+struct AudioCommand {
+  enum class Type : uint8_t { SetParameters, Play, Fire, Stop, Move, Delete };
+
+  struct Parameters {
+    AudioSampleBank::Index sample_index;
+    float attenuation_range_min_meters;
+    float attenuation_range_max_meters;
+    float radius_meters;      // 0.0 is a point source
+    float reverb_send_level;  // (0.0f to 1.0f)
+    bool  is_narrow_band;
+    float priority;           // scales audibility when voices compete for real voices
+  };
+
+  Type       type;
+  uint32_t   source_id;
+  bool       should_loop;  // Play
+  Vector3f   position;     // Move and Fire
+  Parameters parameters;   // SetParameters
+};
+
+// single producer single consumer ring, the thread calling the audio functions pushes and the audio callback pops everything at its start
+// so sources are only ever read and written by the audio thread
+struct AudioCommandQueue {
+  static constexpr uint32_t max_command_count = 1 << 9;  // must be a power of 2
+
+  AudioCommand commands[max_command_count];
+  alignas(64) std::atomic<uint32_t> write_index{0};  // total commands ever pushed (slot is write_index & (max_command_count - 1))
+  alignas(64) std::atomic<uint32_t> read_index{0};   // total commands ever popped
+  std::atomic<uint32_t> dropped_command_count{0};
+
+  bool push(const AudioCommand& command);  // false and dropped when full, the producer never waits on the audio thread
+  bool pop(AudioCommand& command);
+};
+
+// f32 kernels for the audio callback, vectorized with neon on the quest and sse on pc with a scalar tail
+void clear_audio_samples(float* const samples, const uint32_t sample_count);
+void accumulate_audio_samples(float* const destination, const float* const source, const uint32_t sample_count);
+void accumulate_audio_samples(float* const destination, const float* const source, const float gain, const uint32_t sample_count);
+void accumulate_mono_audio_samples_to_stereo(float* const destination, const float* const source, const float left_gain, const float right_gain, const uint32_t frame_count);
+// ramped from the start gains on the first sample toward the end gains after the last, so changing a gain every callback doesn't click
+void apply_audio_gain_ramp(float* const samples, const float start_gain, const float end_gain, const uint32_t sample_count);
+void accumulate_mono_audio_samples_to_stereo(float* const destination, const float* const source, const float start_left_gain, const float start_right_gain,
+                                             const float end_left_gain, const float end_right_gain, const uint32_t frame_count);
+void clip_audio_samples(float* const samples, const uint32_t sample_count);  // to -1.0 to 1.0
+
+// full inside the min range then falling off with the inverse square of distance like the spatializer, silent past the max range
+float calculate_audio_audibility(const float distance_meters, const AudioCommand::Parameters& parameters);
+
+// sources describe a sound and how it's heard, playing one starts a logical voice and firing one starts another every time so they overlap,
+// every callback voices are put in a tier: the most audible near ones get one of the few real voices the spatializer has, the other audible
+// ones are panned between the ears with equal power and attenuated by distance without hrtf or reverb, and the rest are virtual, they aren't
+// heard but their cursors keep moving so they come back where they should be. spatialization costs at most max_real_count voices however
+// many play and a voice changing tier crossfades over a callback, one losing its real voice keeps it until it has faded out
+struct AudioVoices {  // only used by the audio thread
+  typedef uint32_t Index;
+  static constexpr uint32_t max_source_count           = 32;
+  static constexpr uint32_t max_count                  = 256;  // when every voice plays the least audible one is stolen
+  static constexpr uint32_t max_real_count             = 16;
+  static constexpr Index    no_voice                   = Index(-1);
+  static constexpr float    real_voice_hysteresis      = 1.25f;   // a voice only changes tier for one this much more audible so voices don't flap
+  static constexpr float    min_spatialized_audibility = 0.05f;   // farther voices are panned even when a real voice is free
+  static constexpr float    min_panned_audibility      = 0.001f;  // quieter voices are virtual
+
+  enum class Tier : uint8_t { Virtual, Panned, Spatialized };
+
+  struct Voice {
+    uint32_t source_id;
+    uint32_t cursor;  // in frames of the sample, moves while virtual too
+    Vector3f position;
+    float    score;   // priority times audibility at the listener
+    Index    real_voice_index;
+    Tier     tier;
+    bool     is_looping;
+    bool     is_source_voice;  // started by Play and moved with its source, Fire voices stay where they were fired
+    bool     is_new;           // starts at the gains of its tier so its attack isn't faded in
+
+    // a callback ramps from the gains at its start to the next ones, the spatialized gain scales what a real voice is given
+    float    spatialized_gain;
+    float    next_spatialized_gain;
+    float    left_gain;
+    float    next_left_gain;
+    float    right_gain;
+    float    next_right_gain;
+
+    bool is_panned() const { return (left_gain != 0.0f) || (right_gain != 0.0f) || (next_left_gain != 0.0f) || (next_right_gain != 0.0f); }
+  };
+
+  AudioCommand::Parameters    source_parameters[max_source_count];
+  Vector3f                    source_positions[max_source_count];
+  Index                       source_voice_indices[max_source_count];
+  Voice                       voices[max_count];
+  std::bitset<max_count>      is_voice_playing;
+  Index                       real_voice_owners[max_real_count];
+  std::bitset<max_real_count> is_real_voice_reassigned;  // the spatializer resets these and sets them up for their new owner
+  uint32_t                    stolen_voice_count = 0;
+  uint32_t                    tier_counts[3]     = {};  // as of the last update
+
+  void  init();
+  void  apply_command(const AudioCommand& command);
+  Index start_voice(const uint32_t source_id, const Vector3f& position, const bool is_looping, const bool is_source_voice);
+  void  stop_voice(const Index voice_index, const bool should_cut_real_voice);  // a voice that ends by itself lets its real voice ring out
+  void  update_tiers(const Vector3f& listener_position, const Vector3f& listener_right_vector);
+  void  mix_panned_voices(const AudioSampleBank& sample_bank, float* const mix_buffer, const uint32_t frame_count);  // interleaved stereo, before real voices read
+  void  advance_virtual_voices(const AudioSampleBank& sample_bank, const uint32_t frame_count);
+};
+
+// long music or ambience read from its file a little ahead of the callback instead of decoded whole into the sample bank, the decode thread
+// fills a single producer single consumer ring of interleaved stereo frames and the callback only copies out of it, so a stream's memory is
+// its ring however long the track is and the callback never decodes. vorbis is decoded by stb_vorbis through ma_decoder which resamples
+struct AudioStream {
+  static constexpr uint32_t channel_count         = 2;
+  static constexpr uint32_t ring_period_count     = 8;  // the ring holds at least this many callback periods
+  static constexpr uint32_t prefetch_period_count = 2;  // decoded before a start is heard so the first callbacks don't underrun
+
+  struct ma_decoder* decoder         = nullptr;  // only used by the decode thread once opened
+  bool               is_decoder_open = false;
+  std::string        file_path;
+  uint32_t           sample_rate_hz;
+  std::vector<float> ring;
+  uint32_t           frame_capacity;  // a power of two
+  uint32_t           prefetch_frame_count;
+  float              gain;
+
+  alignas(64) std::atomic<uint64_t> write_frame{0};  // total frames ever decoded into the ring (frame is write_frame & (frame_capacity - 1))
+  alignas(64) std::atomic<uint64_t> read_frame{0};   // total frames ever mixed out of it
+  std::atomic<uint32_t> play_request_count{0};          // bumped by play, the decode thread starts the track over when it changes
+  std::atomic<uint32_t> started_play_request_count{0};  // the last one the decode thread started, after storing start_frame and end_frame
+  std::atomic<uint64_t> start_frame{0};                 // where the started track begins in the ring, the callback skips what's before it
+  std::atomic<uint64_t> end_frame{UINT64_MAX};          // where a track that doesn't loop ends in the ring
+  std::atomic<bool>     is_playing{false};
+  std::atomic<bool>     is_looping{false};
+  std::atomic<uint32_t> underrun_count{0};              // callbacks that found fewer frames than they needed
+
+  uint32_t mixed_play_request_count = 0;  // only used by the audio callback
+  bool     is_prefetching           = false;
+
+  bool     open(const char* file_path, const uint32_t sample_rate_hz, const uint32_t period_frame_count, const float gain);  // allocates the ring up front
+  void     close();                         // once the decode thread stopped
+  void     play(const bool should_loop);    // from the start, from any thread
+  void     stop();
+  uint32_t decode();                        // by the decode thread, tops the ring up and returns the frames decoded
+  void     mix(float* const mix_buffer, const uint32_t frame_count);  // by the audio callback, interleaved stereo
+};
+
+struct AudioStreams {
+  static constexpr uint32_t max_count = 4;
+
+  AudioStream           streams[max_count];
+  std::atomic<uint32_t> count{0};  // bumped once a stream is opened so the other threads only see whole ones
+  std::thread           decode_thread;
+  std::atomic<bool>     is_decoding{false};
+  uint32_t              sample_rate_hz;
+  uint32_t              period_frame_count;
+
+  void     start_decode_thread(const uint32_t sample_rate_hz, const uint32_t period_frame_count);  // wakes twice a callback period
+  void     stop_decode_thread();
+  uint32_t open(const char* file_path, const float gain);  // max_count when it can't be opened
+  void     mix(float* const mix_buffer, const uint32_t frame_count);
+};
+
+#endif  // INCLUDE_TOM_ENGINE_AUDIO_MIXER_H
+
+//////////////////////////////////////////////////
+
+#ifdef  TOM_ENGINE_AUDIO_MIXER_IMPLEMENTATION
+#ifndef TOM_ENGINE_AUDIO_MIXER_IMPLEMENTATION_SINGLE
+#define TOM_ENGINE_AUDIO_MIXER_IMPLEMENTATION_SINGLE
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <miniaudio.h>
+#if defined(__ARM_NEON)
+  #include <arm_neon.h>
+#elif defined(__SSE__) || defined(_M_X64)
+  #include <xmmintrin.h>
+#endif
+
+static constexpr int16_t ima_adpcm_step_sizes[89] = {
+  7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230,
+  253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
+  3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+static constexpr int8_t ima_adpcm_step_index_changes[8] = { -1, -1, -1, -1, 2, 4, 6, 8 };  // by the nibble without its sign bit
+
+// the difference and next step index of every step index and nibble, so decoding a nibble is two loads and a clamp
+struct ImaAdpcmTable {
+  int32_t differences[89][16];
+  uint8_t next_step_indices[89][16];
+};
+
+static constexpr ImaAdpcmTable make_ima_adpcm_table() {
+  ImaAdpcmTable table{};
+  for (int32_t step_index=0; step_index < 89; ++step_index) {
+    for (int32_t nibble=0; nibble < 16; ++nibble) {
+      const int32_t difference = ((2 * (nibble & 7) + 1) * ima_adpcm_step_sizes[step_index]) >> 3;
+      table.differences[step_index][nibble]       = ((nibble & 8) != 0) ? -difference : difference;
+      table.next_step_indices[step_index][nibble] = static_cast<uint8_t>(std::min(std::max(step_index + ima_adpcm_step_index_changes[nibble & 7], 0), 88));
+    }
+  }
+  return table;
+}
+static constexpr ImaAdpcmTable ima_adpcm_table = make_ima_adpcm_table();
+
+static inline void decode_ima_adpcm_nibble(const uint32_t nibble, int32_t& predictor, uint32_t& step_index) {
+  predictor  = std::min(std::max(predictor + ima_adpcm_table.differences[step_index][nibble], -32768), 32767);
+  step_index = ima_adpcm_table.next_step_indices[step_index][nibble];
+}
+
+// encodes a block of 16 bit samples from a step index and returns its squared error, block can be nullptr to only measure it
+static uint64_t encode_ima_adpcm_block(const int32_t* const samples, const uint32_t first_step_index, uint8_t* const block) {
+  int32_t  predictor     = samples[0];
+  uint32_t step_index    = first_step_index;
+  uint64_t squared_error = 0;
+  if (block != nullptr) {
+    block[0] = static_cast<uint8_t>(predictor & 0xff);
+    block[1] = static_cast<uint8_t>((predictor >> 8) & 0xff);
+    block[2] = static_cast<uint8_t>(step_index);
+    block[3] = 0;
+    memset(block + 4, 0, AudioSampleBank::block_frame_count / 2);
+  }
+
+  for (uint32_t i=0; i < AudioSampleBank::block_frame_count; ++i) {
+    // the nibble whose step multiple is nearest the difference, the decoder then moves the predictor the same way
+    const int32_t  difference = samples[i] - predictor;
+    const int32_t  magnitude  = std::min(((std::abs(difference) * 4) / ima_adpcm_step_sizes[step_index]), 7);
+    const uint32_t nibble     = static_cast<uint32_t>(magnitude) | ((difference < 0) ? 8u : 0u);
+    decode_ima_adpcm_nibble(nibble, predictor, step_index);
+    squared_error += static_cast<uint64_t>(int64_t(samples[i] - predictor) * (samples[i] - predictor));
+    if (block != nullptr) block[4 + (i / 2)] |= static_cast<uint8_t>(nibble << ((i & 1) * 4));
+  }
+  return squared_error;
+}
+
+void encode_ima_adpcm(const float* const samples, const uint32_t sample_count, std::vector<uint8_t>& blocks) {
+  const uint32_t block_count = (sample_count + AudioSampleBank::block_frame_count - 1) / AudioSampleBank::block_frame_count;
+  blocks.resize(size_t(block_count) * AudioSampleBank::block_byte_count);
+
+  int32_t block_samples[AudioSampleBank::block_frame_count];
+  for (uint32_t block_index=0; block_index < block_count; ++block_index) {
+    const uint32_t first = block_index * AudioSampleBank::block_frame_count;
+    for (uint32_t i=0; i < AudioSampleBank::block_frame_count; ++i) {
+      block_samples[i] = ((first + i) < sample_count) ? static_cast<int32_t>(std::lrint(std::min(std::max(samples[first + i], -1.0f), 1.0f) * 32767.0f)) : 0;
+    }
+
+    // every block stores its own first step index so the one with the least error is searched for, it adapts too slowly to transients otherwise
+    uint32_t best_step_index    = 0;
+    uint64_t best_squared_error = UINT64_MAX;
+    for (uint32_t step_index=0; step_index < 89; ++step_index) {
+      const uint64_t squared_error = encode_ima_adpcm_block(block_samples, step_index, nullptr);
+      if (squared_error < best_squared_error) {
+        best_step_index    = step_index;
+        best_squared_error = squared_error;
+      }
+    }
+    encode_ima_adpcm_block(block_samples, best_step_index, &blocks[size_t(block_index) * AudioSampleBank::block_byte_count]);
+  }
+}
+
+void decode_ima_adpcm(const uint8_t* const block, const uint32_t first_frame, const uint32_t frame_count, float* const output) {
+  int32_t  predictor  = static_cast<int16_t>(block[0] | (block[1] << 8));
+  uint32_t step_index = block[2];
+  const uint8_t* nibbles    = block + 4;
+  const uint32_t end_frame  = first_frame + frame_count;
+  uint32_t       i          = 0;
+  for (; (i + 1) < first_frame; i += 2, ++nibbles) {  // a byte at a time up to the cursor
+    decode_ima_adpcm_nibble(*nibbles & 0xf, predictor, step_index);
+    decode_ima_adpcm_nibble(*nibbles >> 4, predictor, step_index);
+  }
+  if (i < first_frame) {  // the cursor is on a high nibble
+    decode_ima_adpcm_nibble(*nibbles & 0xf, predictor, step_index);
+    i += 1;
+  }
+
+  float* out = output;
+  if ( ((i & 1) != 0) && (i < end_frame) ) {
+    decode_ima_adpcm_nibble(*nibbles++ >> 4, predictor, step_index);
+    *out++ = static_cast<float>(predictor) * (1.0f / 32768.0f);
+    i += 1;
+  }
+  for (; (i + 1) < end_frame; i += 2, ++nibbles) {
+    decode_ima_adpcm_nibble(*nibbles & 0xf, predictor, step_index);
+    *out++ = static_cast<float>(predictor) * (1.0f / 32768.0f);
+    decode_ima_adpcm_nibble(*nibbles >> 4, predictor, step_index);
+    *out++ = static_cast<float>(predictor) * (1.0f / 32768.0f);
+  }
+  if (i < end_frame) {
+    decode_ima_adpcm_nibble(*nibbles & 0xf, predictor, step_index);
+    *out = static_cast<float>(predictor) * (1.0f / 32768.0f);
+  }
+}
+
+AudioSampleBank::Index AudioSampleBank::load_from_file(const char* file_path, const uint32_t sample_rate_hz) {
+  const auto path_it = file_path_to_index.find(file_path);
+  if (path_it != file_path_to_index.end()) return path_it->second;
+
+  assert(count < max_count);
+  const size_t path_length = strlen(file_path);
+  if ( (path_length > 6) && (strcmp(file_path + path_length - 6, ".adpcm") == 0) ) {
+    FILE* file = fopen(file_path, "rb");
+    if (file == nullptr) return Index(-1);
+
+    uint32_t header[3];  // magic, sample rate and frame count
+    const bool is_header_read = fread(header, sizeof(header), 1, file) == 1;
+    if ( !is_header_read || (header[0] != file_magic) || (header[1] != sample_rate_hz) ) {
+      fclose(file);
+      return Index(-1);
+    }
+
+    const Index index = count;
+    frame_counts[index] = header[2];
+    blocks[index].resize(size_t((header[2] + block_frame_count - 1) / block_frame_count) * block_byte_count);
+    const bool is_read = fread(blocks[index].data(), 1, blocks[index].size(), file) == blocks[index].size();
+    fclose(file);
+    if (!is_read) return Index(-1);
+
+    count += 1;
+    file_path_to_index[file_path] = index;
+    return index;
+  }
+
+  ma_decoder_config config = ma_decoder_config_init(ma_format_f32, 1, sample_rate_hz);
+  ma_uint64 frame_count;
+  void*     decoded_frames;
+  if (ma_decode_file(file_path, &config, &frame_count, &decoded_frames) != MA_SUCCESS) return Index(-1);
+
+  const Index index = add(static_cast<float*>(decoded_frames), static_cast<uint32_t>(frame_count));
+  ma_free(decoded_frames, nullptr);
+  file_path_to_index[file_path] = index;
+  return index;
+}
+
+AudioSampleBank::Index AudioSampleBank::add(const float* const samples, const uint32_t sample_count) {
+  assert(count < max_count);
+  const Index index = count;
+  encode_ima_adpcm(samples, sample_count, blocks[index]);
+  frame_counts[index] = sample_count;
+  count += 1;
+  return index;
+}
+
+uint64_t AudioSampleBank::get_byte_count() const {
+  uint64_t byte_count = 0;
+  for (uint32_t i=0; i < count; ++i) byte_count += blocks[i].size();
+  return byte_count;
+}
+
+uint32_t read_audio_sample_frames(const AudioSampleBank& sample_bank, const AudioSampleBank::Index sample_index, uint32_t& cursor, const bool is_looping, float* const output, const uint32_t frame_count) {
+  const uint32_t sample_frame_count = sample_bank.frame_counts[sample_index];
+  const uint8_t* blocks             = sample_bank.blocks[sample_index].data();
+  uint32_t       frames_read        = 0;
+  while (frames_read < frame_count) {
+    if (cursor >= sample_frame_count) {
+      if (!is_looping || (sample_frame_count == 0)) break;
+      cursor = 0;
+    }
+
+    const uint32_t block_index     = cursor / AudioSampleBank::block_frame_count;
+    const uint32_t first_frame     = cursor % AudioSampleBank::block_frame_count;
+    const uint32_t frames_to_decode = std::min({ frame_count - frames_read, AudioSampleBank::block_frame_count - first_frame, sample_frame_count - cursor });
+    decode_ima_adpcm(blocks + (size_t(block_index) * AudioSampleBank::block_byte_count), first_frame, frames_to_decode, output + frames_read);
+    cursor      += frames_to_decode;
+    frames_read += frames_to_decode;
+  }
+  return frames_read;
+}
+
+bool AudioCommandQueue::push(const AudioCommand& command) {
+  const uint32_t index = write_index.load(std::memory_order_relaxed);
+  if ((index - read_index.load(std::memory_order_acquire)) == max_command_count) {
+    dropped_command_count.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  commands[index & (max_command_count - 1)] = command;
+  write_index.store(index + 1, std::memory_order_release);
+  return true;
+}
+
+bool AudioCommandQueue::pop(AudioCommand& command) {
+  const uint32_t index = read_index.load(std::memory_order_relaxed);
+  if (index == write_index.load(std::memory_order_acquire)) return false;
+
+  command = commands[index & (max_command_count - 1)];
+  read_index.store(index + 1, std::memory_order_release);
+  return true;
+}
+
+void clear_audio_samples(float* const samples, const uint32_t sample_count) {
+  uint32_t i = 0;
+#if defined(__ARM_NEON)
+  const float32x4_t zero = vdupq_n_f32(0.0f);
+  for (; (i + 4) <= sample_count; i += 4) vst1q_f32(samples + i, zero);
+#elif defined(__SSE__) || defined(_M_X64)
+  const __m128 zero = _mm_setzero_ps();
+  for (; (i + 4) <= sample_count; i += 4) _mm_storeu_ps(samples + i, zero);
+#endif
+  for (; i < sample_count; ++i) samples[i] = 0.0f;
+}
+
+void accumulate_audio_samples(float* const destination, const float* const source, const uint32_t sample_count) {
+  uint32_t i = 0;
+#if defined(__ARM_NEON)
+  for (; (i + 4) <= sample_count; i += 4) vst1q_f32(destination + i, vaddq_f32(vld1q_f32(destination + i), vld1q_f32(source + i)));
+#elif defined(__SSE__) || defined(_M_X64)
+  for (; (i + 4) <= sample_count; i += 4) _mm_storeu_ps(destination + i, _mm_add_ps(_mm_loadu_ps(destination + i), _mm_loadu_ps(source + i)));
+#endif
+  for (; i < sample_count; ++i) destination[i] += source[i];
+}
+
+void accumulate_audio_samples(float* const destination, const float* const source, const float gain, const uint32_t sample_count) {
+  uint32_t i = 0;
+#if defined(__ARM_NEON)
+  const float32x4_t gains = vdupq_n_f32(gain);
+  for (; (i + 4) <= sample_count; i += 4) vst1q_f32(destination + i, vmlaq_f32(vld1q_f32(destination + i), vld1q_f32(source + i), gains));
+#elif defined(__SSE__) || defined(_M_X64)
+  const __m128 gains = _mm_set1_ps(gain);
+  for (; (i + 4) <= sample_count; i += 4) _mm_storeu_ps(destination + i, _mm_add_ps(_mm_loadu_ps(destination + i), _mm_mul_ps(_mm_loadu_ps(source + i), gains)));
+#endif
+  for (; i < sample_count; ++i) destination[i] += source[i] * gain;
+}
+
+void accumulate_mono_audio_samples_to_stereo(float* const destination, const float* const source, const float left_gain, const float right_gain, const uint32_t frame_count) {
+  uint32_t i = 0;
+#if defined(__ARM_NEON)
+  const float32x4_t left_gains  = vdupq_n_f32(left_gain);
+  const float32x4_t right_gains = vdupq_n_f32(right_gain);
+  for (; (i + 4) <= frame_count; i += 4) {
+    const float32x4_t mono   = vld1q_f32(source + i);
+    float32x4x2_t     stereo = vld2q_f32(destination + (2 * i));  // deinterleaved into left and right
+    stereo.val[0] = vmlaq_f32(stereo.val[0], mono, left_gains);
+    stereo.val[1] = vmlaq_f32(stereo.val[1], mono, right_gains);
+    vst2q_f32(destination + (2 * i), stereo);
+  }
+#elif defined(__SSE__) || defined(_M_X64)
+  const __m128 left_gains  = _mm_set1_ps(left_gain);
+  const __m128 right_gains = _mm_set1_ps(right_gain);
+  for (; (i + 4) <= frame_count; i += 4) {
+    const __m128 mono  = _mm_loadu_ps(source + i);
+    const __m128 left  = _mm_mul_ps(mono, left_gains);
+    const __m128 right = _mm_mul_ps(mono, right_gains);
+    _mm_storeu_ps(destination + (2 * i),     _mm_add_ps(_mm_loadu_ps(destination + (2 * i)),     _mm_unpacklo_ps(left, right)));
+    _mm_storeu_ps(destination + (2 * i) + 4, _mm_add_ps(_mm_loadu_ps(destination + (2 * i) + 4), _mm_unpackhi_ps(left, right)));
+  }
+#endif
+  for (; i < frame_count; ++i) {
+    destination[(2 * i)]     += source[i] * left_gain;
+    destination[(2 * i) + 1] += source[i] * right_gain;
+  }
+}
+
+void apply_audio_gain_ramp(float* const samples, const float start_gain, const float end_gain, const uint32_t sample_count) {
+  if (sample_count == 0) return;
+  const float step = (end_gain - start_gain) / static_cast<float>(sample_count);
+  uint32_t i = 0;
+#if defined(__ARM_NEON)
+  const float       first_gains[4] = { start_gain, start_gain + step, start_gain + (2.0f * step), start_gain + (3.0f * step) };
+  float32x4_t       gains          = vld1q_f32(first_gains);
+  const float32x4_t steps          = vdupq_n_f32(4.0f * step);
+  for (; (i + 4) <= sample_count; i += 4) {
+    vst1q_f32(samples + i, vmulq_f32(vld1q_f32(samples + i), gains));
+    gains = vaddq_f32(gains, steps);
+  }
+#elif defined(__SSE__) || defined(_M_X64)
+  __m128       gains = _mm_setr_ps(start_gain, start_gain + step, start_gain + (2.0f * step), start_gain + (3.0f * step));
+  const __m128 steps = _mm_set1_ps(4.0f * step);
+  for (; (i + 4) <= sample_count; i += 4) {
+    _mm_storeu_ps(samples + i, _mm_mul_ps(_mm_loadu_ps(samples + i), gains));
+    gains = _mm_add_ps(gains, steps);
+  }
+#endif
+  for (; i < sample_count; ++i) samples[i] *= start_gain + (step * static_cast<float>(i));
+}
+
+void accumulate_mono_audio_samples_to_stereo(float* const destination, const float* const source, const float start_left_gain, const float start_right_gain,
+                                             const float end_left_gain, const float end_right_gain, const uint32_t frame_count) {
+  if (frame_count == 0) return;
+  const float left_step  = (end_left_gain - start_left_gain) / static_cast<float>(frame_count);
+  const float right_step = (end_right_gain - start_right_gain) / static_cast<float>(frame_count);
+  uint32_t i = 0;
+#if defined(__ARM_NEON)
+  const float       first_left_gains[4]  = { start_left_gain, start_left_gain + left_step, start_left_gain + (2.0f * left_step), start_left_gain + (3.0f * left_step) };
+  const float       first_right_gains[4] = { start_right_gain, start_right_gain + right_step, start_right_gain + (2.0f * right_step), start_right_gain + (3.0f * right_step) };
+  float32x4_t       left_gains           = vld1q_f32(first_left_gains);
+  float32x4_t       right_gains          = vld1q_f32(first_right_gains);
+  const float32x4_t left_steps           = vdupq_n_f32(4.0f * left_step);
+  const float32x4_t right_steps          = vdupq_n_f32(4.0f * right_step);
+  for (; (i + 4) <= frame_count; i += 4) {
+    const float32x4_t mono   = vld1q_f32(source + i);
+    float32x4x2_t     stereo = vld2q_f32(destination + (2 * i));
+    stereo.val[0] = vmlaq_f32(stereo.val[0], mono, left_gains);
+    stereo.val[1] = vmlaq_f32(stereo.val[1], mono, right_gains);
+    vst2q_f32(destination + (2 * i), stereo);
+    left_gains  = vaddq_f32(left_gains, left_steps);
+    right_gains = vaddq_f32(right_gains, right_steps);
+  }
+#elif defined(__SSE__) || defined(_M_X64)
+  __m128       left_gains  = _mm_setr_ps(start_left_gain, start_left_gain + left_step, start_left_gain + (2.0f * left_step), start_left_gain + (3.0f * left_step));
+  __m128       right_gains = _mm_setr_ps(start_right_gain, start_right_gain + right_step, start_right_gain + (2.0f * right_step), start_right_gain + (3.0f * right_step));
+  const __m128 left_steps  = _mm_set1_ps(4.0f * left_step);
+  const __m128 right_steps = _mm_set1_ps(4.0f * right_step);
+  for (; (i + 4) <= frame_count; i += 4) {
+    const __m128 mono  = _mm_loadu_ps(source + i);
+    const __m128 left  = _mm_mul_ps(mono, left_gains);
+    const __m128 right = _mm_mul_ps(mono, right_gains);
+    _mm_storeu_ps(destination + (2 * i),     _mm_add_ps(_mm_loadu_ps(destination + (2 * i)),     _mm_unpacklo_ps(left, right)));
+    _mm_storeu_ps(destination + (2 * i) + 4, _mm_add_ps(_mm_loadu_ps(destination + (2 * i) + 4), _mm_unpackhi_ps(left, right)));
+    left_gains  = _mm_add_ps(left_gains, left_steps);
+    right_gains = _mm_add_ps(right_gains, right_steps);
+  }
+#endif
+  for (; i < frame_count; ++i) {
+    destination[(2 * i)]     += source[i] * (start_left_gain + (left_step * static_cast<float>(i)));
+    destination[(2 * i) + 1] += source[i] * (start_right_gain + (right_step * static_cast<float>(i)));
+  }
+}
+
+void clip_audio_samples(float* const samples, const uint32_t sample_count) {
+  uint32_t i = 0;
+#if defined(__ARM_NEON)
+  const float32x4_t minimum = vdupq_n_f32(-1.0f);
+  const float32x4_t maximum = vdupq_n_f32(1.0f);
+  for (; (i + 4) <= sample_count; i += 4) vst1q_f32(samples + i, vminq_f32(vmaxq_f32(vld1q_f32(samples + i), minimum), maximum));
+#elif defined(__SSE__) || defined(_M_X64)
+  const __m128 minimum = _mm_set1_ps(-1.0f);
+  const __m128 maximum = _mm_set1_ps(1.0f);
+  for (; (i + 4) <= sample_count; i += 4) _mm_storeu_ps(samples + i, _mm_min_ps(_mm_max_ps(_mm_loadu_ps(samples + i), minimum), maximum));
+#endif
+  for (; i < sample_count; ++i) samples[i] = std::min(std::max(samples[i], -1.0f), 1.0f);
+}
+
+float calculate_audio_audibility(const float distance_meters, const AudioCommand::Parameters& parameters) {
+  if (distance_meters >= parameters.attenuation_range_max_meters) return 0.0f;
+
+  const float reference_distance = std::max(parameters.attenuation_range_min_meters, 0.1f);
+  const float clamped_distance   = std::max(distance_meters, reference_distance);
+  return (reference_distance * reference_distance) / (clamped_distance * clamped_distance);
+}
+
+void AudioVoices::init() {
+  for (uint32_t i=0; i < max_source_count; ++i) source_voice_indices[i] = no_voice;
+  for (uint32_t i=0; i < max_real_count; ++i) real_voice_owners[i] = no_voice;
+  is_voice_playing.reset();
+  is_real_voice_reassigned.reset();
+  stolen_voice_count = 0;
+  for (uint32_t& tier_count : tier_counts) tier_count = 0;
+}
+
+void AudioVoices::apply_command(const AudioCommand& command) {
+  const uint32_t id = command.source_id;
+  assert(id < max_source_count);
+
+  const Index source_voice_index      = source_voice_indices[id];
+  const bool  is_source_voice_playing = (source_voice_index != no_voice) && is_voice_playing[source_voice_index] && voices[source_voice_index].is_source_voice && (voices[source_voice_index].source_id == id);
+  switch (command.type) {
+    case AudioCommand::Type::SetParameters: {
+      source_parameters[id] = command.parameters;
+      break;
+    }
+    case AudioCommand::Type::Play: {
+      if (is_source_voice_playing) stop_voice(source_voice_index, true);
+      source_voice_indices[id] = start_voice(id, source_positions[id], command.should_loop, true);
+      break;
+    }
+    case AudioCommand::Type::Fire: {
+      start_voice(id, command.position, false, false);
+      break;
+    }
+    case AudioCommand::Type::Stop:
+    case AudioCommand::Type::Delete: {
+      if (is_source_voice_playing) stop_voice(source_voice_index, true);
+      source_voice_indices[id] = no_voice;
+      break;
+    }
+    case AudioCommand::Type::Move: {
+      source_positions[id] = command.position;
+      if (is_source_voice_playing) voices[source_voice_index].position = command.position;
+      break;
+    }
+  }
+}
+
+AudioVoices::Index AudioVoices::start_voice(const uint32_t source_id, const Vector3f& position, const bool is_looping, const bool is_source_voice) {
+  Index voice_index = 0;
+  while ( (voice_index < max_count) && is_voice_playing[voice_index] ) ++voice_index;
+
+  if (voice_index == max_count) {  // steals the least audible as of the last update, the new voice hasn't been scored yet
+    voice_index = 0;
+    for (Index i=1; i < max_count; ++i) {
+      if (voices[i].score < voices[voice_index].score) voice_index = i;
+    }
+    stop_voice(voice_index, true);
+    ++stolen_voice_count;
+  }
+
+  voices[voice_index]           = { source_id, 0, position, 0.0f, no_voice, Tier::Virtual, is_looping, is_source_voice, true, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+  is_voice_playing[voice_index] = true;
+  return voice_index;
+}
+
+void AudioVoices::stop_voice(const Index voice_index, const bool should_cut_real_voice) {
+  Voice& voice = voices[voice_index];
+  if (voice.real_voice_index != no_voice) {
+    real_voice_owners[voice.real_voice_index] = no_voice;
+    if (should_cut_real_voice) is_real_voice_reassigned[voice.real_voice_index] = true;
+    voice.real_voice_index = no_voice;
+  }
+  is_voice_playing[voice_index] = false;
+}
+
+void AudioVoices::update_tiers(const Vector3f& listener_position, const Vector3f& listener_right_vector) {
+  Index    candidates[max_count];
+  float    ranks[max_count];
+  float    audibilities[max_count];
+  float    pans[max_count];  // -1.0 is left
+  uint32_t candidate_count = 0;
+  for (Index i=0; i < max_count; ++i) {
+    if (!is_voice_playing[i]) continue;
+
+    Voice& voice = voices[i];
+    voice.spatialized_gain = voice.next_spatialized_gain;
+    voice.left_gain        = voice.next_left_gain;
+    voice.right_gain       = voice.next_right_gain;
+
+    const AudioCommand::Parameters& parameters = source_parameters[voice.source_id];
+    const float dx       = voice.position.x - listener_position.x;
+    const float dy       = voice.position.y - listener_position.y;
+    const float dz       = voice.position.z - listener_position.z;
+    const float distance = std::sqrt((dx * dx) + (dy * dy) + (dz * dz));
+    audibilities[i] = calculate_audio_audibility(distance, parameters);
+    pans[i]         = (distance > 0.0f) ? std::min(std::max(((dx * listener_right_vector.x) + (dy * listener_right_vector.y) + (dz * listener_right_vector.z)) / distance, -1.0f), 1.0f) : 0.0f;
+    voice.score     = parameters.priority * audibilities[i];
+
+    const float hysteresis = (voice.tier == Tier::Spatialized) ? real_voice_hysteresis : 1.0f;
+    if ((audibilities[i] * hysteresis) < min_spatialized_audibility) continue;
+
+    ranks[i] = voice.score * hysteresis;
+    candidates[candidate_count++] = i;
+  }
+
+  if (candidate_count > max_real_count) {
+    std::nth_element(candidates, candidates + max_real_count, candidates + candidate_count, [&ranks](const Index a, const Index b) { return ranks[a] > ranks[b]; });
+    candidate_count = max_real_count;
+  }
+
+  std::bitset<max_count> is_chosen;
+  for (uint32_t i=0; i < candidate_count; ++i) is_chosen[candidates[i]] = true;
+
+  // given up once its voice has faded out of it, then it rings out unless another voice needs it
+  for (Index real_voice_index=0; real_voice_index < max_real_count; ++real_voice_index) {
+    const Index owner = real_voice_owners[real_voice_index];
+    if ( (owner != no_voice) && !is_chosen[owner] && (voices[owner].spatialized_gain == 0.0f) ) {
+      voices[owner].real_voice_index      = no_voice;
+      real_voice_owners[real_voice_index] = no_voice;
+    }
+  }
+
+  // a voice that doesn't get one because the others are still fading out is panned until the next callback
+  Index free_real_voice_index = 0;
+  for (uint32_t i=0; i < candidate_count; ++i) {
+    Voice& voice = voices[candidates[i]];
+    if (voice.real_voice_index != no_voice) continue;
+
+    while ( (free_real_voice_index < max_real_count) && (real_voice_owners[free_real_voice_index] != no_voice) ) ++free_real_voice_index;
+    if (free_real_voice_index == max_real_count) break;
+    voice.real_voice_index                          = free_real_voice_index;
+    real_voice_owners[free_real_voice_index]        = candidates[i];
+    is_real_voice_reassigned[free_real_voice_index] = true;
+  }
+
+  for (uint32_t& tier_count : tier_counts) tier_count = 0;
+  for (Index i=0; i < max_count; ++i) {
+    if (!is_voice_playing[i]) continue;
+
+    Voice& voice = voices[i];
+    const float hysteresis = (voice.tier != Tier::Virtual) ? real_voice_hysteresis : 1.0f;
+    if ( is_chosen[i] && (voice.real_voice_index != no_voice) ) {
+      voice.tier = Tier::Spatialized;
+    } else if ((audibilities[i] * hysteresis) >= min_panned_audibility) {
+      voice.tier = Tier::Panned;
+    } else {
+      voice.tier = Tier::Virtual;
+    }
+    ++tier_counts[static_cast<uint32_t>(voice.tier)];
+
+    const float panned_gain = (voice.tier == Tier::Panned) ? audibilities[i] : 0.0f;
+    const float pan_angle   = (pans[i] + 1.0f) * 0.78539816f;  // a quarter turn from left to right keeps the power constant
+    voice.next_spatialized_gain = (voice.tier == Tier::Spatialized) ? 1.0f : 0.0f;
+    voice.next_left_gain        = panned_gain * std::cos(pan_angle);
+    voice.next_right_gain       = panned_gain * std::sin(pan_angle);
+    if (voice.is_new) {
+      voice.spatialized_gain = voice.next_spatialized_gain;
+      voice.left_gain        = voice.next_left_gain;
+      voice.right_gain       = voice.next_right_gain;
+      voice.is_new           = false;
+    }
+  }
+}
+
+void AudioVoices::mix_panned_voices(const AudioSampleBank& sample_bank, float* const mix_buffer, const uint32_t frame_count) {
+  constexpr uint32_t chunk_frame_count = 256;
+  float samples[chunk_frame_count];
+  const float frame_scale = 1.0f / static_cast<float>(frame_count);
+  for (Index i=0; i < max_count; ++i) {
+    if (!is_voice_playing[i] || !voices[i].is_panned()) continue;
+
+    Voice& voice = voices[i];
+    const AudioSampleBank::Index sample_index = source_parameters[voice.source_id].sample_index;
+    uint32_t cursor            = voice.cursor;  // one crossfading with its real voice is read again by the spatializer, which moves the cursor
+    uint32_t total_frames_read = 0;
+    while (total_frames_read < frame_count) {
+      const uint32_t frames_to_read = std::min(frame_count - total_frames_read, chunk_frame_count);
+      const uint32_t frames_read    = read_audio_sample_frames(sample_bank, sample_index, cursor, voice.is_looping, samples, frames_to_read);
+      const float    start          = static_cast<float>(total_frames_read) * frame_scale;
+      const float    end            = static_cast<float>(total_frames_read + frames_read) * frame_scale;
+      accumulate_mono_audio_samples_to_stereo(mix_buffer + (2 * total_frames_read), samples,
+                                              voice.left_gain + ((voice.next_left_gain - voice.left_gain) * start), voice.right_gain + ((voice.next_right_gain - voice.right_gain) * start),
+                                              voice.left_gain + ((voice.next_left_gain - voice.left_gain) * end), voice.right_gain + ((voice.next_right_gain - voice.right_gain) * end), frames_read);
+      total_frames_read += frames_read;
+      if (frames_read < frames_to_read) break;
+    }
+
+    if (voice.real_voice_index == no_voice) {
+      voice.cursor = cursor;
+      if (total_frames_read < frame_count) stop_voice(i, false);
+    }
+  }
+}
+
+void AudioVoices::advance_virtual_voices(const AudioSampleBank& sample_bank, const uint32_t frame_count) {
+  for (Index i=0; i < max_count; ++i) {
+    if (!is_voice_playing[i] || (voices[i].real_voice_index != no_voice) || voices[i].is_panned()) continue;
+
+    Voice& voice = voices[i];
+    const uint32_t sample_frame_count = sample_bank.frame_counts[source_parameters[voice.source_id].sample_index];
+    voice.cursor += frame_count;
+    if (voice.cursor >= sample_frame_count) {
+      if (voice.is_looping && (sample_frame_count > 0)) {
+        voice.cursor %= sample_frame_count;
+      } else {
+        stop_voice(i, false);
+      }
+    }
+  }
+}
+
+bool AudioStream::open(const char* file_path, const uint32_t sample_rate_hz, const uint32_t period_frame_count, const float gain) {
+  ma_decoder_config config = ma_decoder_config_init(ma_format_f32, channel_count, sample_rate_hz);
+  decoder = new ma_decoder;
+  if (ma_decoder_init_file(file_path, &config, decoder) != MA_SUCCESS) {
+    delete decoder;
+    decoder = nullptr;
+    return false;
+  }
+  is_decoder_open      = true;
+  this->file_path      = file_path;
+  this->sample_rate_hz = sample_rate_hz;
+
+  frame_capacity = 1;
+  while (frame_capacity < (ring_period_count * period_frame_count)) frame_capacity <<= 1;
+  ring.assign(size_t(frame_capacity) * channel_count, 0.0f);
+  prefetch_frame_count = prefetch_period_count * period_frame_count;
+  this->gain           = gain;
+  return true;
+}
+
+void AudioStream::close() {
+  if (decoder == nullptr) return;
+  if (is_decoder_open) ma_decoder_uninit(decoder);
+  delete decoder;
+  decoder = nullptr;
+  ring    = std::vector<float>();
+}
+
+void AudioStream::play(const bool should_loop) {
+  is_looping.store(should_loop, std::memory_order_relaxed);
+  play_request_count.fetch_add(1, std::memory_order_relaxed);
+  is_playing.store(true, std::memory_order_release);
+}
+
+void AudioStream::stop() {
+  is_playing.store(false, std::memory_order_release);
+}
+
+uint32_t AudioStream::decode() {
+  const uint32_t play_request = play_request_count.load(std::memory_order_relaxed);
+  if (play_request != started_play_request_count.load(std::memory_order_relaxed)) {
+    // opened again instead of seeking, a seek leaves the resampler's filter ringing on every channel but the first
+    if (is_decoder_open) ma_decoder_uninit(decoder);
+    ma_decoder_config config = ma_decoder_config_init(ma_format_f32, channel_count, sample_rate_hz);
+    is_decoder_open = ma_decoder_init_file(file_path.c_str(), &config, decoder) == MA_SUCCESS;
+
+    const uint64_t write = write_frame.load(std::memory_order_relaxed);
+    start_frame.store(write, std::memory_order_relaxed);
+    end_frame.store(is_decoder_open ? UINT64_MAX : write, std::memory_order_relaxed);  // one that can't be opened again ends where it starts
+    started_play_request_count.store(play_request, std::memory_order_release);
+  }
+  if (!is_playing.load(std::memory_order_acquire)) return 0;
+
+  // the ring is only ever written where the callback has read, up to a whole ring ahead of it
+  const uint64_t write = write_frame.load(std::memory_order_relaxed);
+  const uint64_t read  = read_frame.load(std::memory_order_acquire);
+  if (write >= end_frame.load(std::memory_order_relaxed)) return 0;
+
+  uint32_t       decoded_frame_count = 0;
+  const uint32_t free_frame_count    = frame_capacity - static_cast<uint32_t>(write - read);
+  bool           is_at_start         = false;
+  while (decoded_frame_count < free_frame_count) {
+    const uint32_t ring_frame       = static_cast<uint32_t>((write + decoded_frame_count) & (frame_capacity - 1));
+    const uint32_t frames_to_decode = std::min(free_frame_count - decoded_frame_count, frame_capacity - ring_frame);  // up to where the ring wraps
+    ma_uint64      frames_decoded   = 0;
+    ma_decoder_read_pcm_frames(decoder, &ring[size_t(ring_frame) * channel_count], frames_to_decode, &frames_decoded);
+    decoded_frame_count += static_cast<uint32_t>(frames_decoded);
+
+    if (frames_decoded < frames_to_decode) {  // the end of the track
+      const bool is_empty = is_at_start && (frames_decoded == 0);
+      if (!is_looping.load(std::memory_order_relaxed) || is_empty) {
+        write_frame.store(write + decoded_frame_count, std::memory_order_release);
+        end_frame.store(write + decoded_frame_count, std::memory_order_release);
+        return decoded_frame_count;
+      }
+      if (ma_decoder_seek_to_pcm_frame(decoder, 0) != MA_SUCCESS) break;
+      is_at_start = true;
+    } else {
+      is_at_start = false;
+    }
+  }
+  write_frame.store(write + decoded_frame_count, std::memory_order_release);
+  return decoded_frame_count;
+}
+
+void AudioStream::mix(float* const mix_buffer, const uint32_t frame_count) {
+  if (!is_playing.load(std::memory_order_acquire)) return;
+  const uint32_t started_play_request = started_play_request_count.load(std::memory_order_acquire);
+  if (started_play_request != play_request_count.load(std::memory_order_relaxed)) return;  // not started over yet
+
+  // a start is heard once it's prefetched, what was decoded before it is skipped
+  uint64_t read = read_frame.load(std::memory_order_relaxed);
+  if (started_play_request != mixed_play_request_count) {
+    read                     = std::max(read, start_frame.load(std::memory_order_relaxed));  // never back, a later start may already be stored
+    mixed_play_request_count = started_play_request;
+    is_prefetching           = true;
+    read_frame.store(read, std::memory_order_release);
+  }
+  const uint64_t end   = end_frame.load(std::memory_order_acquire);  // before write_frame, which the decode thread stores first
+  const uint64_t write = write_frame.load(std::memory_order_acquire);
+  if (read >= end) return;  // played to the end, is_playing is only stored by play and stop so a play meanwhile isn't lost
+  if ( is_prefetching && ((write - read) < prefetch_frame_count) && (write < end) ) return;
+  is_prefetching = false;
+
+  const uint32_t frames_to_mix = static_cast<uint32_t>(std::min<uint64_t>(write - read, frame_count));
+  if ( (frames_to_mix < frame_count) && ((read + frames_to_mix) < end) ) underrun_count.fetch_add(1, std::memory_order_relaxed);
+
+  uint32_t mixed_frame_count = 0;
+  while (mixed_frame_count < frames_to_mix) {
+    const uint32_t ring_frame = static_cast<uint32_t>((read + mixed_frame_count) & (frame_capacity - 1));
+    const uint32_t frames     = std::min(frames_to_mix - mixed_frame_count, frame_capacity - ring_frame);
+    accumulate_audio_samples(mix_buffer + (size_t(mixed_frame_count) * channel_count), &ring[size_t(ring_frame) * channel_count], gain, frames * channel_count);
+    mixed_frame_count += frames;
+  }
+  read_frame.store(read + frames_to_mix, std::memory_order_release);
+}
+
+void AudioStreams::start_decode_thread(const uint32_t sample_rate_hz, const uint32_t period_frame_count) {
+  this->sample_rate_hz     = sample_rate_hz;
+  this->period_frame_count = period_frame_count;
+  is_decoding.store(true);
+  decode_thread = std::thread([this]() {
+    const auto sleep_duration = std::chrono::microseconds((500000ull * this->period_frame_count) / this->sample_rate_hz);
+    while (is_decoding.load(std::memory_order_relaxed)) {
+      const uint32_t stream_count = count.load(std::memory_order_acquire);
+      for (uint32_t i=0; i < stream_count; ++i) streams[i].decode();
+      std::this_thread::sleep_for(sleep_duration);
+    }
+  });
+}
+
+void AudioStreams::stop_decode_thread() {
+  if (!decode_thread.joinable()) return;
+  is_decoding.store(false);
+  decode_thread.join();
+}
+
+uint32_t AudioStreams::open(const char* file_path, const float gain) {
+  const uint32_t id = count.load(std::memory_order_relaxed);
+  if ( (id == max_count) || !streams[id].open(file_path, sample_rate_hz, period_frame_count, gain) ) return max_count;
+  count.store(id + 1, std::memory_order_release);
+  return id;
+}
+
+void AudioStreams::mix(float* const mix_buffer, const uint32_t frame_count) {
+  const uint32_t stream_count = count.load(std::memory_order_acquire);
+  for (uint32_t i=0; i < stream_count; ++i) streams[i].mix(mix_buffer, frame_count);
+}
+
+#endif  // TOM_ENGINE_AUDIO_MIXER_IMPLEMENTATION_SINGLE
+#endif  // TOM_ENGINE_AUDIO_MIXER_IMPLEMENTATION
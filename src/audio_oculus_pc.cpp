@@ -1,68 +1,92 @@
 #include <OVR_Audio.h>
 #include <miniaudio.h>
 #include <bitset>
+#include <vector>
 #include "maths.h"
 #include "platform.h"
+#include "audio_mixer.h"
 
 #define SAMPLE_RATE_HZ 48000
 #define SAMPLE_COUNT   480
 #define CHANNEL_COUNT  2
 
-struct AudioSources {
-  typedef uint32_t Index;
-  static constexpr uint32_t max_count = 32;
-
-  struct ColdData {
-    float attenuation_range_min_meters;
-    float attenuation_range_max_meters;
-    float radius_meters;  // 0.0 is a point source
-    float reverb_send_level;  // (0.0f to 1.0f)
-  };
-
-  std::bitset<max_count> is_audio_source_playing;
-  std::bitset<max_count> is_audio_source_looping;
-  Vector3f   global_positions[max_count];
-  ColdData   cold_data[max_count];
-  ma_decoder decoders[max_count];
-
-  uint32_t current_available_id = 0;
-};
+ma_context        ma_audio_context;
+ma_device         ma_audio_device;
+ovrAudioContext   ovr_audio_context;
+AudioVoices       all_audio_voices;        // only used by the audio thread
+uint32_t          audio_source_count = 0;  // only used by the thread pushing commands
+AudioSampleBank   audio_sample_bank;
+AudioCommandQueue audio_command_queue;
+AudioStreams      all_audio_streams;       // decoded by their own thread
+uint32_t          real_voice_statuses[AudioVoices::max_real_count];
+
+void set_up_reassigned_real_voices() {  // a spatializer source given to another voice starts over with the settings of that voice's source
+  for (AudioVoices::Index real_voice_index=0; real_voice_index < AudioVoices::max_real_count; ++real_voice_index) {
+    if (!all_audio_voices.is_real_voice_reassigned[real_voice_index]) continue;
+    all_audio_voices.is_real_voice_reassigned[real_voice_index] = false;
+
+    ovrAudio_ResetAudioSource(ovr_audio_context, (int)real_voice_index);
+    real_voice_statuses[real_voice_index] = ovrAudioSpatializationStatus_Finished;
+
+    const AudioVoices::Index voice_index = all_audio_voices.real_voice_owners[real_voice_index];
+    if (voice_index == AudioVoices::no_voice) continue;
+    const AudioCommand::Parameters& parameters = all_audio_voices.source_parameters[all_audio_voices.voices[voice_index].source_id];
+
+    if (!parameters.is_narrow_band) {
+      ovrAudio_SetAudioSourceFlags(ovr_audio_context, real_voice_index, ovrAudioSourceFlag_WideBand_HINT);
+    } else {
+      ovrAudio_SetAudioSourceFlags(ovr_audio_context, real_voice_index, ovrAudioSourceFlag_NarrowBand_HINT);
+    }
 
-ma_context      ma_audio_context;
-ma_device       ma_audio_device;
-ovrAudioContext ovr_audio_context;
-AudioSources    all_audio_sources;
+    ovrAudio_SetAudioSourceAttenuationMode(ovr_audio_context, real_voice_index, ovrAudioSourceAttenuationMode_InverseSquare, 1.0f); // last param is only relevant if using ovrAudioSourceAttenuationMode_Fixed
+    ovrAudio_SetAudioSourceRange(ovr_audio_context, real_voice_index, parameters.attenuation_range_min_meters, parameters.attenuation_range_max_meters);
+    ovrAudio_SetAudioSourceRadius(ovr_audio_context, real_voice_index, parameters.radius_meters);
+    ovrAudio_SetAudioReverbSendLevel(ovr_audio_context, real_voice_index, parameters.reverb_send_level);
+  }
+}
 
 extern std::string get_audio_output_device_id();
 
 void audio_data_callback(ma_device* device, void* output, const void* input, ma_uint32 frame_count)
 {
   // The contents of the output buffer passed into the data callback will always be pre-initialized to silence
-  // miniaudio will automatically clip samples by default (assuming ma_format_f32 playback sample format)
+  // miniaudio's clipping is turned off in init_audio since the mix is clipped at the end of this callback
 
   assert(device->playback.channels == CHANNEL_COUNT);
   assert(device->playback.format == ma_format_f32);
 
   static float* original_samples    = ovrAudio_AllocSamples(SAMPLE_COUNT);  // these are monophonic
   static float* spatialized_samples = ovrAudio_AllocSamples(SAMPLE_COUNT * CHANNEL_COUNT);
-  static uint32_t statuses[AudioSources::max_count];
   float* mix_buffer = (float*)output;
   ovrResult ovr_result;
 
+  // everything the audio functions asked for since the last callback, sources aren't touched by any other thread
+  AudioCommand command;
+  while (audio_command_queue.pop(command)) all_audio_voices.apply_command(command);
+
   const Vector3f tmp_hmd_global_position = hmd_global_position.load();
   Quaternionf tmp_hmd_global_orientation = hmd_global_orientation.load();
   const Vector3f hmd_forward_vector      = calculate_forward_vector(tmp_hmd_global_orientation);
   const Vector3f hmd_up_vector           = calculate_up_vector(tmp_hmd_global_orientation);
+  const Vector3f hmd_right_vector        = calculate_right_vector(tmp_hmd_global_orientation);
   ovr_result = ovrAudio_SetListenerVectors(ovr_audio_context, tmp_hmd_global_position.x, tmp_hmd_global_position.y, tmp_hmd_global_position.z, hmd_forward_vector.x, hmd_forward_vector.y, hmd_forward_vector.z, hmd_up_vector.x, hmd_up_vector.y, hmd_up_vector.z);
 
-  for (AudioSources::Index audio_source_index=0; audio_source_index < AudioSources::max_count; ++audio_source_index) {
-    if (all_audio_sources.is_audio_source_playing[audio_source_index] || (statuses[audio_source_index] == ovrAudioSpatializationStatus_Working)) {
-      // TODO: I don't think the standard guarantees that all bits being zero represent 0.0f but I think most modern architectures do so maybe memset
-      for (size_t i=0; i < SAMPLE_COUNT; ++i) original_samples[i] = 0.0f;
-      for (size_t i=0; i < (SAMPLE_COUNT * CHANNEL_COUNT); ++i) spatialized_samples[i] = 0.0f;
-
-      const Vector3f& position = all_audio_sources.global_positions[audio_source_index];
-      ovr_result = ovrAudio_SetAudioSourcePos(ovr_audio_context, audio_source_index, position.x, position.y, position.z);
+  // the most audible near voices get spatialized, other audible ones are panned and the rest only move their cursors
+  all_audio_voices.update_tiers(tmp_hmd_global_position, hmd_right_vector);
+  set_up_reassigned_real_voices();
+  all_audio_voices.mix_panned_voices(audio_sample_bank, mix_buffer, frame_count);
+  all_audio_voices.advance_virtual_voices(audio_sample_bank, frame_count);
+
+  for (AudioVoices::Index real_voice_index=0; real_voice_index < AudioVoices::max_real_count; ++real_voice_index) {
+    AudioVoices::Index voice_index = all_audio_voices.real_voice_owners[real_voice_index];
+    if ( (voice_index != AudioVoices::no_voice) || (real_voice_statuses[real_voice_index] == ovrAudioSpatializationStatus_Working) ) {
+      clear_audio_samples(original_samples, SAMPLE_COUNT);
+      clear_audio_samples(spatialized_samples, SAMPLE_COUNT * CHANNEL_COUNT);
+
+      if (voice_index != AudioVoices::no_voice) {  // one ringing out stays where its voice was
+        const Vector3f& position = all_audio_voices.voices[voice_index].position;
+        ovr_result = ovrAudio_SetAudioSourcePos(ovr_audio_context, real_voice_index, position.x, position.y, position.z);
+      }
 
       ma_uint32 total_frames_read = 0;
       while (total_frames_read < frame_count) {
@@ -72,28 +96,31 @@ void audio_data_callback(ma_device* device, void* output, const void* input, ma_
         frames_to_read_this_iteration = ( total_frames_remaining * static_cast<ma_uint32>(frames_to_read_this_iteration > total_frames_remaining) ) + ( frames_to_read_this_iteration * static_cast<ma_uint32>(frames_to_read_this_iteration <= total_frames_remaining) );
 
         ma_uint64 frames_read;
-        if (all_audio_sources.is_audio_source_playing[audio_source_index]) {
-          ma_decoder_read_pcm_frames(&all_audio_sources.decoders[audio_source_index], original_samples, frames_to_read_this_iteration, &frames_read);
+        if (voice_index != AudioVoices::no_voice) {
+          AudioVoices::Voice&          voice        = all_audio_voices.voices[voice_index];
+          const AudioSampleBank::Index sample_index = all_audio_voices.source_parameters[voice.source_id].sample_index;
+          frames_read = read_audio_sample_frames(audio_sample_bank, sample_index, voice.cursor, voice.is_looping, original_samples, frames_to_read_this_iteration);
+          if ( (voice.spatialized_gain != 1.0f) || (voice.next_spatialized_gain != 1.0f) ) {  // fading in or out while it changes tier
+            const float start = static_cast<float>(total_frames_read) / static_cast<float>(frame_count);
+            const float end   = static_cast<float>(total_frames_read + frames_read) / static_cast<float>(frame_count);
+            apply_audio_gain_ramp(original_samples, voice.spatialized_gain + ((voice.next_spatialized_gain - voice.spatialized_gain) * start),
+                                  voice.spatialized_gain + ((voice.next_spatialized_gain - voice.spatialized_gain) * end), static_cast<uint32_t>(frames_read));
+          }
         } else {  // handle reverberation tail by play silence until status is ovrAudioSpatializationStatus_Finished
-          for (size_t i=0; i < SAMPLE_COUNT; ++i) original_samples[i] = 0.0f;
+          clear_audio_samples(original_samples, SAMPLE_COUNT);
           frames_read = frames_to_read_this_iteration;
         }
 
-        ovr_result = ovrAudio_SpatializeMonoSourceInterleaved(ovr_audio_context, audio_source_index, &(statuses[audio_source_index]), spatialized_samples, original_samples);
+        ovr_result = ovrAudio_SpatializeMonoSourceInterleaved(ovr_audio_context, real_voice_index, &(real_voice_statuses[real_voice_index]), spatialized_samples, original_samples);
 
         const ma_uint64 offset = total_frames_read * CHANNEL_COUNT;
-        for (ma_uint64 sample_index=0; sample_index < (frames_read * CHANNEL_COUNT); ++sample_index) {
-          mix_buffer[offset + sample_index] += spatialized_samples[sample_index];
-        }
+        accumulate_audio_samples(mix_buffer + offset, spatialized_samples, static_cast<uint32_t>(frames_read * CHANNEL_COUNT));
 
         total_frames_read += (ma_uint32)frames_read;
 
-        if (frames_read < frames_to_read_this_iteration) {
-          if (all_audio_sources.is_audio_source_looping[audio_source_index]) {
-            ma_decoder_seek_to_pcm_frame(&all_audio_sources.decoders[audio_source_index], 0);
-          } else {
-            all_audio_sources.is_audio_source_playing[audio_source_index] = false;
-          }
+        if (frames_read < frames_to_read_this_iteration) {  // looping voices wrap around while reading so only the others run out, their real voice rings out
+          all_audio_voices.stop_voice(voice_index, false);
+          voice_index = AudioVoices::no_voice;
         }
       }
     }
@@ -101,9 +128,15 @@ void audio_data_callback(ma_device* device, void* output, const void* input, ma_
 
   uint32_t status;
   ovr_result = ovrAudio_MixInSharedReverbInterleaved(ovr_audio_context, &status, mix_buffer);
+
+  all_audio_streams.mix(mix_buffer, frame_count);  // not spatialized
+
+  clip_audio_samples(mix_buffer, frame_count * CHANNEL_COUNT);
 }
 
 bool init_audio() {
+  all_audio_voices.init();
+
   {
     if (ma_context_init(NULL, 0, NULL, &ma_audio_context) != MA_SUCCESS) return false;
 
@@ -128,11 +161,15 @@ bool init_audio() {
     config.playback.channels  = CHANNEL_COUNT;
     config.sampleRate         = SAMPLE_RATE_HZ;
     config.dataCallback       = audio_data_callback;
+    config.noClip             = MA_TRUE;  // clipped by audio_data_callback
     config.pUserData          = nullptr;  // a void* that can be accessed from device object during audio_data_callback
 
     if (ma_device_init(&ma_audio_context, &config, &ma_audio_device) != MA_SUCCESS) return false;
   }
 
+  // streams decode ahead of the callback by a few of its periods
+  all_audio_streams.start_decode_thread(SAMPLE_RATE_HZ, ma_audio_device.playback.internalPeriodSizeInFrames);
+
   // assert audio sdk version is correct
   {
     int major;
@@ -152,7 +189,7 @@ bool init_audio() {
     config.acc_Size          = sizeof(config);
     config.acc_SampleRate    = SAMPLE_RATE_HZ;
     config.acc_BufferLength  = SAMPLE_COUNT;
-    config.acc_MaxNumSources = AudioSources::max_count;
+    config.acc_MaxNumSources = AudioVoices::max_real_count;  // spatialization cost is bounded by the real voices however many voices play
 
     if ( ovrAudio_CreateContext(&ovr_audio_context, &config) != ovrSuccess ) return false;
   }
@@ -194,56 +231,60 @@ void stop_audio_device() {
 }
 
 void deactivate_audio() {
+  all_audio_streams.stop_decode_thread();
   ma_device_uninit(&ma_audio_device);
   ma_context_uninit(&ma_audio_context);
   ovrAudio_DestroyContext(ovr_audio_context);
+  for (AudioStream& stream : all_audio_streams.streams) stream.close();
 }
 
-uint32_t create_audio_source(const char* file_path, const float attenuation_range_min_meters, const float attenuation_range_max_meters, const float radius_meters, const float reverb_send_level, const bool is_narrow_band) {
-  const uint32_t id = all_audio_sources.current_available_id;
-  assert(id < AudioSources::max_count);
-  all_audio_sources.current_available_id += 1;
-  
-  ma_decoder_config config = ma_decoder_config_init(ma_format_f32, 1, SAMPLE_RATE_HZ);
-  ma_decoder_init_file(file_path, &config, &all_audio_sources.decoders[id]);
-
-  all_audio_sources.cold_data[id].attenuation_range_min_meters = attenuation_range_min_meters;
-  all_audio_sources.cold_data[id].attenuation_range_max_meters = attenuation_range_max_meters;
-  all_audio_sources.cold_data[id].radius_meters                = radius_meters;
-  all_audio_sources.cold_data[id].reverb_send_level            = reverb_send_level;
-
-  if (!is_narrow_band) {
-    ovrAudio_SetAudioSourceFlags(ovr_audio_context, id, ovrAudioSourceFlag_WideBand_HINT);
-  } else {
-    ovrAudio_SetAudioSourceFlags(ovr_audio_context, id, ovrAudioSourceFlag_NarrowBand_HINT);
-  }
+uint32_t create_audio_source(const char* file_path, const float attenuation_range_min_meters, const float attenuation_range_max_meters, const float radius_meters, const float reverb_send_level, const bool is_narrow_band, const float priority) {
+  const uint32_t id = audio_source_count;
+  assert(id < AudioVoices::max_source_count);
+  audio_source_count += 1;
+
+  // decoded once per sound instead of once per source and never in the audio callback
+  const AudioSampleBank::Index sample_index = audio_sample_bank.load_from_file(file_path, SAMPLE_RATE_HZ);
+  assert(sample_index != AudioSampleBank::Index(-1));
 
-  ovrAudio_SetAudioSourceAttenuationMode(ovr_audio_context, id, ovrAudioSourceAttenuationMode_InverseSquare, 1.0f); // last param is only relevant if using ovrAudioSourceAttenuationMode_Fixed
-  ovrAudio_SetAudioSourceRange(ovr_audio_context, id, all_audio_sources.cold_data[id].attenuation_range_min_meters, all_audio_sources.cold_data[id].attenuation_range_max_meters);
-  ovrAudio_SetAudioSourceRadius(ovr_audio_context, id, all_audio_sources.cold_data[id].radius_meters);
-  ovrAudio_SetAudioReverbSendLevel(ovr_audio_context, id, all_audio_sources.cold_data[id].reverb_send_level);
+  AudioCommand command{ AudioCommand::Type::SetParameters, id };
+  command.parameters = { sample_index, attenuation_range_min_meters, attenuation_range_max_meters, radius_meters, reverb_send_level, is_narrow_band, priority };
+  const bool is_pushed = audio_command_queue.push(command);
+  assert(is_pushed);
 
   return id;
 }
 
 void update_audio_source(const uint32_t id, const Vector3f position) {
-  all_audio_sources.global_positions[id] = position;
+  audio_command_queue.push({ AudioCommand::Type::Move, id, false, position });
 }
 
 void delete_audio_source(const uint32_t id) {
-  all_audio_sources.is_audio_source_playing[id] = false;
-  all_audio_sources.is_audio_source_looping[id] = false;
-  ovrAudio_ResetAudioSource(ovr_audio_context, (int)id);
-  ma_decoder_uninit(&all_audio_sources.decoders[id]);
+  audio_command_queue.push({ AudioCommand::Type::Delete, id });
 }
 
 void play_audio_source(const uint32_t id, const bool should_loop) {
-  ma_decoder_seek_to_pcm_frame(&all_audio_sources.decoders[id], 0);
-  all_audio_sources.is_audio_source_playing[id] = true;
-  all_audio_sources.is_audio_source_looping[id] = should_loop;
+  audio_command_queue.push({ AudioCommand::Type::Play, id, should_loop });
+}
+
+void fire_audio_source(const uint32_t id, const Vector3f position) {
+  audio_command_queue.push({ AudioCommand::Type::Fire, id, false, position });
 }
 
 void stop_audio_source(const uint32_t id) {
-  all_audio_sources.is_audio_source_playing[id] = false;
-  ovrAudio_ResetAudioSource(ovr_audio_context, (int)id);
+  audio_command_queue.push({ AudioCommand::Type::Stop, id });
+}
+
+uint32_t create_audio_stream(const char* file_path, const float gain) {
+  const uint32_t id = all_audio_streams.open(file_path, gain);
+  assert(id != AudioStreams::max_count);
+  return id;
+}
+
+void play_audio_stream(const uint32_t id, const bool should_loop) {
+  all_audio_streams.streams[id].play(should_loop);
+}
+
+void stop_audio_stream(const uint32_t id) {
+  all_audio_streams.streams[id].stop();
 }
@@ -5,6 +5,9 @@
 #define APPLICATION_VERSION 1
 
 //#define USE_PROFILER
+//#define WRITE_FRAME_METRICS_CSV  // per-frame timings are written to frame_metrics.csv (on Quest 2 it is in the app's internal data directory)
+//#define RECORD_MATCH_REPLAY      // the seed and input of every tick are written to match.replay (on Quest 2 it is in the app's internal data directory)
+//#define PLAY_MATCH_REPLAY        // match.replay is re-run without rendering as fast as possible, the result is logged and then the app exits
 
 #pragma warning(disable:4530) // allow using std libs with exceptions disabled
 #pragma warning(disable:4068) // hide unknown pragma clang warnings
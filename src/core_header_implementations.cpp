@@ -9,9 +9,30 @@
 #define TOM_ENGINE_PLATFORM_IMPLEMENTATION
 #include "platform.h"
 
+#define TOM_ENGINE_REPLAY_IMPLEMENTATION
+#include "replay.h"
+
+#define TOM_ENGINE_NAVIGATION_IMPLEMENTATION
+#include "navigation.h"
+
+#define TOM_ENGINE_MATCH_STATE_IMPLEMENTATION
+#include "match_state.h"
+
+#define TOM_ENGINE_ROLLBACK_IMPLEMENTATION
+#include "rollback.h"
+
+#define TOM_ENGINE_METRICS_IMPLEMENTATION
+#include "metrics.h"
+
+#define TOM_ENGINE_TEXTURE_ATLAS_IMPLEMENTATION
+#include "texture_atlas.h"
+
 #define TOM_ENGINE_GRAPHICS_IMPLEMENTATION
 #include "graphics.h"
 
+#define TOM_ENGINE_AUDIO_MIXER_IMPLEMENTATION
+#include "audio_mixer.h"
+
 #define TOM_ENGINE_AUDIO_IMPLEMENTATION
 #include "audio.h"
 
@@ -23,8 +44,15 @@
 #define STB_IMAGE_RESIZE_IMPLEMENTATION
 #include <stb_image_resize.h>
 
+#define STB_RECT_PACK_IMPLEMENTATION
+#include <stb_rect_pack.h>
+
+#define STB_VORBIS_HEADER_ONLY
+#include <stb_vorbis.c>  // decodes ogg vorbis for miniaudio's decoder which streams music
 #define MINIAUDIO_IMPLEMENTATION
 #include <miniaudio.h>
+#undef STB_VORBIS_HEADER_ONLY
+#include <stb_vorbis.c>
 
 #pragma warning(disable : 4996)
 #define CGLTF_IMPLEMENTATION
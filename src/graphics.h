@@ -2,6 +2,8 @@
 #define INCLUDE_TOM_ENGINE_GRAPHICS_H
 
 #include "maths.h"
+#include <algorithm>
+#include <bit>
 #include <vector>
 
 typedef uint32_t GraphicsIndex;
@@ -12,6 +14,7 @@ struct GraphicsVertex {
   Vector2f texture_coordinates;
   Vector4f joint_indices; // max 4 joints
   Vector4f joint_weights; // one weight per joint
+  uint32_t material_id = uint32_t(-1); // overrides the instance's material, set by static batches that merge blocks of different materials
 
   GraphicsVertex() = default;
   GraphicsVertex(Vector3f p_position, Vector3f p_normal) : position(p_position), normal(p_normal) {}
@@ -29,8 +32,69 @@ struct GraphicsMesh {
   float sphere_volume_radius;
 };
 
+// hands out ranges of instance slots rounded up to a power of two, a freed range goes on the free list of its size class and is reused as is,
+// freeing the topmost range gives its slots back to the untouched end so pooled spawning never runs out or leaves holes
+template<uint32_t max_count>
+struct GraphicsInstanceRanges {
+  static constexpr uint32_t size_class_count = 32;
+
+  uint32_t end;                                 // slots from here on were never handed out or were given back
+  uint32_t free_range_heads[size_class_count];  // first slot + 1 of a free range per size class, 0 when there is none so zeroed ranges start empty
+  uint32_t next_free_ranges[max_count];         // first slot + 1 of the next free range of the same size class, set on a free range's first slot
+  uint32_t generations[max_count];              // bumped when the range starting at the slot is freed so arrays kept after destroying them are caught
+  uint8_t  size_classes[max_count];             // of the range starting at the slot
+
+  static uint32_t get_size_class(const uint32_t count) {
+    return static_cast<uint32_t>(std::bit_width(count - 1));
+  }
+
+  uint32_t allocate(const uint32_t count) {
+    assert(count > 0);
+    const uint32_t size_class = get_size_class(count);
+
+    uint32_t first;
+    if (free_range_heads[size_class] != 0) {
+      first = free_range_heads[size_class] - 1;
+      free_range_heads[size_class] = next_free_ranges[first];
+    } else {
+      first = end;
+      assert( (first + (uint32_t(1) << size_class)) <= max_count );
+      end += uint32_t(1) << size_class;
+    }
+    size_classes[first] = static_cast<uint8_t>(size_class);
+
+    return first;
+  }
+
+  void free(const uint32_t first) {
+    const uint32_t size_class = size_classes[first];
+    ++generations[first];
+
+    if ( (first + (uint32_t(1) << size_class)) == end ) {
+      end = first;
+      return;
+    }
+    next_free_ranges[first]      = free_range_heads[size_class];
+    free_range_heads[size_class] = first + 1;
+  }
+
+  uint32_t get_range_size(const uint32_t first) const {
+    return uint32_t(1) << size_classes[first];
+  }
+
+  bool is_current(const uint32_t first, const uint32_t generation) const {  // false once the range was freed, even if it was handed out again
+    return generations[first] == generation;
+  }
+};
+
 struct GraphicsMeshInstances {
+#if defined(HEADLESS)
+  static constexpr uint32_t max_count = 1 << 20;  // nothing is drawn so big arenas (SimulationState::board_width) aren't held to the instance buffer size
+#else
   static constexpr uint32_t max_count = 2048;
+#endif
+  static constexpr uint32_t max_parent_count = 8;
+  static constexpr uint8_t  no_parent        = 0;  // parent slot 0 is never allocated so zeroed instances have no parent
 
   struct BufferData {
     Vector3f model_matrix_column_0;
@@ -65,24 +129,113 @@ struct GraphicsMeshInstances {
     CullData   cull_data;
   };
 
-  uint32_t mesh_ids[max_count];
-  DrawData draw_data[max_count];
-  float    skeleton_radius_overrides[max_count];
+  uint32_t   mesh_ids[max_count];
+  DrawData   draw_data[max_count];
+  float      skeleton_radius_overrides[max_count];
+  uint8_t    parent_ids[max_count];  // an instance with a parent has its draw data relative to the parent, the render thread applies the parent
+  Matrix4x4f parent_matrices[max_parent_count];
+  float      parent_largest_scales[max_parent_count];  // grows the cull radius
+  uint32_t   last_parent_id;                           // no_parent until one is allocated so zeroed instances start without parents
+  uint64_t   visible_bits[max_count / 64];
+  uint32_t   active_ids[max_count];  // every visible instance packed in no particular order, drawing and syncing only walk these so hidden instances cost nothing
+  uint32_t   active_id_positions[max_count];  // where a visible instance is in active_ids
+  uint32_t   active_count;
+  GraphicsInstanceRanges<max_count> ranges;
+
+  bool is_visible(const uint32_t index) const {
+    return (visible_bits[index >> 6] >> (index & 63)) & 1;
+  }
 
-  uint32_t allocate_mesh_instances(const uint32_t instance_count) {
-    static uint32_t current_mesh_instance_index = 0;
+  void show(const uint32_t index) {
+    if (is_visible(index)) return;
+
+    visible_bits[index >> 6]   |= (uint64_t(1) << (index & 63));
+    active_id_positions[index]  = active_count;
+    active_ids[active_count]    = index;
+    ++active_count;
+  }
+
+  void hide(const uint32_t index) {  // the last active id takes the hidden one's place
+    if (!is_visible(index)) return;
+
+    visible_bits[index >> 6] &= ~(uint64_t(1) << (index & 63));
+    const uint32_t position   = active_id_positions[index];
+    const uint32_t last_index = active_ids[--active_count];
+    active_ids[position]            = last_index;
+    active_id_positions[last_index] = position;
+  }
+
+  void copy_active_instances(const GraphicsMeshInstances& source) {  // only what drawing reads, inactive instances are left stale
+    active_count = source.active_count;
+    std::copy(source.parent_matrices, source.parent_matrices + max_parent_count, parent_matrices);
+    std::copy(source.parent_largest_scales, source.parent_largest_scales + max_parent_count, parent_largest_scales);
+    for (uint32_t i=0; i < active_count; ++i) {
+      const uint32_t index = source.active_ids[i];
+      active_ids[i]     = index;
+      mesh_ids[index]   = source.mesh_ids[index];
+      draw_data[index]  = source.draw_data[index];
+      parent_ids[index] = source.parent_ids[index];
+    }
+  }
+
+  uint32_t allocate_parent() {
+    assert((last_parent_id + 1) < max_parent_count);
+    return ++last_parent_id;
+  }
+
+  DrawData get_global_draw_data(const uint32_t index) const {  // the draw data with its parent applied
+    if (parent_ids[index] == no_parent) return draw_data[index];
+
+    const float* const parent = parent_matrices[parent_ids[index]].m;
+    auto rotate_scale = [parent](const Vector3f& v) -> Vector3f {
+      return { (parent[0] * v.x) + (parent[4] * v.y) + (parent[8] * v.z), (parent[1] * v.x) + (parent[5] * v.y) + (parent[9] * v.z), (parent[2] * v.x) + (parent[6] * v.y) + (parent[10] * v.z) };
+    };
+    auto transform_point = [&](const Vector3f& v) -> Vector3f {
+      const Vector3f rotated_scaled = rotate_scale(v);
+      return { rotated_scaled.x + parent[12], rotated_scaled.y + parent[13], rotated_scaled.z + parent[14] };
+    };
+
+    DrawData result = draw_data[index];
+    result.buffer_data.model_matrix_column_0 = rotate_scale(result.buffer_data.model_matrix_column_0);
+    result.buffer_data.model_matrix_column_1 = rotate_scale(result.buffer_data.model_matrix_column_1);
+    result.buffer_data.model_matrix_column_2 = rotate_scale(result.buffer_data.model_matrix_column_2);
+    result.buffer_data.model_matrix_column_3 = transform_point(result.buffer_data.model_matrix_column_3);
+    result.cull_data.position                = transform_point(result.cull_data.position);
+    result.cull_data.radius                 *= parent_largest_scales[parent_ids[index]];
+    return result;
+  }
 
-    assert( (current_mesh_instance_index + (instance_count - 1)) < max_count );
-    const uint32_t result = current_mesh_instance_index;
-    current_mesh_instance_index += instance_count;
+  void get_active_global_draw_data(DrawData* const active_global_draw_data) const {  // in active_ids order, the render thread resolves parents once per frame before grouping by mesh
+    for (uint32_t i=0; i < active_count; ++i) {
+      active_global_draw_data[i] = get_global_draw_data(active_ids[i]);
+    }
+  }
+
+  uint32_t allocate_mesh_instances(const uint32_t instance_count) {
+    const uint32_t result = ranges.allocate(instance_count);
+    for (uint32_t i=result; i < (result + instance_count); ++i) show(i);  // visible until hidden, slots rounding up the range stay hidden
 
     return result;
   };
+
+  void free_mesh_instances(const uint32_t first_mesh_instance) {  // the caller has already cleared the mesh ids
+    for (uint32_t i=first_mesh_instance; i < (first_mesh_instance + ranges.get_range_size(first_mesh_instance)); ++i) {
+      hide(i);
+      parent_ids[i] = no_parent;
+    }
+    ranges.free(first_mesh_instance);
+  }
 };
 
 struct GraphicsMeshInstanceArray {
   uint32_t first_mesh_instance;
   uint32_t size;
+  uint32_t generation;  // of its range when it was created, checked by updates so a destroyed array can't write over a reused range
+};
+
+struct GraphicsStaticInstance {  // a copy of a mesh baked into a static batch
+  Transform transform;
+  uint32_t  material_id;
 };
 
 struct GraphicsMaterial {
@@ -90,7 +243,8 @@ struct GraphicsMaterial {
   alignas(16) Vector3f emissive_factor;
   alignas(4)  float    metallic_factor;
   alignas(4)  float    roughness_factor;
-  alignas(4)  uint32_t base_color_map_index;
+  alignas(4)  uint32_t base_color_map_index;       // page of the base color atlas
+  alignas(16) Vector4f base_color_map_uv_rect;    // offset then scale of the texture in its page
 };
 
 struct DirectionalLight {
@@ -135,7 +289,11 @@ struct AnimationState {
 
 struct GraphicsSkeletonInstances {
   typedef uint32_t Index;
+#if defined(HEADLESS)
+  static constexpr uint32_t max_buffer_data_joint_count = 1 << 14;  // no vertex shader so there is room for big arena player counts
+#else
   static constexpr uint32_t max_buffer_data_joint_count = 256;  // this is also hardcoded in vertex shader
+#endif
 
   struct BufferData {
     alignas(16) Matrix4x4f joint_matrices[max_buffer_data_joint_count]; // TODO: use a 3x4 matrix (remove redundant 0,0,0,1)
@@ -144,20 +302,24 @@ struct GraphicsSkeletonInstances {
   uint16_t skeleton_ids[max_buffer_data_joint_count]; // assumed not to be manually changed in simulation thread
   AnimationState animation_states[max_buffer_data_joint_count];
 
-  Index allocate_skeleton_instances(const Index joint_count) {
-    static Index current_skeleton_instance_index = 0;
+  GraphicsInstanceRanges<max_buffer_data_joint_count> ranges;
 
-    assert( (current_skeleton_instance_index + (joint_count - 1)) < max_buffer_data_joint_count );
-    const Index result = current_skeleton_instance_index;
-    current_skeleton_instance_index += joint_count;
+  Index allocate_skeleton_instances(const Index joint_count) {
+    return ranges.allocate(joint_count);
+  }
 
-    return result;
+  void free_skeleton_instances(const Index first_skeleton_instance) {  // stops its animations so the render thread doesn't pose a freed range
+    for (Index i=first_skeleton_instance; i < (first_skeleton_instance + ranges.get_range_size(first_skeleton_instance)); ++i) {
+      animation_states[i].animation_id = uint32_t(-1);
+    }
+    ranges.free(first_skeleton_instance);
   }
 };
 
 struct GraphicsSkeletonInstanceArray {
   uint32_t first_skeleton_instance;
   uint32_t size;
+  uint32_t generation;
 };
 
 struct Animation {
@@ -261,6 +423,14 @@ void upload_graphics_meshes_from_glb_file(const char* file_path, GraphicsModel*
 void create_graphics_mesh_instance_array_from_glb(const char* file_path, GraphicsMeshInstanceArray& mesh_instance_array, GraphicsModel* model_file_cache=nullptr);
 void update_graphics_mesh_instance_array(const GraphicsMeshInstanceArray& mesh_instance_array, const Transform& transform, const uint32_t material_id, const uint32_t joint_index, const uint32_t index);
 void destroy_graphics_mesh_instance_array(GraphicsMeshInstanceArray& mesh_instance_array);
+// bakes every mesh of the glb once per instance into combined meshes, a chunk of instances_per_chunk consecutive instances each, for blocks that never move relative to each other
+// the array gets an instance per chunk and glb mesh that is already placed, it is culled as a whole chunk and only needs updating to change the chunk transform
+void create_graphics_static_batch_from_glb(const char* file_path, const GraphicsStaticInstance* const instances, const uint32_t instance_count, const uint32_t instances_per_chunk, GraphicsMeshInstanceArray& mesh_instance_array);
+void merge_graphics_static_mesh(const GraphicsMesh& mesh, const GraphicsStaticInstance* const instances, const uint32_t instance_count, GraphicsMesh& merged_mesh, Vector3f& merged_mesh_center);  // merged vertices are relative to the center
+uint32_t create_graphics_transform_parent();  // starts as the identity
+void update_graphics_transform_parent(const uint32_t parent_id, const Transform& transform);  // moves every instance under the parent without touching their data
+void set_graphics_mesh_instance_array_parent(const GraphicsMeshInstanceArray& mesh_instance_array, const uint32_t parent_id);  // later updates of the array are relative to the parent
+void set_graphics_mesh_instance_array_visibility(const GraphicsMeshInstanceArray& mesh_instance_array, const bool is_visible);  // arrays start visible, hidden ones are skipped without being culled
 void upload_graphics_materials(GraphicsMaterial* const materials, const uint32_t count, const uint32_t start_index);
 void update_ambient_light_intensity(const float intensity);
 void load_graphics_skeletons_from_glb_file(const char* file_path, GraphicsModel* model_file_cache=nullptr);
@@ -289,11 +459,92 @@ extern DirectionalLight directional_light;
 #ifndef TOM_ENGINE_GRAPHICS_IMPLEMENTATION_SINGLE
 #define TOM_ENGINE_GRAPHICS_IMPLEMENTATION_SINGLE
 
+// the id of a material with the same parameters, or of the material appended when there is none, so create_graphics_material never spends a slot twice
+uint32_t find_or_add_graphics_material(std::vector<GraphicsMaterial>& materials, const GraphicsMaterial& material) {
+  auto is_equal = [](const GraphicsMaterial& a, const GraphicsMaterial& b) {
+    return (memcmp(&a.base_color_factor, &b.base_color_factor, sizeof(Vector4f)) == 0) && (memcmp(&a.emissive_factor, &b.emissive_factor, sizeof(Vector3f)) == 0) &&
+           (a.metallic_factor == b.metallic_factor) && (a.roughness_factor == b.roughness_factor) && (a.base_color_map_index == b.base_color_map_index) &&
+           (memcmp(&a.base_color_map_uv_rect, &b.base_color_map_uv_rect, sizeof(Vector4f)) == 0);
+  };
+
+  for (uint32_t i=0; i < static_cast<uint32_t>(materials.size()); ++i) {
+    if (is_equal(materials[i], material)) return i;
+  }
+  materials.push_back(material);
+  return static_cast<uint32_t>(materials.size() - 1);
+}
+
 #if defined(OCULUS_PC)
   #include "graphics_oculus_pc.cpp"
 #elif defined(OCULUS_QUEST_2)
   #include "graphics_oculus_quest_2.cpp"
+#elif defined(HEADLESS)
+  #include "graphics_headless.cpp"
 #endif
 
+#include <cfloat>
+
+uint32_t create_graphics_transform_parent() {
+  const uint32_t parent_id = graphics_all_mesh_instances.allocate_parent();
+  update_graphics_transform_parent(parent_id, identity_transform);
+  return parent_id;
+}
+
+void update_graphics_transform_parent(const uint32_t parent_id, const Transform& transform) {
+  create_transform_matrix(transform, graphics_all_mesh_instances.parent_matrices[parent_id]);
+  graphics_all_mesh_instances.parent_largest_scales[parent_id] = std::max( abs(transform.scale.x), std::max(abs(transform.scale.y), abs(transform.scale.z)) );
+}
+
+void set_graphics_mesh_instance_array_parent(const GraphicsMeshInstanceArray& mesh_instance_array, const uint32_t parent_id) {
+  for (uint32_t i=0; i < mesh_instance_array.size; ++i) {
+    graphics_all_mesh_instances.parent_ids[mesh_instance_array.first_mesh_instance + i] = static_cast<uint8_t>(parent_id);
+  }
+}
+
+void set_graphics_mesh_instance_array_visibility(const GraphicsMeshInstanceArray& mesh_instance_array, const bool is_visible) {
+  for (uint32_t i=0; i < mesh_instance_array.size; ++i) {
+    if (is_visible) graphics_all_mesh_instances.show(mesh_instance_array.first_mesh_instance + i);
+    else            graphics_all_mesh_instances.hide(mesh_instance_array.first_mesh_instance + i);
+  }
+}
+
+void merge_graphics_static_mesh(const GraphicsMesh& mesh, const GraphicsStaticInstance* const instances, const uint32_t instance_count, GraphicsMesh& merged_mesh, Vector3f& merged_mesh_center) {
+  merged_mesh.vertices.clear();
+  merged_mesh.indices.clear();
+  merged_mesh.vertices.reserve(mesh.vertices.size() * instance_count);
+  merged_mesh.indices.reserve(mesh.indices.size() * instance_count);
+
+  Vector3f smallest_position = {  FLT_MAX,  FLT_MAX,  FLT_MAX };
+  Vector3f largest_position  = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+  for (uint32_t instance_index=0; instance_index < instance_count; ++instance_index) {
+    Matrix4x4f model_matrix;
+    create_transform_matrix(instances[instance_index].transform, model_matrix);
+    const float* const m = model_matrix.m;
+
+    const GraphicsIndex first_vertex = static_cast<GraphicsIndex>(merged_mesh.vertices.size());
+    for (GraphicsVertex vertex : mesh.vertices) {
+      const Vector3f p = vertex.position;
+      const Vector3f n = vertex.normal;
+      vertex.position    = { (m[0] * p.x) + (m[4] * p.y) + (m[8] * p.z) + m[12], (m[1] * p.x) + (m[5] * p.y) + (m[9] * p.z) + m[13], (m[2] * p.x) + (m[6] * p.y) + (m[10] * p.z) + m[14] };
+      const Vector3f scaled_normal = { (m[0] * n.x) + (m[4] * n.y) + (m[8] * n.z), (m[1] * n.x) + (m[5] * n.y) + (m[9] * n.z), (m[2] * n.x) + (m[6] * n.y) + (m[10] * n.z) };  // right for uniform scales which blocks have
+      const float    normal_length = sqrtf( (scaled_normal.x * scaled_normal.x) + (scaled_normal.y * scaled_normal.y) + (scaled_normal.z * scaled_normal.z) );
+      vertex.normal      = { scaled_normal.x / normal_length, scaled_normal.y / normal_length, scaled_normal.z / normal_length };
+      vertex.material_id = instances[instance_index].material_id;
+      merged_mesh.vertices.push_back(vertex);
+
+      smallest_position = { std::min(smallest_position.x, vertex.position.x), std::min(smallest_position.y, vertex.position.y), std::min(smallest_position.z, vertex.position.z) };
+      largest_position  = { std::max(largest_position.x, vertex.position.x),  std::max(largest_position.y, vertex.position.y),  std::max(largest_position.z, vertex.position.z) };
+    }
+    for (const GraphicsIndex index : mesh.indices) merged_mesh.indices.push_back(first_vertex + index);
+  }
+
+  // centered like loaded meshes so the instance transform places it and the radius covers it
+  merged_mesh_center = { lerp(smallest_position.x, largest_position.x, 0.5f), lerp(smallest_position.y, largest_position.y, 0.5f), lerp(smallest_position.z, largest_position.z, 0.5f) };
+  for (GraphicsVertex& vertex : merged_mesh.vertices) {
+    vertex.position = { vertex.position.x - merged_mesh_center.x, vertex.position.y - merged_mesh_center.y, vertex.position.z - merged_mesh_center.z };
+  }
+  merged_mesh.sphere_volume_radius = std::max( largest_position.x - smallest_position.x, std::max(largest_position.y - smallest_position.y, largest_position.z - smallest_position.z) );
+}
+
 #endif  // TOM_ENGINE_GRAPHICS_IMPLEMENTATION_SINGLE
 #endif  // TOM_ENGINE_GRAPHICS_IMPLEMENTATION
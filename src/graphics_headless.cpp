@@ -0,0 +1,354 @@
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <functional>
+#include <unordered_map>
+#include <cgltf.h>
+#include "graphics.h"
+#include "platform.h"
+
+// nothing is rendered; glb files are only parsed for their mesh, skin and animation layout so the simulation
+// writes the same instance and skeleton data it would on a headset
+
+struct HeadlessModel {
+  uint32_t mesh_count;
+  uint32_t joint_count;
+  std::vector<GraphicsSkin::MeshInstanceHierarchyNode> mesh_hierarchy;  // index is same as mesh index
+  AnimationArray animations;
+};
+
+struct HeadlessMaterials {
+  static constexpr uint32_t max_count = 256;
+
+  std::vector<GraphicsMaterial> materials;  // deduplicated like the device backends so material ids match theirs
+  std::unordered_map<std::string, uint32_t> file_path_to_texture_index;  // nothing is decoded so only paths are compared
+};
+
+constexpr uint32_t headless_missing_model_mesh_count = 2;  // for assets that aren't checked in (the controllers), enough for every index the simulation updates
+constexpr float    headless_mesh_radius              = 1.0f;
+
+GraphicsMeshInstances                          graphics_all_mesh_instances;
+GraphicsSkeletonInstances                      graphics_all_skeleton_instances;
+RenderThreadSimulationState                    graphics_render_thread_sim_state;
+DirectionalLight                               directional_light;
+float                                          ambient_light_intensity;
+HeadlessMaterials                              headless_all_materials;
+std::vector<Animation>                         headless_all_animations;
+std::unordered_map<std::string, HeadlessModel> headless_models;
+
+static Transform headless_node_local_transform(const cgltf_node* node) {
+  Transform local_transform = identity_transform;
+  if (node->has_translation) local_transform.translation = { node->translation[0], node->translation[1], node->translation[2] };
+  if (node->has_rotation)    local_transform.orientation = { node->rotation[0], node->rotation[1], node->rotation[2], node->rotation[3] };
+  if (node->has_scale)       local_transform.scale       = { node->scale[0], node->scale[1], node->scale[2] };
+  return local_transform;
+}
+
+static const HeadlessModel& headless_load_model(const char* file_path) {
+  auto cached_model = headless_models.find(file_path);
+  if (cached_model != headless_models.end()) return cached_model->second;
+
+  HeadlessModel& model = headless_models[file_path];
+  model.joint_count = 0;
+  model.animations  = { uint32_t(-1), 0 };
+
+  cgltf_options options{};
+  cgltf_data* data = NULL;
+  if (cgltf_parse_file(&options, file_path, &data) != cgltf_result_success) {
+    DEBUG_LOG("headless graphics: %s not found so using %u placeholder meshes\n", file_path, headless_missing_model_mesh_count);
+    model.mesh_count = headless_missing_model_mesh_count;
+    model.mesh_hierarchy.assign(model.mesh_count, { GraphicsSkin::MeshInstanceHierarchyNode::Index(-1), 0, identity_transform, identity_transform, 0 });
+    return model;
+  }
+
+  /* meshes, one per primitive like the headset builds */
+  std::vector<GraphicsSkin::MeshInstanceHierarchyNode::Index> node_index_to_mesh_index(data->nodes_count, GraphicsSkin::MeshInstanceHierarchyNode::Index(-1));
+  model.mesh_count = 0;
+  for (size_t node_index=0; node_index < data->nodes_count; ++node_index) {
+    const cgltf_node* node = &data->nodes[node_index];
+    if (!node->mesh) continue;
+    node_index_to_mesh_index[node_index] = static_cast<GraphicsSkin::MeshInstanceHierarchyNode::Index>(model.mesh_count);
+    model.mesh_count += static_cast<uint32_t>(node->mesh->primitives_count);
+  }
+
+  model.mesh_hierarchy.resize(model.mesh_count);
+  for (size_t node_index=0; node_index < data->nodes_count; ++node_index) {
+    const cgltf_node* node = &data->nodes[node_index];
+    if (!node->mesh) continue;
+
+    // the nearest ancestor with a mesh is the parent and the transforms of the nodes in between are folded in
+    Transform local_transform = headless_node_local_transform(node);
+    GraphicsSkin::MeshInstanceHierarchyNode::Index parent_index = -1;
+    for (const cgltf_node* parent_node = node->parent; parent_node; parent_node = parent_node->parent) {
+      if (parent_node->mesh) {
+        parent_index = node_index_to_mesh_index[parent_node - data->nodes];
+        break;
+      }
+      combine_transform(headless_node_local_transform(parent_node), local_transform);
+    }
+
+    const GraphicsSkin::MeshInstanceHierarchyNode::Index first_mesh_index = node_index_to_mesh_index[node_index];
+    for (size_t primitive_index=0; primitive_index < node->mesh->primitives_count; ++primitive_index) {
+      model.mesh_hierarchy[first_mesh_index + primitive_index] = { parent_index, 0, local_transform, local_transform, 0 };
+    }
+    if (parent_index != GraphicsSkin::MeshInstanceHierarchyNode::Index(-1)) {
+      model.mesh_hierarchy[parent_index].children_count += static_cast<GraphicsSkin::MeshInstanceHierarchyNode::Index>(node->mesh->primitives_count);
+    }
+  }
+
+  for (size_t skin_index=0; skin_index < data->skins_count; ++skin_index) {
+    model.joint_count += static_cast<uint32_t>(data->skins[skin_index].joints_count);
+  }
+
+  /* animations only need their time range since joints aren't posed */
+  if (data->animations_count > 0) {
+    model.animations = { static_cast<uint32_t>(headless_all_animations.size()), static_cast<uint32_t>(data->animations_count) };
+    for (size_t animation_index=0; animation_index < data->animations_count; ++animation_index) {
+      const cgltf_animation& source_animation = data->animations[animation_index];
+      Animation animation;
+      animation.name               = source_animation.name ? source_animation.name : "";
+      animation.start_time_seconds = 0.0f;
+      animation.end_time_seconds   = 0.0f;
+      for (size_t sampler_index=0; sampler_index < source_animation.samplers_count; ++sampler_index) {
+        const cgltf_accessor* input = source_animation.samplers[sampler_index].input;
+        if (input->has_max && (input->max[0] > animation.end_time_seconds)) animation.end_time_seconds = input->max[0];
+      }
+      headless_all_animations.push_back(animation);
+    }
+  }
+
+  cgltf_free(data);
+  return model;
+}
+
+bool init_graphics() {
+  memset(graphics_all_mesh_instances.mesh_ids, 0xFF, sizeof(graphics_all_mesh_instances.mesh_ids));
+  for (GraphicsSkeletonInstances::Index i=0; i < GraphicsSkeletonInstances::max_buffer_data_joint_count; ++i) {
+    graphics_all_skeleton_instances.animation_states[i].animation_id = uint32_t(-1);
+  }
+  return true;
+}
+
+void deactivate_graphics() {
+  headless_models.clear();
+  headless_all_animations.clear();
+}
+
+void upload_graphics_meshes_from_glb_file(const char* file_path, GraphicsModel* model_file_cache) {
+  headless_load_model(file_path);
+}
+
+void load_graphics_skeletons_from_glb_file(const char* file_path, GraphicsModel* model_file_cache) {
+  headless_load_model(file_path);
+}
+
+AnimationArray load_animations_from_glb_file(const char* file_path, GraphicsModel* model_file_cache) {
+  return headless_load_model(file_path).animations;
+}
+
+void create_graphics_mesh_instance_array_from_glb(const char* file_path, GraphicsMeshInstanceArray& mesh_instance_array, GraphicsModel* model_file_cache) {
+  const HeadlessModel& model = headless_load_model(file_path);
+
+  mesh_instance_array.first_mesh_instance = graphics_all_mesh_instances.allocate_mesh_instances(model.mesh_count);
+  mesh_instance_array.size                = model.mesh_count;
+  mesh_instance_array.generation          = graphics_all_mesh_instances.ranges.generations[mesh_instance_array.first_mesh_instance];
+
+  for (uint32_t i=0; i < model.mesh_count; ++i) {
+    graphics_all_mesh_instances.mesh_ids[mesh_instance_array.first_mesh_instance + i]                  = 0;
+    graphics_all_mesh_instances.skeleton_radius_overrides[mesh_instance_array.first_mesh_instance + i] = headless_mesh_radius;
+  }
+}
+
+void create_graphics_static_batch_from_glb(const char* file_path, const GraphicsStaticInstance* const instances, const uint32_t instance_count, const uint32_t instances_per_chunk, GraphicsMeshInstanceArray& mesh_instance_array) {
+  const HeadlessModel& model = headless_load_model(file_path);
+  const uint32_t chunk_count = (instance_count + (instances_per_chunk - 1)) / instances_per_chunk;
+
+  mesh_instance_array.first_mesh_instance = graphics_all_mesh_instances.allocate_mesh_instances(chunk_count * model.mesh_count);
+  mesh_instance_array.size                = chunk_count * model.mesh_count;
+  mesh_instance_array.generation          = graphics_all_mesh_instances.ranges.generations[mesh_instance_array.first_mesh_instance];
+
+  // no vertices to merge, each chunk is placed at its first block
+  for (uint32_t chunk_index=0; chunk_index < chunk_count; ++chunk_index) {
+    const GraphicsStaticInstance& first_instance = instances[chunk_index * instances_per_chunk];
+    for (uint32_t mesh_index=0; mesh_index < model.mesh_count; ++mesh_index) {
+      const uint32_t index = (chunk_index * model.mesh_count) + mesh_index;
+      graphics_all_mesh_instances.mesh_ids[mesh_instance_array.first_mesh_instance + index] = 0;
+      update_graphics_mesh_instance_array(mesh_instance_array, { first_instance.transform.position, identity_orientation, default_scale }, first_instance.material_id, uint32_t(-1), index);
+    }
+  }
+}
+
+void update_graphics_mesh_instance_array(const GraphicsMeshInstanceArray& mesh_instance_array, const Transform& transform, const uint32_t material_id, const uint32_t joint_index, const uint32_t index) {
+  assert(graphics_all_mesh_instances.ranges.is_current(mesh_instance_array.first_mesh_instance, mesh_instance_array.generation));
+  GraphicsMeshInstances::BufferData instance(transform, material_id, joint_index);
+
+  float largest_scale_magnitude = abs(transform.scale.x);
+  float tmp_radius;
+  if ((tmp_radius=abs(transform.scale.y)) > largest_scale_magnitude) {
+    largest_scale_magnitude = tmp_radius;
+  }
+  if ((tmp_radius=abs(transform.scale.z)) > largest_scale_magnitude) {
+    largest_scale_magnitude = tmp_radius;
+  }
+
+  const float scale = (joint_index == uint32_t(-1)) ? largest_scale_magnitude * headless_mesh_radius : largest_scale_magnitude * graphics_all_mesh_instances.skeleton_radius_overrides[mesh_instance_array.first_mesh_instance + index];
+
+  graphics_all_mesh_instances.draw_data[mesh_instance_array.first_mesh_instance + index] = { instance, {transform.position, scale} };
+}
+
+void destroy_graphics_mesh_instance_array(GraphicsMeshInstanceArray& mesh_instance_array) {
+  for (uint32_t i=0; i < mesh_instance_array.size; ++i) {
+    graphics_all_mesh_instances.mesh_ids[mesh_instance_array.first_mesh_instance + i] = -1;
+  }
+  graphics_all_mesh_instances.free_mesh_instances(mesh_instance_array.first_mesh_instance);
+
+  mesh_instance_array.first_mesh_instance = -1;
+}
+
+void create_graphics_skeleton_instance_array_from_glb(const char* file_path, GraphicsSkeletonInstanceArray& skeleton_instance_array, GraphicsModel* model_file_cache) {
+  const HeadlessModel& model = headless_load_model(file_path);
+  if (model.joint_count == 0) {
+    skeleton_instance_array.first_skeleton_instance = GraphicsSkeletonInstances::Index(-1);
+    skeleton_instance_array.size = 0;
+    return;
+  }
+
+  skeleton_instance_array.first_skeleton_instance = graphics_all_skeleton_instances.allocate_skeleton_instances(model.joint_count);
+  skeleton_instance_array.size                    = 1;
+  skeleton_instance_array.generation              = graphics_all_skeleton_instances.ranges.generations[skeleton_instance_array.first_skeleton_instance];
+  graphics_all_skeleton_instances.skeleton_ids[skeleton_instance_array.first_skeleton_instance] = 0;
+}
+
+void destroy_graphics_skeleton_instance_array(GraphicsSkeletonInstanceArray& skeleton_instance_array) {
+  if (skeleton_instance_array.size > 0) graphics_all_skeleton_instances.free_skeleton_instances(skeleton_instance_array.first_skeleton_instance);
+  skeleton_instance_array.first_skeleton_instance = -1;
+}
+
+void create_graphics_skin_from_glb(const char* file_path, GraphicsSkin& skin) {
+  GraphicsSkeletonInstanceArray skeleton_instance_array;
+
+  create_graphics_mesh_instance_array_from_glb(file_path, skin.mesh_instance_array);
+  create_graphics_skeleton_instance_array_from_glb(file_path, skeleton_instance_array);
+  skin.mesh_instance_hierarchy = headless_load_model(file_path).mesh_hierarchy;
+  skin.skeleton_instance_id    = skeleton_instance_array.first_skeleton_instance;
+
+  if (skin.mesh_instance_array.size > 1) {
+    GraphicsSkin::MeshInstanceHierarchyNode::Index root_index = -1;
+
+    for (GraphicsSkin::MeshInstanceHierarchyNode::Index i=0; i < skin.mesh_instance_array.size; ++i) {
+      if (skin.mesh_instance_hierarchy[i].parent_index == GraphicsSkin::MeshInstanceHierarchyNode::Index(-1)) {
+        root_index = i;
+        break;
+      }
+    }
+
+    for (GraphicsSkin::MeshInstanceHierarchyNode::Index i = root_index + 1; i < skin.mesh_instance_array.size; ++i) {
+      if (skin.mesh_instance_hierarchy[i].parent_index == GraphicsSkin::MeshInstanceHierarchyNode::Index(-1)) {
+        skin.mesh_instance_hierarchy[i].parent_index = root_index;
+        skin.mesh_instance_hierarchy[root_index].children_count += 1;
+      }
+    }
+  }
+}
+
+void GraphicsSkin::update(const GraphicsSkin::MeshInstanceHierarchyNode::Index index, const Transform& global_transform, uint32_t material_id) {
+  this->mesh_instance_hierarchy[index].global_transform = global_transform;
+  this->mesh_instance_hierarchy[index].material_id      = material_id;
+  const uint32_t mesh_count = this->mesh_instance_array.size;
+  update_graphics_mesh_instance_array(this->mesh_instance_array, global_transform, material_id, this->skeleton_instance_id, index);
+
+  std::function<void(std::vector<GraphicsSkin::MeshInstanceHierarchyNode>&, GraphicsSkin::MeshInstanceHierarchyNode::Index,GraphicsMeshInstanceArray&,uint32_t)> update_all_children_transforms;
+  update_all_children_transforms = [&update_all_children_transforms,&mesh_count](std::vector<GraphicsSkin::MeshInstanceHierarchyNode>& hierarchy, GraphicsSkin::MeshInstanceHierarchyNode::Index node_index, GraphicsMeshInstanceArray& mesh_instances, uint32_t skeleton_instance_index) {
+    GraphicsSkin::MeshInstanceHierarchyNode& node = hierarchy[node_index];
+    if ( !(node.children_count > 0) ) return;
+
+    GraphicsSkin::MeshInstanceHierarchyNode::Index current_child_count = 0;
+    for (GraphicsSkin::MeshInstanceHierarchyNode::Index i=0; (i < mesh_count) && (current_child_count < node.children_count); ++i) {
+      if (hierarchy[i].parent_index == node_index) {
+        hierarchy[i].global_transform = hierarchy[i].local_transform;
+        combine_transform(node.global_transform, hierarchy[i].global_transform);
+        update_graphics_mesh_instance_array(mesh_instances, hierarchy[i].global_transform, hierarchy[i].material_id, skeleton_instance_index, i);
+        update_all_children_transforms(hierarchy, i, mesh_instances, skeleton_instance_index);
+        ++current_child_count;
+      }
+    }
+  };
+
+  update_all_children_transforms(this->mesh_instance_hierarchy, index, this->mesh_instance_array, this->skeleton_instance_id);
+}
+
+void GraphicsSkin::update(const GraphicsSkin::MeshInstanceHierarchyNode::Index index, uint32_t material_id) {
+  this->mesh_instance_hierarchy[index].material_id = material_id;
+  update_graphics_mesh_instance_array(this->mesh_instance_array, this->mesh_instance_hierarchy[index].global_transform, material_id, this->skeleton_instance_id, index);
+}
+
+void GraphicsSkin::update_all(uint32_t material_id) {
+  for (GraphicsSkin::MeshInstanceHierarchyNode::Index i=0; i < this->mesh_instance_array.size; ++i) {
+    this->update(i, material_id);
+  }
+}
+
+void GraphicsSkin::play_animation(const uint32_t animation_id, const float speed_factor, const bool is_looping) {
+  if (this->skeleton_instance_id != GraphicsSkeletonInstances::Index(-1)) {
+    graphics_all_skeleton_instances.animation_states[this->skeleton_instance_id] = { animation_id, headless_all_animations[animation_id].start_time_seconds, speed_factor, is_looping };
+  }
+}
+
+void GraphicsSkin::stop_animating() {
+  if (this->skeleton_instance_id != GraphicsSkeletonInstances::Index(-1)) {
+    graphics_all_skeleton_instances.animation_states[this->skeleton_instance_id].animation_id = uint32_t(-1);
+  }
+}
+
+void AnimationState::tick_time() {
+  this->time_seconds += frame_delta_time_seconds * this->speed_factor * static_cast<float>(this->animation_id != uint32_t(-1));
+
+  const Animation& animation   = headless_all_animations[this->animation_id];
+  const bool is_animation_over = this->time_seconds > animation.end_time_seconds;
+  const float duration         = animation.end_time_seconds - animation.start_time_seconds;
+  const float time_passed      = this->time_seconds - animation.start_time_seconds;
+
+  this->time_seconds =
+    ( this->time_seconds * static_cast<float>(!is_animation_over) ) +
+    ( (fmod(time_passed, duration) + animation.start_time_seconds) * static_cast<float>(is_animation_over && this->is_looping) ) +
+    ( animation.end_time_seconds * static_cast<float>(is_animation_over && !this->is_looping) );
+}
+
+void upload_graphics_materials(GraphicsMaterial* const materials, const uint32_t count, const uint32_t start_index) {
+  assert( (start_index + count) <= headless_all_materials.materials.size() );
+  memcpy(headless_all_materials.materials.data() + start_index, materials, sizeof(GraphicsMaterial) * count);
+}
+
+uint32_t upload_base_color_map_from_file(const char* file_path) {
+  const uint32_t next_texture_index = static_cast<uint32_t>(headless_all_materials.file_path_to_texture_index.size());
+  return headless_all_materials.file_path_to_texture_index.try_emplace(file_path, next_texture_index).first->second;
+}
+
+uint32_t create_graphics_material(const Vector4f& base_color_factor, const Vector3f& emissive_factor, const float metallic_factor, const float roughness_factor, const char* base_color_map_file_path) {
+  GraphicsMaterial material{ base_color_factor, emissive_factor, metallic_factor, roughness_factor, static_cast<uint32_t>(-1) };
+  if (base_color_map_file_path != nullptr) {
+    material.base_color_map_index = upload_base_color_map_from_file(base_color_map_file_path);
+  }
+
+  const uint32_t id = find_or_add_graphics_material(headless_all_materials.materials, material);
+  assert(id < HeadlessMaterials::max_count);
+
+  return id;
+}
+
+uint32_t create_graphics_material(const float metallic_factor, const float roughness_factor, const char* base_color_map_file_path) {
+  return create_graphics_material(Vector4f{1.0f, 1.0f, 1.0f, 1.0f}, Vector3f{0.0f, 0.0f, 0.0f}, metallic_factor, roughness_factor, base_color_map_file_path);
+}
+
+uint32_t create_graphics_material(const Vector4f& base_color_factor, const float metallic_factor, const float roughness_factor) {
+  return create_graphics_material(base_color_factor, Vector3f{0.0f, 0.0f, 0.0f}, metallic_factor, roughness_factor, nullptr);
+}
+
+uint32_t get_max_material_count() {
+  return HeadlessMaterials::max_count;
+}
+
+void update_ambient_light_intensity(const float intensity) {
+  ambient_light_intensity = intensity;
+}
@@ -28,6 +28,7 @@
 #include <cmath>
 #include <limits>
 #include "config.h"
+#include "texture_atlas.h"
 #include "platform.h"
 #include "simulation.h"
 #include "tom_std.h"
@@ -82,7 +83,17 @@ struct VkTextureArray {
   VkDeviceMemory texture_staging_buffer_memory;
   void* texture_mapped_memory = nullptr;
 
-  void upload_texture_from_file(const std::string& file_path, const uint32_t index);
+  void upload_atlas_texture(const TextureAtlas::Rect& rect, const std::vector<uint8_t>& mip_levels);  // layers are the pages of an atlas
+};
+
+struct VkTextureCache {  // a rect of the atlas per distinct texture, looked up by path first and then by content so copies under other paths share it too
+  static constexpr uint32_t max_texture_count = 64;
+
+  std::unordered_map<std::string, uint32_t> file_path_to_texture_index;
+  std::unordered_map<uint64_t, uint32_t>    content_hash_to_texture_index;
+  uint32_t current_texture_index = 0;
+  TextureAtlas       atlas;
+  TextureAtlas::Rect texture_rects[max_texture_count];
 };
 
 struct VkUniformBuffer {
@@ -99,10 +110,9 @@ struct GlobalUniformBufferObject {
   alignas(4)  float      ambient_light_factor;
 };
 
-struct MaterialUniformBufferObject {
-  static constexpr uint32_t max_count = 16;  // this is also hardcoded in fragment shader
-
-  GraphicsMaterial materials[max_count];
+struct VkMaterials {  // every distinct material once, in a storage buffer sized by init_graphics
+  std::vector<GraphicsMaterial> materials;
+  uint32_t max_count;
 };
 
 struct SkeletonInstanceUniformBufferObject {
@@ -181,6 +191,12 @@ struct VkMeshes {
   }
 
   SourceFileIdData insert_from_glb_source_file(const char* file_path, GraphicsModel* model_file_cache=nullptr);
+  Index insert_mesh(const GraphicsMesh& mesh);  // uploaded as is, for meshes that aren't from a file like static batches
+  bool  has_room_for(const GraphicsMesh& mesh) const {  // a mesh id and space in the draw buffer
+    return (current_available_mesh_id < max_count) && ((current_draw_buffer_index_count + mesh.indices.size()) <= draw_buffer->max_indices_count) &&
+           ((current_draw_buffer_vertex_count + mesh.vertices.size()) <= draw_buffer->max_vertices_count);
+  }
+  void upload_mesh(const Index mesh_id, const GraphicsMesh& mesh);
 };
 
 struct VkAnimations {
@@ -249,8 +265,10 @@ VkDescriptorSetLayout            vulkan_descriptor_set_layout;
 VkDescriptorPool                 vulkan_descriptor_pool;
 VkDescriptorSet                  vulkan_descriptor_sets[vulkan_max_frames_in_flight];
 VkTextureArray*                  vulkan_base_color_map_array;
+VkTextureCache                   vulkan_texture_cache;
+VkMaterials                      vulkan_all_materials;
 VkUniformBuffer*                 vulkan_global_uniform_buffers[vulkan_max_frames_in_flight];
-VkUniformBuffer*                 vulkan_material_uniform_buffer;
+VkUniformBuffer*                 vulkan_material_storage_buffer;
 VkUniformBuffer*                 vulkan_skeleton_instance_uniform_buffers[vulkan_max_frames_in_flight];
 VkMeshes                         vulkan_all_meshes;
 VkSkeletons                      vulkan_all_skeletons;
@@ -334,6 +352,19 @@ void create_vk_uniform_buffer(VkUniformBuffer* const uniform_buffer) {
   vkMapMemory(vulkan_logical_device, uniform_buffer->memory, 0, VK_WHOLE_SIZE, 0, &uniform_buffer->mapped_memory);
 }
 
+void create_vk_storage_buffer(const VkDeviceSize size, VkUniformBuffer* const storage_buffer) {  // host visible like the uniform buffers, only the usage differs
+  VkBufferCreateInfo buffer_info{VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+  buffer_info.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+  buffer_info.size  = size;
+  vkCreateBuffer(vulkan_logical_device, &buffer_info, nullptr, &storage_buffer->buffer);
+
+  VkMemoryRequirements memory_requirements = {};
+  vkGetBufferMemoryRequirements(vulkan_logical_device, storage_buffer->buffer, &memory_requirements);
+  vk_allocate_memory(memory_requirements, &storage_buffer->memory, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+  vkBindBufferMemory(vulkan_logical_device, storage_buffer->buffer, storage_buffer->memory, 0);
+  vkMapMemory(vulkan_logical_device, storage_buffer->memory, 0, VK_WHOLE_SIZE, 0, &storage_buffer->mapped_memory);
+}
+
 void destroy_vk_uniform_buffer(VkUniformBuffer* const uniform_buffer) {
   vkUnmapMemory(vulkan_logical_device, uniform_buffer->memory);
   vkDestroyBuffer(vulkan_logical_device, uniform_buffer->buffer, nullptr);
@@ -585,7 +616,8 @@ void create_vk_xr_swapchain_context(const uint32_t image_count, const XrSwapchai
       { 7,  1, VK_FORMAT_R32G32B32_SFLOAT,    offsetof(GraphicsMeshInstances::BufferData, model_matrix_column_2) },
       { 8,  1, VK_FORMAT_R32G32B32_SFLOAT,    offsetof(GraphicsMeshInstances::BufferData, model_matrix_column_3) },
       { 9,  1, VK_FORMAT_R32_UINT,            offsetof(GraphicsMeshInstances::BufferData, material_id)           },
-      { 10, 1, VK_FORMAT_R32_UINT,            offsetof(GraphicsMeshInstances::BufferData, joint_index)           }
+      { 10, 1, VK_FORMAT_R32_UINT,            offsetof(GraphicsMeshInstances::BufferData, joint_index)           },
+      { 11, 0, VK_FORMAT_R32_UINT,            offsetof(GraphicsVertex, material_id)                              }
     };
 
     VkPipelineVertexInputStateCreateInfo vertex_input_state_info{VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO};
@@ -962,7 +994,10 @@ void create_vk_texture_array(const VkFormat& texture_format, const uint32_t laye
       break;
     }
   }
-  texture_array->texture_size = layered_image_width * layered_image_height * format_bytes_per_pixel;
+  texture_array->texture_size = 0;  // staging fits the mip levels of a texture as big as a layer
+  for (uint32_t mip_level=0; mip_level < layered_image_mip_level_count; ++mip_level) {
+    texture_array->texture_size += VkDeviceSize(std::max(layered_image_width >> mip_level, 1u)) * std::max(layered_image_height >> mip_level, 1u) * format_bytes_per_pixel;
+  }
 
   assert(vulkan_physical_device_properties.limits.maxImageArrayLayers >= texture_array->max_texture_count);
 
@@ -1032,119 +1067,56 @@ uint32_t calculate_mip_level_count(const uint32_t image_width, const uint32_t im
   return static_cast<uint32_t>( std::floor(std::log2(std::max(image_width, image_height))) ) + 1;
 }
 
-void VkTextureArray::upload_texture_from_file(const std::string& file_path, const uint32_t texture_index) {
-  assert(texture_index < max_texture_count);
+void VkTextureArray::upload_atlas_texture(const TextureAtlas::Rect& rect, const std::vector<uint8_t>& mip_levels) {
+  assert(rect.page_index < max_texture_count);
+  assert(this->layered_image_mip_level_count == TextureAtlas::mip_level_count);
+  assert(mip_levels.size() <= this->texture_size);
 
-  // load texture
-  int width;
-  int height;
-  int channel_count;
-  stbi_uc* pixels = nullptr;
-  if (this->format == VK_FORMAT_R8G8B8A8_SRGB) {
-    pixels = stbi_load(file_path.c_str(), &width, &height, &channel_count, STBI_rgb_alpha);
-  }
-  assert(pixels);
-
-  // resize texture if needed
-  if ( (width != this->layered_image_width) || (height != this->layered_image_height) ) {
-    stbi_uc* resized_pixels = (stbi_uc*) malloc(this->texture_size);
-    stbir_resize_uint8(pixels, width, height, 0, resized_pixels, static_cast<int>(this->layered_image_width), static_cast<int>(this->layered_image_height), 0, 4);  // 4 is a hard-coded channel count for STBI_rgb_alpha (channel_count variable is actual number of channels in source image but we load it as 4 channels)
-    stbi_image_free(pixels);
-    pixels = resized_pixels;
-  }
-
-  // copy texture to staging buffer
-  memcpy(this->texture_mapped_memory, pixels, static_cast<size_t>(this->texture_size));
-  stbi_image_free(pixels);
+  // copy texture's padded mip levels to staging buffer
+  memcpy(this->texture_mapped_memory, mip_levels.data(), mip_levels.size());
 
   VkCommandBuffer tmp_command_buffer = vulkan_begin_temporary_command_buffer();
 
+  // the page keeps the textures already packed into it since only a transition from undefined discards its texels
   VkImageMemoryBarrier texture_image_shader_read_only_to_transfer_dst_barrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
   texture_image_shader_read_only_to_transfer_dst_barrier.srcAccessMask    = VK_ACCESS_SHADER_READ_BIT;
   texture_image_shader_read_only_to_transfer_dst_barrier.dstAccessMask    = VK_ACCESS_TRANSFER_WRITE_BIT;
   texture_image_shader_read_only_to_transfer_dst_barrier.oldLayout        = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
   texture_image_shader_read_only_to_transfer_dst_barrier.newLayout        = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
   texture_image_shader_read_only_to_transfer_dst_barrier.image            = this->layered_image;
-  texture_image_shader_read_only_to_transfer_dst_barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, this->layered_image_mip_level_count, texture_index, 1 };
+  texture_image_shader_read_only_to_transfer_dst_barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, this->layered_image_mip_level_count, rect.page_index, 1 };
   vkCmdPipelineBarrier(tmp_command_buffer, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &texture_image_shader_read_only_to_transfer_dst_barrier);
 
-  // copy texture from staging buffer to texture array
-  VkBufferImageCopy copy_info{};
-  copy_info.bufferOffset                    = 0;
-  copy_info.bufferRowLength                 = 0;
-  copy_info.bufferImageHeight               = 0;
-  copy_info.imageSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
-  copy_info.imageSubresource.mipLevel       = 0;
-  copy_info.imageSubresource.baseArrayLayer = texture_index;
-  copy_info.imageSubresource.layerCount     = 1;
-  copy_info.imageOffset                     = { 0, 0, 0 };
-  copy_info.imageExtent                     = { this->layered_image_width, this->layered_image_height, 1 };
-  vkCmdCopyBufferToImage(tmp_command_buffer, this->texture_staging_buffer, this->layered_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copy_info);
-
-  // generate mip maps
-  VkImageMemoryBarrier mip_transfer_dst_to_transfer_src_barrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
-  mip_transfer_dst_to_transfer_src_barrier.srcAccessMask                   = VK_ACCESS_TRANSFER_WRITE_BIT;
-  mip_transfer_dst_to_transfer_src_barrier.dstAccessMask                   = VK_ACCESS_TRANSFER_READ_BIT;
-  mip_transfer_dst_to_transfer_src_barrier.oldLayout                       = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-  mip_transfer_dst_to_transfer_src_barrier.newLayout                       = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-  mip_transfer_dst_to_transfer_src_barrier.image                           = this->layered_image;
-  mip_transfer_dst_to_transfer_src_barrier.subresourceRange.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
-  mip_transfer_dst_to_transfer_src_barrier.subresourceRange.baseArrayLayer = texture_index;
-  mip_transfer_dst_to_transfer_src_barrier.subresourceRange.layerCount     = 1;
-  mip_transfer_dst_to_transfer_src_barrier.subresourceRange.levelCount     = 1;
-
-  VkImageMemoryBarrier mip_transfer_src_to_shader_read_only_barrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
-  mip_transfer_src_to_shader_read_only_barrier.srcAccessMask                   = VK_ACCESS_TRANSFER_READ_BIT;
-  mip_transfer_src_to_shader_read_only_barrier.dstAccessMask                   = VK_ACCESS_SHADER_READ_BIT;
-  mip_transfer_src_to_shader_read_only_barrier.oldLayout                       = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-  mip_transfer_src_to_shader_read_only_barrier.newLayout                       = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-  mip_transfer_src_to_shader_read_only_barrier.image                           = this->layered_image;
-  mip_transfer_src_to_shader_read_only_barrier.subresourceRange.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
-  mip_transfer_src_to_shader_read_only_barrier.subresourceRange.baseArrayLayer = texture_index;
-  mip_transfer_src_to_shader_read_only_barrier.subresourceRange.layerCount     = 1;
-  mip_transfer_src_to_shader_read_only_barrier.subresourceRange.levelCount     = 1;
-
-  int32_t current_mip_width  = this->layered_image_width;
-  int32_t current_mip_height = this->layered_image_height;
-  for (uint32_t mip_level=1; mip_level < this->layered_image_mip_level_count; ++mip_level) {
-    mip_transfer_dst_to_transfer_src_barrier.subresourceRange.baseMipLevel     = mip_level - 1;
-    mip_transfer_src_to_shader_read_only_barrier.subresourceRange.baseMipLevel = mip_level - 1;
-
-    vkCmdPipelineBarrier(tmp_command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &mip_transfer_dst_to_transfer_src_barrier);
-
-    VkImageBlit blit{};
-    blit.srcOffsets[0]                 = { 0, 0, 0 };
-    blit.srcOffsets[1]                 = { current_mip_width, current_mip_height, 1 };
-    blit.srcSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
-    blit.srcSubresource.mipLevel       = mip_level - 1;
-    blit.srcSubresource.baseArrayLayer = texture_index;
-    blit.srcSubresource.layerCount     = 1;
-    blit.dstOffsets[0]                 = { 0, 0, 0 };
-    blit.dstOffsets[1]                 = { current_mip_width > 1 ? current_mip_width / 2 : 1, current_mip_height > 1 ? current_mip_height / 2 : 1, 1 };
-    blit.dstSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
-    blit.dstSubresource.mipLevel       = mip_level;
-    blit.dstSubresource.baseArrayLayer = texture_index;
-    blit.dstSubresource.layerCount     = 1;
-    vkCmdBlitImage(tmp_command_buffer, this->layered_image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, this->layered_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, VK_FILTER_LINEAR);
-
-    vkCmdPipelineBarrier(tmp_command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &mip_transfer_src_to_shader_read_only_barrier);
-
-    if (current_mip_width  > 1) current_mip_width  /= 2;
-    if (current_mip_height > 1) current_mip_height /= 2;
-  }
-
-  VkImageMemoryBarrier mip_transfer_dst_to_shader_read_only_barrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
-  mip_transfer_dst_to_shader_read_only_barrier.srcAccessMask                   = VK_ACCESS_TRANSFER_WRITE_BIT;
-  mip_transfer_dst_to_shader_read_only_barrier.dstAccessMask                   = VK_ACCESS_SHADER_READ_BIT;
-  mip_transfer_dst_to_shader_read_only_barrier.oldLayout                       = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-  mip_transfer_dst_to_shader_read_only_barrier.newLayout                       = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-  mip_transfer_dst_to_shader_read_only_barrier.image                           = this->layered_image;
-  mip_transfer_dst_to_shader_read_only_barrier.subresourceRange.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
-  mip_transfer_dst_to_shader_read_only_barrier.subresourceRange.baseArrayLayer = texture_index;
-  mip_transfer_dst_to_shader_read_only_barrier.subresourceRange.layerCount     = 1;
-  mip_transfer_dst_to_shader_read_only_barrier.subresourceRange.levelCount     = 1;
-  mip_transfer_dst_to_shader_read_only_barrier.subresourceRange.baseMipLevel   = this->layered_image_mip_level_count - 1;
-  vkCmdPipelineBarrier(tmp_command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &mip_transfer_dst_to_shader_read_only_barrier);
+  // copy every mip level from staging buffer to the texture's padded rect in its page, mip levels are made on the cpu so padding is kept per level
+  VkBufferImageCopy copy_infos[TextureAtlas::mip_level_count]{};
+  VkDeviceSize      buffer_offset = 0;
+  for (uint32_t mip_level=0; mip_level < TextureAtlas::mip_level_count; ++mip_level) {
+    const uint32_t padded_width  = rect.get_padded_width(mip_level);
+    const uint32_t padded_height = rect.get_padded_height(mip_level);
+
+    VkBufferImageCopy& copy_info = copy_infos[mip_level];
+    copy_info.bufferOffset                    = buffer_offset;
+    copy_info.bufferRowLength                 = 0;
+    copy_info.bufferImageHeight               = 0;
+    copy_info.imageSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+    copy_info.imageSubresource.mipLevel       = mip_level;
+    copy_info.imageSubresource.baseArrayLayer = rect.page_index;
+    copy_info.imageSubresource.layerCount     = 1;
+    copy_info.imageOffset                     = { static_cast<int32_t>((rect.x - TextureAtlas::padding) >> mip_level), static_cast<int32_t>((rect.y - TextureAtlas::padding) >> mip_level), 0 };
+    copy_info.imageExtent                     = { padded_width, padded_height, 1 };
+
+    buffer_offset += VkDeviceSize(padded_width) * padded_height * TextureAtlas::bytes_per_texel;
+  }
+  vkCmdCopyBufferToImage(tmp_command_buffer, this->texture_staging_buffer, this->layered_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, TextureAtlas::mip_level_count, copy_infos);
+
+  VkImageMemoryBarrier texture_image_transfer_dst_to_shader_read_only_barrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
+  texture_image_transfer_dst_to_shader_read_only_barrier.srcAccessMask    = VK_ACCESS_TRANSFER_WRITE_BIT;
+  texture_image_transfer_dst_to_shader_read_only_barrier.dstAccessMask    = VK_ACCESS_SHADER_READ_BIT;
+  texture_image_transfer_dst_to_shader_read_only_barrier.oldLayout        = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+  texture_image_transfer_dst_to_shader_read_only_barrier.newLayout        = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+  texture_image_transfer_dst_to_shader_read_only_barrier.image            = this->layered_image;
+  texture_image_transfer_dst_to_shader_read_only_barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, this->layered_image_mip_level_count, rect.page_index, 1 };
+  vkCmdPipelineBarrier(tmp_command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &texture_image_transfer_dst_to_shader_read_only_barrier);
 
   vulkan_end_then_submit_temporary_command_buffer(tmp_command_buffer);
 }
@@ -1696,30 +1668,87 @@ VkMeshes::SourceFileIdData VkMeshes::insert_from_glb_source_file(const char* fil
   for (size_t i=0; i < model_file.meshes.size(); ++i) {
     GraphicsMesh optimized_mesh;
     graphics_deduplicate_vertices(model_file.meshes[i], optimized_mesh);
+    upload_mesh(static_cast<VkMeshes::Index>(first_mesh_id + i), optimized_mesh);
+  }
 
-    vulkan_all_meshes.all_hot_draw_data[first_mesh_id + i].index_count   = static_cast<uint32_t>(optimized_mesh.indices.size());
-    vulkan_all_meshes.all_hot_draw_data[first_mesh_id + i].first_index   = static_cast<uint32_t>(this->current_draw_buffer_index_count);
-    vulkan_all_meshes.all_hot_draw_data[first_mesh_id + i].first_vertex  = static_cast<uint32_t>(this->current_draw_buffer_vertex_count);
-    vulkan_all_meshes.all_cold_draw_data[first_mesh_id + i].vertex_count = static_cast<uint32_t>(optimized_mesh.vertices.size());
-    vulkan_all_meshes.all_radii[first_mesh_id + i]                       = optimized_mesh.sphere_volume_radius;
+  return id_data;
+}
 
-    this->draw_buffer->update(optimized_mesh.indices.data(), optimized_mesh.indices.size(), optimized_mesh.vertices.data(), optimized_mesh.vertices.size(), this->current_draw_buffer_index_count, this->current_draw_buffer_vertex_count);
+VkMeshes::Index VkMeshes::insert_mesh(const GraphicsMesh& mesh) {
+  const VkMeshes::Index mesh_id = this->current_available_mesh_id;
+  assert(mesh_id < VkMeshes::max_count);
+  this->current_available_mesh_id += 1;
 
-    this->current_draw_buffer_index_count  += optimized_mesh.indices.size();
-    this->current_draw_buffer_vertex_count += optimized_mesh.vertices.size();
-  }
+  upload_mesh(mesh_id, mesh);
+  return mesh_id;
+}
 
-  return id_data;
+void VkMeshes::upload_mesh(const Index mesh_id, const GraphicsMesh& mesh) {
+  assert( ((this->current_draw_buffer_index_count + mesh.indices.size()) <= this->draw_buffer->max_indices_count) && ((this->current_draw_buffer_vertex_count + mesh.vertices.size()) <= this->draw_buffer->max_vertices_count) );
+  this->all_hot_draw_data[mesh_id].index_count   = static_cast<uint32_t>(mesh.indices.size());
+  this->all_hot_draw_data[mesh_id].first_index   = static_cast<uint32_t>(this->current_draw_buffer_index_count);
+  this->all_hot_draw_data[mesh_id].first_vertex  = static_cast<uint32_t>(this->current_draw_buffer_vertex_count);
+  this->all_cold_draw_data[mesh_id].vertex_count = static_cast<uint32_t>(mesh.vertices.size());
+  this->all_radii[mesh_id]                       = mesh.sphere_volume_radius;
+
+  this->draw_buffer->update(mesh.indices.data(), mesh.indices.size(), mesh.vertices.data(), mesh.vertices.size(), this->current_draw_buffer_index_count, this->current_draw_buffer_vertex_count);
+
+  this->current_draw_buffer_index_count  += mesh.indices.size();
+  this->current_draw_buffer_vertex_count += mesh.vertices.size();
+}
+
+static bool read_binary_file(const char* file_path, std::vector<uint8_t>& bytes) {
+  FILE* file = fopen(file_path, "rb");
+  if (file == nullptr) return false;
+
+  fseek(file, 0, SEEK_END);
+  bytes.resize(static_cast<size_t>(ftell(file)));
+  fseek(file, 0, SEEK_SET);
+  const size_t read_count = fread(bytes.data(), 1, bytes.size(), file);
+  fclose(file);
+
+  return read_count == bytes.size();
 }
 
 uint32_t upload_base_color_map_from_file(const char* file_path) {
   static tom::Semaphore semaphore{1};
-  static uint32_t current_texture_index = 0;
 
   semaphore.wait();
-  const uint32_t texture_index = current_texture_index;
-  vulkan_base_color_map_array->upload_texture_from_file(file_path, current_texture_index);
-  current_texture_index += 1;
+  const auto path_it = vulkan_texture_cache.file_path_to_texture_index.find(file_path);
+  if (path_it != vulkan_texture_cache.file_path_to_texture_index.end()) {
+    semaphore.signal();
+    return path_it->second;
+  }
+
+  std::vector<uint8_t> file_bytes;
+  const bool is_read = read_binary_file(file_path, file_bytes);
+  assert(is_read);
+
+  const uint64_t content_hash = tom::fnv1a(tom::fnv1a_offset_basis, file_bytes.data(), file_bytes.size());
+  const auto content_it = vulkan_texture_cache.content_hash_to_texture_index.find(content_hash);
+  uint32_t texture_index;
+  if (content_it != vulkan_texture_cache.content_hash_to_texture_index.end()) {
+    texture_index = content_it->second;
+  } else {
+    texture_index = vulkan_texture_cache.current_texture_index;
+    assert(texture_index < VkTextureCache::max_texture_count);
+
+    TextureAtlas::Rect&  rect = vulkan_texture_cache.texture_rects[texture_index];
+    std::vector<uint8_t> mip_levels;
+    const bool is_packed = vulkan_texture_cache.atlas.add_texture_from_file_bytes(file_bytes.data(), file_bytes.size(), rect, mip_levels);
+    assert(is_packed);
+    vulkan_base_color_map_array->upload_atlas_texture(rect, mip_levels);
+
+    const TextureAtlas& atlas            = vulkan_texture_cache.atlas;
+    const double        bytes_per_mib    = 1024.0 * 1024.0;
+    const uint64_t      layer_byte_count = calculate_texture_mip_chain_byte_count(1024, 1024, calculate_mip_level_count(1024, 1024));
+    DEBUG_LOG("base color atlas: %u textures use %.1f of %.1f MiB, a 1024x1024 layer each would use %.1f MiB\n", atlas.texture_count,
+              atlas.used_byte_count / bytes_per_mib, atlas.get_allocated_byte_count() / bytes_per_mib, (atlas.texture_count * layer_byte_count) / bytes_per_mib);
+
+    vulkan_texture_cache.current_texture_index += 1;
+    vulkan_texture_cache.content_hash_to_texture_index[content_hash] = texture_index;
+  }
+  vulkan_texture_cache.file_path_to_texture_index[file_path] = texture_index;
   semaphore.signal();
 
   return texture_index;
@@ -1758,6 +1787,7 @@ void create_graphics_mesh_instance_array_from_glb(const char* file_path, Graphic
   // HACK: assuming model has all unique meshes (no instancing) and if eventually handle instancing case then make sure mesh_hierarchy works
   mesh_instance_array.first_mesh_instance = graphics_all_mesh_instances.allocate_mesh_instances(source_file_id_data.mesh_count);
   mesh_instance_array.size                = source_file_id_data.mesh_count;
+  mesh_instance_array.generation          = graphics_all_mesh_instances.ranges.generations[mesh_instance_array.first_mesh_instance];
 
   uint32_t current_mesh_instance_index = mesh_instance_array.first_mesh_instance;
   for (uint32_t i=0; i < source_file_id_data.mesh_count; ++i) {
@@ -1766,7 +1796,39 @@ void create_graphics_mesh_instance_array_from_glb(const char* file_path, Graphic
   }
 }
 
+void create_graphics_static_batch_from_glb(const char* file_path, const GraphicsStaticInstance* const instances, const uint32_t instance_count, const uint32_t instances_per_chunk, GraphicsMeshInstanceArray& mesh_instance_array) {
+  GraphicsModel model;
+  graphics_load_glb_model_from_file(file_path, model);
+  const uint32_t mesh_count  = static_cast<uint32_t>(model.meshes.size());
+  const uint32_t chunk_count = (instance_count + (instances_per_chunk - 1)) / instances_per_chunk;
+
+  mesh_instance_array.first_mesh_instance = graphics_all_mesh_instances.allocate_mesh_instances(chunk_count * mesh_count);
+  mesh_instance_array.size                = chunk_count * mesh_count;
+  mesh_instance_array.generation          = graphics_all_mesh_instances.ranges.generations[mesh_instance_array.first_mesh_instance];
+
+  GraphicsMesh merged_mesh;
+  Vector3f     merged_mesh_center;
+  for (uint32_t mesh_index=0; mesh_index < mesh_count; ++mesh_index) {
+    GraphicsMesh optimized_mesh;
+    graphics_deduplicate_vertices(model.meshes[mesh_index], optimized_mesh);
+
+    for (uint32_t chunk_index=0; chunk_index < chunk_count; ++chunk_index) {
+      const uint32_t first_instance = chunk_index * instances_per_chunk;
+      merge_graphics_static_mesh(optimized_mesh, instances + first_instance, std::min(instances_per_chunk, instance_count - first_instance), merged_mesh, merged_mesh_center);
+      if (!vulkan_all_meshes.has_room_for(merged_mesh)) {  // checked in release builds too since writing past the draw buffer corrupts what follows it
+        DEBUG_LOG("static batch of %s: %zu vertices and %zu indices don't fit in the draw buffer\n", file_path, merged_mesh.vertices.size(), merged_mesh.indices.size());
+        abort();
+      }
+
+      const uint32_t index = (chunk_index * mesh_count) + mesh_index;
+      graphics_all_mesh_instances.mesh_ids[mesh_instance_array.first_mesh_instance + index] = vulkan_all_meshes.insert_mesh(merged_mesh);
+      update_graphics_mesh_instance_array(mesh_instance_array, { merged_mesh_center, identity_orientation, default_scale }, instances[first_instance].material_id, uint32_t(-1), index);
+    }
+  }
+}
+
 void update_graphics_mesh_instance_array(const GraphicsMeshInstanceArray& mesh_instance_array, const Transform& transform, const uint32_t material_id, const uint32_t joint_index, const uint32_t index) {
+  assert(graphics_all_mesh_instances.ranges.is_current(mesh_instance_array.first_mesh_instance, mesh_instance_array.generation));
   GraphicsMeshInstances::BufferData instance(transform, material_id, joint_index);
 
   const float mesh_radius = vulkan_all_meshes.all_radii[ graphics_all_mesh_instances.mesh_ids[mesh_instance_array.first_mesh_instance + index] ];
@@ -1790,29 +1852,33 @@ void destroy_graphics_mesh_instance_array(GraphicsMeshInstanceArray& mesh_instan
     graphics_all_mesh_instances.mesh_ids[current_mesh_instance_index] = -1;
     ++current_mesh_instance_index;
   }
+  graphics_all_mesh_instances.free_mesh_instances(mesh_instance_array.first_mesh_instance);
 
   mesh_instance_array.first_mesh_instance = -1;
 }
 
 void graphics_upload_materials(GraphicsMaterial* const materials, const uint32_t count, const uint32_t start_index) {
-  memcpy(static_cast<GraphicsMaterial*>(vulkan_material_uniform_buffer->mapped_memory) + start_index, materials, sizeof(GraphicsMaterial) * count);
+  assert( (start_index + count) <= vulkan_all_materials.max_count );
+  memcpy(static_cast<GraphicsMaterial*>(vulkan_material_storage_buffer->mapped_memory) + start_index, materials, sizeof(GraphicsMaterial) * count);
 }
 
 uint32_t create_graphics_material(const Vector4f& base_color_factor, const Vector3f& emissive_factor, const float metallic_factor, const float roughness_factor, const char* base_color_map_file_path) {
   static tom::Semaphore semaphore{1};
-  static uint32_t current_material_index = 0;
-
-  semaphore.wait();
-  assert(current_material_index < MaterialUniformBufferObject::max_count);
-  const uint32_t material_id = current_material_index;
-  ++current_material_index;
 
   GraphicsMaterial material{ base_color_factor, emissive_factor, metallic_factor, roughness_factor, static_cast<uint32_t>(-1) };
   if (base_color_map_file_path != nullptr) {
-    material.base_color_map_index = upload_base_color_map_from_file(base_color_map_file_path);
+    const uint32_t             texture_index = upload_base_color_map_from_file(base_color_map_file_path);
+    const TextureAtlas::Rect&  rect          = vulkan_texture_cache.texture_rects[texture_index];
+    const TextureAtlas::UvRect uv_rect       = vulkan_texture_cache.atlas.get_uv_rect(rect);
+    material.base_color_map_index   = rect.page_index;
+    material.base_color_map_uv_rect = { uv_rect.offset_u, uv_rect.offset_v, uv_rect.scale_u, uv_rect.scale_v };
   }
-  graphics_upload_materials(&material, 1, material_id);
-  semaphore.signal(); // maybe signal after incrementing material_index?
+
+  semaphore.wait();
+  const uint32_t material_id = find_or_add_graphics_material(vulkan_all_materials.materials, material);
+  assert(material_id < vulkan_all_materials.max_count);
+  if (material_id == (vulkan_all_materials.materials.size() - 1)) graphics_upload_materials(&material, 1, material_id);
+  semaphore.signal();
 
   return material_id;
 }
@@ -1904,6 +1970,7 @@ void create_graphics_skeleton_instance_array_from_glb(const char* file_path, Gra
 
   skeleton_instance_array.first_skeleton_instance = graphics_all_skeleton_instances.allocate_skeleton_instances(total_joint_count);
   skeleton_instance_array.size                    = source_file_id_data.skeleton_count;
+  skeleton_instance_array.generation              = graphics_all_skeleton_instances.ranges.generations[skeleton_instance_array.first_skeleton_instance];
 
   uint32_t current_skeleton_instance_index = skeleton_instance_array.first_skeleton_instance;
   for (uint32_t i=0; i < source_file_id_data.skeleton_count; ++i) {
@@ -1923,6 +1990,7 @@ void destroy_graphics_skeleton_instance_array(GraphicsSkeletonInstanceArray& ske
   }
 
   memset(&graphics_all_skeleton_instances.skeleton_ids[skeleton_instance_array.first_skeleton_instance], VkSkeletons::Index(-1), total_joint_count * sizeof(graphics_all_skeleton_instances.skeleton_ids[0]));
+  if (skeleton_instance_array.size > 0) graphics_all_skeleton_instances.free_skeleton_instances(skeleton_instance_array.first_skeleton_instance);
   skeleton_instance_array.first_skeleton_instance = -1;
 }
 
@@ -2206,8 +2274,8 @@ bool init_graphics() {
     current_vk_result = vkCreateCommandPool(vulkan_logical_device, &tmp_command_pool_info, nullptr, &vulkan_temporary_command_pool);
   }
 
-  const size_t draw_buffer_indices_count  = 131072;
-  const size_t draw_buffer_vertices_count = 131072;
+  const size_t draw_buffer_indices_count  = 262144;  // room for the board's static batches
+  const size_t draw_buffer_vertices_count = draw_buffer_indices_count;  // a deduplicated mesh never has more vertices than indices so merged batches run out of indices first
   VkVertexBuffer* vertex_buffer           = new VkVertexBuffer;
   vulkan_all_meshes.draw_buffer = create_vk_vertex_buffer(draw_buffer_indices_count, draw_buffer_vertices_count, vertex_buffer);
   vulkan_all_meshes.source_file_path_to_id_data.reserve(VkMeshes::max_count);
@@ -2229,15 +2297,19 @@ bool init_graphics() {
 
   // if cannot use SRGB format for base color then need to handle gamma correction in fragment shaders
   vulkan_base_color_map_array = new VkTextureArray;
-  create_vk_texture_array(VK_FORMAT_R8G8B8A8_SRGB, 1024, 1024, calculate_mip_level_count(1024,1024), 16, vulkan_base_color_map_array);
+  // base color textures keep their own sizes packed into the pages of an atlas, a page fits four 1024x1024 textures with their padding
+  constexpr uint32_t base_color_atlas_page_size  = 2 * (1024 + (2 * TextureAtlas::padding));
+  constexpr uint32_t base_color_atlas_page_count = 2;
+  create_vk_texture_array(VK_FORMAT_R8G8B8A8_SRGB, base_color_atlas_page_size, base_color_atlas_page_size, TextureAtlas::mip_level_count, base_color_atlas_page_count, vulkan_base_color_map_array);
+  vulkan_texture_cache.atlas.init(base_color_atlas_page_size, base_color_atlas_page_size, base_color_atlas_page_count);
 
   {
     VkSamplerCreateInfo sampler_info{VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO};
     sampler_info.magFilter               = VK_FILTER_LINEAR;
     sampler_info.minFilter               = VK_FILTER_LINEAR;
-    sampler_info.addressModeU            = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-    sampler_info.addressModeV            = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-    sampler_info.addressModeW            = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    sampler_info.addressModeU            = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;  // atlas textures repeat in the fragment shader
+    sampler_info.addressModeV            = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    sampler_info.addressModeW            = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
     sampler_info.anisotropyEnable        = VK_TRUE;
     sampler_info.maxAnisotropy           = vulkan_texture_sampler_max_anisotropy;
     sampler_info.borderColor             = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
@@ -2258,8 +2330,11 @@ bool init_graphics() {
       create_vk_uniform_buffer<SkeletonInstanceUniformBufferObject>(vulkan_skeleton_instance_uniform_buffers[i]);
     }
 
-    vulkan_material_uniform_buffer = new VkUniformBuffer;
-    create_vk_uniform_buffer<MaterialUniformBufferObject>(vulkan_material_uniform_buffer);
+    const uint32_t max_material_count = 256;  // the storage buffer has no fixed size in the fragment shader
+    vulkan_all_materials.max_count = max_material_count;
+    vulkan_all_materials.materials.reserve(max_material_count);
+    vulkan_material_storage_buffer = new VkUniformBuffer;
+    create_vk_storage_buffer(sizeof(GraphicsMaterial) * max_material_count, vulkan_material_storage_buffer);
   }
 
   {
@@ -2280,7 +2355,7 @@ bool init_graphics() {
     VkDescriptorSetLayoutBinding material_uniform_buffer_layout_binding{};
     material_uniform_buffer_layout_binding.binding            = 2;
     material_uniform_buffer_layout_binding.descriptorCount    = 1;
-    material_uniform_buffer_layout_binding.descriptorType     = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    material_uniform_buffer_layout_binding.descriptorType     = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
     material_uniform_buffer_layout_binding.pImmutableSamplers = nullptr;
     material_uniform_buffer_layout_binding.stageFlags         = VK_SHADER_STAGE_FRAGMENT_BIT;
 
@@ -2299,8 +2374,9 @@ bool init_graphics() {
     current_vk_result = vkCreateDescriptorSetLayout(vulkan_logical_device, &descriptor_set_layout_info, nullptr, &vulkan_descriptor_set_layout);
 
     VkDescriptorPoolSize combined_image_sampler_descriptor_pool_size{ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 2 }; // one sampler per frame in flight
-    VkDescriptorPoolSize uniform_buffer_descriptor_pool_size{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 6 }; // (material buffer + global buffer + joint buffer) per frame in flight
-    VkDescriptorPoolSize descriptor_pool_sizes[] = { combined_image_sampler_descriptor_pool_size, uniform_buffer_descriptor_pool_size };
+    VkDescriptorPoolSize uniform_buffer_descriptor_pool_size{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 4 }; // (global buffer + joint buffer) per frame in flight
+    VkDescriptorPoolSize storage_buffer_descriptor_pool_size{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2 }; // material buffer per frame in flight
+    VkDescriptorPoolSize descriptor_pool_sizes[] = { combined_image_sampler_descriptor_pool_size, uniform_buffer_descriptor_pool_size, storage_buffer_descriptor_pool_size };
 
     VkDescriptorPoolCreateInfo descriptor_pool_info{VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
     descriptor_pool_info.poolSizeCount = static_cast<uint32_t>(std::size(descriptor_pool_sizes));
@@ -2332,9 +2408,9 @@ bool init_graphics() {
     descriptor_global_uniform_buffer_info.range  = sizeof(GlobalUniformBufferObject);
 
     VkDescriptorBufferInfo descriptor_material_uniform_buffer_info{};
-    descriptor_material_uniform_buffer_info.buffer = vulkan_material_uniform_buffer->buffer;
+    descriptor_material_uniform_buffer_info.buffer = vulkan_material_storage_buffer->buffer;
     descriptor_material_uniform_buffer_info.offset = 0;
-    descriptor_material_uniform_buffer_info.range  = sizeof(MaterialUniformBufferObject);
+    descriptor_material_uniform_buffer_info.range  = sizeof(GraphicsMaterial) * vulkan_all_materials.max_count;
 
     VkDescriptorBufferInfo descriptor_joint_uniform_buffer_info{};
     descriptor_joint_uniform_buffer_info.buffer = vulkan_skeleton_instance_uniform_buffers[i]->buffer;
@@ -2361,7 +2437,7 @@ bool init_graphics() {
     material_uniform_buffer_descriptor_write.dstSet          = vulkan_descriptor_sets[i];
     material_uniform_buffer_descriptor_write.dstBinding      = 2;
     material_uniform_buffer_descriptor_write.dstArrayElement = 0;
-    material_uniform_buffer_descriptor_write.descriptorType  = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    material_uniform_buffer_descriptor_write.descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
     material_uniform_buffer_descriptor_write.descriptorCount = 1;
     material_uniform_buffer_descriptor_write.pBufferInfo     = &descriptor_material_uniform_buffer_info;
 
@@ -2390,7 +2466,7 @@ void deactivate_graphics() {
     destroy_vk_uniform_buffer(vulkan_global_uniform_buffers[i]);
     destroy_vk_uniform_buffer(vulkan_skeleton_instance_uniform_buffers[i]);
   }
-  destroy_vk_uniform_buffer(vulkan_material_uniform_buffer);
+  destroy_vk_uniform_buffer(vulkan_material_storage_buffer);
 
   vkDestroyDescriptorPool(vulkan_logical_device, vulkan_descriptor_pool, nullptr);
 
@@ -2610,8 +2686,12 @@ void vulkan_render_xr_views(const std::vector<XrCompositionLayerProjectionView>&
   std::bitset<VkMeshes::max_count> is_mesh_draw_call_created_bits;
   VkIndexedDrawCall current_draw_call;
 
-  for (uint32_t i=0; i < GraphicsMeshInstances::max_count; ++i) {
-    const uint32_t current_mesh_id = graphics_render_thread_sim_state.mesh_instances.mesh_ids[i];
+  const GraphicsMeshInstances& mesh_instances = graphics_render_thread_sim_state.mesh_instances;
+  static GraphicsMeshInstances::DrawData active_global_draw_data[GraphicsMeshInstances::max_count];
+  mesh_instances.get_active_global_draw_data(active_global_draw_data);
+
+  for (uint32_t i=0; i < mesh_instances.active_count; ++i) {
+    const uint32_t current_mesh_id = mesh_instances.mesh_ids[mesh_instances.active_ids[i]];
     if (current_mesh_id == VkMeshes::Index(-1)) {
       continue;
     }
@@ -2626,9 +2706,10 @@ void vulkan_render_xr_views(const std::vector<XrCompositionLayerProjectionView>&
       current_draw_call.vertex_offset  = current_mesh_hot_data.first_vertex;
       current_draw_call.first_instance = current_instance_offset;
 
-      for (uint32_t current_mesh_instance_index=i; current_mesh_instance_index < GraphicsMeshInstances::max_count; ++current_mesh_instance_index) {
-        if (current_mesh_id == graphics_render_thread_sim_state.mesh_instances.mesh_ids[current_mesh_instance_index]) {
-          const GraphicsMeshInstances::DrawData& draw_data = graphics_render_thread_sim_state.mesh_instances.draw_data[current_mesh_instance_index];
+      for (uint32_t active_index=i; active_index < mesh_instances.active_count; ++active_index) {
+        const uint32_t current_mesh_instance_index = mesh_instances.active_ids[active_index];
+        if (current_mesh_id == mesh_instances.mesh_ids[current_mesh_instance_index]) {
+          const GraphicsMeshInstances::DrawData& draw_data = active_global_draw_data[active_index];
 
           if (is_sphere_volume_visible(draw_data.cull_data.position,draw_data.cull_data.radius,camera_frustums[0]) || is_sphere_volume_visible(draw_data.cull_data.position,draw_data.cull_data.radius,camera_frustums[1])) {
             vulkan_instance_buffers[current_frame]->update(&draw_data.buffer_data, 1, current_draw_call.first_instance + current_draw_call.instance_count);
@@ -2691,7 +2772,7 @@ void vulkan_render_xr_views(const std::vector<XrCompositionLayerProjectionView>&
 }
 
 uint32_t get_max_material_count() {
-  return MaterialUniformBufferObject::max_count;
+  return vulkan_all_materials.max_count;
 }
 
 void update_ambient_light_intensity(const float intensity) {
@@ -2699,7 +2780,7 @@ void update_ambient_light_intensity(const float intensity) {
 }
 
 void AnimationState::tick_time() {
-  this->time_seconds += delta_time_seconds * this->speed_factor * static_cast<float>(this->animation_id != uint32_t(-1));
+  this->time_seconds += frame_delta_time_seconds * this->speed_factor * static_cast<float>(this->animation_id != uint32_t(-1));
 
   const Animation& animation   = vulkan_all_animations.animations[this->animation_id];
   const bool is_animation_over = this->time_seconds > animation.end_time_seconds;
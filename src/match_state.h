@@ -0,0 +1,301 @@
+#ifndef INCLUDE_TOM_ENGINE_MATCH_STATE_H
+#define INCLUDE_TOM_ENGINE_MATCH_STATE_H
+
+#include "tom_std.h"
+#include <cstdint>
+#include <type_traits>
+
+// a match reduced to plain values so AI lookahead can copy it and play it forward without graphics, audio, pointers or allocations
+// a step is the time a player takes to cross a tile, players move a whole tile per step
+struct MatchState {
+  enum class TileState : uint8_t { Stone, Brick, Bomb, Fire, Empty };                     // same order as Board::TileState
+  enum class Action : uint8_t { MoveDown, MoveUp, MoveRight, MoveLeft, Wait, PlaceBomb };  // moves in Bomberman::GlobalDirection order
+  static constexpr uint32_t action_count     = 6;
+  static constexpr uint32_t max_tile_count   = 256;
+  static constexpr uint32_t max_player_count = 8;
+  static constexpr uint32_t no_tile          = -1;
+
+  uint16_t  column_count;
+  uint16_t  row_count;
+  uint16_t  tile_count;
+  uint16_t  brick_count;
+  uint8_t   player_count;
+  uint8_t   alive_player_bits;
+  uint8_t   blast_radius_tiles;
+  uint8_t   bomb_fuse_steps;      // a new bomb goes off after this many steps
+  uint8_t   fire_steps;
+  uint8_t   bomb_cooldown_steps;  // steps before a player can place another bomb
+  uint32_t  step_count;
+  TileState tile_states[max_tile_count];
+  uint8_t   remaining_fuse_steps[max_tile_count];  // of the bomb on the tile
+  uint8_t   remaining_fire_steps[max_tile_count];
+  uint16_t  player_tile_indexes[max_player_count];
+  uint8_t   player_cooldown_steps[max_player_count];
+
+  bool is_player_alive(const uint32_t player_index) const { return (alive_player_bits >> player_index) & 1; }
+  bool is_tile_occupied(const uint32_t tile_index) const;  // by a player that is alive
+  uint32_t get_neighbour_tile_index(const uint32_t tile_index, const Action move) const;  // no_tile off the board
+  uint64_t compute_checksum() const;  // over the values in use only so padding and tiles past tile_count don't matter
+};
+
+static_assert(std::is_trivially_copyable_v<MatchState>, "MatchState is copied by value for every rollout");
+
+// the 13x11 floor of a default 15x13 board with 4 players in the corners, laid out like Board::reset_tile_states from random seeded with seed
+void init_default_match_state(MatchState& state, const uint64_t seed);
+
+bool is_match_action_valid(const MatchState& state, const uint32_t player_index, const MatchState::Action action);
+void step_match(MatchState& state, const MatchState::Action* const actions);  // one action per player, a dead player's is ignored
+
+// a cheap policy for the steps after the first: random among the valid actions but never onto a tile a blast reaches next step
+MatchState::Action choose_rollout_action(const MatchState& state, const uint32_t player_index, tom::Random& random);
+
+// flat monte carlo, every valid action is played rollout_count times and followed by depth_steps - 1 steps of rollout actions for everyone,
+// the action with the best total score wins, step_count is increased by the number of steps played
+MatchState::Action choose_match_action_by_rollouts(const MatchState& state, const uint32_t player_index, const uint32_t rollout_count, const uint32_t depth_steps, tom::Random& random, uint64_t& step_count);
+
+#endif  // INCLUDE_TOM_ENGINE_MATCH_STATE_H
+
+//////////////////////////////////////////////////
+
+#ifdef  TOM_ENGINE_MATCH_STATE_IMPLEMENTATION
+#ifndef TOM_ENGINE_MATCH_STATE_IMPLEMENTATION_SINGLE
+#define TOM_ENGINE_MATCH_STATE_IMPLEMENTATION_SINGLE
+
+#include <bit>
+#include <cstdlib>
+#include <cstring>
+
+void init_default_match_state(MatchState& state, const uint64_t seed) {
+  memset(&state, 0, sizeof(state));
+  state.column_count        = 13;
+  state.row_count           = 11;
+  state.tile_count          = state.column_count * state.row_count;
+  state.player_count        = 4;
+  state.alive_player_bits   = 0xf;
+  state.blast_radius_tiles  = 2;
+  state.bomb_fuse_steps     = 12;
+  state.fire_steps          = 4;
+  state.bomb_cooldown_steps = 12;
+
+  const uint16_t corner_tile_indexes[4] = { 0, static_cast<uint16_t>(state.column_count - 1), static_cast<uint16_t>(state.tile_count - state.column_count), static_cast<uint16_t>(state.tile_count - 1) };
+  tom::Random random;
+  random.seed(seed, 0);
+  for (uint32_t tile_index=0; tile_index < state.tile_count; ++tile_index) {
+    const uint32_t row_index    = tile_index / state.column_count;
+    const uint32_t column_index = tile_index % state.column_count;
+    bool is_spawn_space = false;  // a corner or next to one
+    for (const uint16_t corner_tile_index : corner_tile_indexes) {
+      const int32_t row_distance    = abs(int32_t(row_index) - int32_t(corner_tile_index / state.column_count));
+      const int32_t column_distance = abs(int32_t(column_index) - int32_t(corner_tile_index % state.column_count));
+      is_spawn_space |= (row_distance + column_distance) <= 1;
+    }
+
+    if ( (row_index & 1) && (column_index & 1) ) {
+      state.tile_states[tile_index] = MatchState::TileState::Stone;
+    } else if ( !is_spawn_space && (random.next_below(10) < 6) ) {
+      state.tile_states[tile_index] = MatchState::TileState::Brick;
+      ++state.brick_count;
+    } else {
+      state.tile_states[tile_index] = MatchState::TileState::Empty;
+    }
+  }
+  for (uint32_t i=0; i < 4; ++i) state.player_tile_indexes[i] = corner_tile_indexes[i];
+}
+
+bool MatchState::is_tile_occupied(const uint32_t tile_index) const {
+  for (uint32_t i=0; i < player_count; ++i) {
+    if ( is_player_alive(i) && (player_tile_indexes[i] == tile_index) ) return true;
+  }
+  return false;
+}
+
+uint64_t MatchState::compute_checksum() const {
+  const uint8_t counts[] = { player_count, alive_player_bits, blast_radius_tiles, bomb_fuse_steps, fire_steps, bomb_cooldown_steps };
+  uint64_t hash = tom::fnv1a_offset_basis;
+  hash = tom::fnv1a(hash, &column_count, sizeof(column_count));
+  hash = tom::fnv1a(hash, &row_count, sizeof(row_count));
+  hash = tom::fnv1a(hash, &brick_count, sizeof(brick_count));
+  hash = tom::fnv1a(hash, counts, sizeof(counts));
+  hash = tom::fnv1a(hash, &step_count, sizeof(step_count));
+  hash = tom::fnv1a(hash, tile_states, tile_count * sizeof(tile_states[0]));
+  hash = tom::fnv1a(hash, remaining_fuse_steps, tile_count * sizeof(remaining_fuse_steps[0]));
+  hash = tom::fnv1a(hash, remaining_fire_steps, tile_count * sizeof(remaining_fire_steps[0]));
+  hash = tom::fnv1a(hash, player_tile_indexes, player_count * sizeof(player_tile_indexes[0]));
+  hash = tom::fnv1a(hash, player_cooldown_steps, player_count * sizeof(player_cooldown_steps[0]));
+  return hash;
+}
+
+uint32_t MatchState::get_neighbour_tile_index(const uint32_t tile_index, const Action move) const {
+  const uint32_t row_index    = tile_index / column_count;
+  const uint32_t column_index = tile_index % column_count;
+  switch (move) {
+    case Action::MoveDown  : return (row_index == (row_count - 1u))       ? no_tile : tile_index + column_count;
+    case Action::MoveUp    : return (row_index == 0)                      ? no_tile : tile_index - column_count;
+    case Action::MoveRight : return (column_index == (column_count - 1u)) ? no_tile : tile_index + 1;
+    case Action::MoveLeft  : return (column_index == 0)                   ? no_tile : tile_index - 1;
+    default                : return no_tile;
+  }
+}
+
+bool is_match_action_valid(const MatchState& state, const uint32_t player_index, const MatchState::Action action) {
+  if (!state.is_player_alive(player_index)) return action == MatchState::Action::Wait;
+
+  const uint32_t tile_index = state.player_tile_indexes[player_index];
+  switch (action) {
+    case MatchState::Action::Wait      : return true;
+    case MatchState::Action::PlaceBomb : return (state.player_cooldown_steps[player_index] == 0) && (state.tile_states[tile_index] == MatchState::TileState::Empty);
+    default : {
+      const uint32_t neighbour_tile_index = state.get_neighbour_tile_index(tile_index, action);
+      return (neighbour_tile_index != MatchState::no_tile) && (state.tile_states[neighbour_tile_index] == MatchState::TileState::Empty) && !state.is_tile_occupied(neighbour_tile_index);
+    }
+  }
+}
+
+// the same rules as BombSystem: a blast stops before a stone and on the first brick, bomb or player, bombs it reaches go off in the same step
+static void detonate_match_bombs(MatchState& state, uint16_t* const detonating_tile_indexes, uint32_t detonating_count) {
+  auto explode_tile = [&](const uint32_t tile_index) {
+    if (state.tile_states[tile_index] == MatchState::TileState::Brick) {
+      --state.brick_count;
+    } else if ( (state.tile_states[tile_index] == MatchState::TileState::Bomb) && (state.remaining_fuse_steps[tile_index] > 0) ) {
+      state.remaining_fuse_steps[tile_index]      = 0;
+      detonating_tile_indexes[detonating_count++] = static_cast<uint16_t>(tile_index);
+    }
+    for (uint32_t i=0; i < state.player_count; ++i) {
+      if (state.player_tile_indexes[i] == tile_index) state.alive_player_bits &= ~static_cast<uint8_t>(1u << i);
+    }
+    state.tile_states[tile_index]          = MatchState::TileState::Fire;
+    state.remaining_fire_steps[tile_index] = state.fire_steps;
+  };
+
+  for (uint32_t i=0; i < detonating_count; ++i) {
+    const uint32_t tile_index = detonating_tile_indexes[i];
+    state.remaining_fuse_steps[tile_index] = 0;
+    explode_tile(tile_index);
+
+    for (uint32_t move=0; move < 4; ++move) {
+      uint32_t target_tile_index = tile_index;
+      for (uint32_t count=0; count < state.blast_radius_tiles; ++count) {
+        target_tile_index = state.get_neighbour_tile_index(target_tile_index, static_cast<MatchState::Action>(move));
+        if ( (target_tile_index == MatchState::no_tile) || (state.tile_states[target_tile_index] == MatchState::TileState::Stone) ) break;
+
+        const bool stops_blast = (state.tile_states[target_tile_index] == MatchState::TileState::Brick) || (state.tile_states[target_tile_index] == MatchState::TileState::Bomb) || state.is_tile_occupied(target_tile_index);
+        explode_tile(target_tile_index);
+        if (stops_blast) break;
+      }
+    }
+  }
+}
+
+void step_match(MatchState& state, const MatchState::Action* const actions) {
+  for (uint32_t i=0; i < state.player_count; ++i) {
+    if (!is_match_action_valid(state, i, actions[i]) || (actions[i] == MatchState::Action::Wait)) continue;
+
+    const uint32_t tile_index = state.player_tile_indexes[i];
+    if (actions[i] == MatchState::Action::PlaceBomb) {
+      state.tile_states[tile_index]          = MatchState::TileState::Bomb;
+      state.remaining_fuse_steps[tile_index] = state.bomb_fuse_steps;
+      state.player_cooldown_steps[i]         = state.bomb_cooldown_steps;
+    } else {
+      state.player_tile_indexes[i] = static_cast<uint16_t>(state.get_neighbour_tile_index(tile_index, actions[i]));
+    }
+  }
+  for (uint32_t i=0; i < state.player_count; ++i) {
+    state.player_cooldown_steps[i] -= static_cast<uint8_t>(state.player_cooldown_steps[i] > 0);
+  }
+
+  uint16_t detonating_tile_indexes[MatchState::max_tile_count];
+  uint32_t detonating_count = 0;
+  for (uint32_t tile_index=0; tile_index < state.tile_count; ++tile_index) {
+    if (state.tile_states[tile_index] == MatchState::TileState::Fire) {
+      if (--state.remaining_fire_steps[tile_index] == 0) state.tile_states[tile_index] = MatchState::TileState::Empty;
+    } else if (state.tile_states[tile_index] == MatchState::TileState::Bomb) {
+      if (--state.remaining_fuse_steps[tile_index] == 0) detonating_tile_indexes[detonating_count++] = static_cast<uint16_t>(tile_index);
+    }
+  }
+  detonate_match_bombs(state, detonating_tile_indexes, detonating_count);
+
+  ++state.step_count;
+}
+
+// a bomb that goes off next step reaches the tile, or it is burning
+static bool is_match_tile_threatened(const MatchState& state, const uint32_t tile_index) {
+  if (state.tile_states[tile_index] == MatchState::TileState::Fire) return false;  // the fire dies down before anyone can step onto it
+  if ( (state.tile_states[tile_index] == MatchState::TileState::Bomb) && (state.remaining_fuse_steps[tile_index] <= 1) ) return true;
+
+  for (uint32_t move=0; move < 4; ++move) {
+    uint32_t source_tile_index = tile_index;
+    for (uint32_t count=0; count < state.blast_radius_tiles; ++count) {
+      source_tile_index = state.get_neighbour_tile_index(source_tile_index, static_cast<MatchState::Action>(move));
+      if ( (source_tile_index == MatchState::no_tile) || (state.tile_states[source_tile_index] == MatchState::TileState::Stone) || (state.tile_states[source_tile_index] == MatchState::TileState::Brick) ) break;
+      if (state.tile_states[source_tile_index] == MatchState::TileState::Bomb) {
+        if (state.remaining_fuse_steps[source_tile_index] <= 1) return true;
+        break;
+      }
+    }
+  }
+  return false;
+}
+
+MatchState::Action choose_rollout_action(const MatchState& state, const uint32_t player_index, tom::Random& random) {
+  MatchState::Action safe_actions[MatchState::action_count];
+  MatchState::Action valid_actions[MatchState::action_count];
+  uint32_t safe_count  = 0;
+  uint32_t valid_count = 0;
+
+  const uint32_t tile_index = state.player_tile_indexes[player_index];
+  for (uint32_t i=0; i < MatchState::action_count; ++i) {
+    const MatchState::Action action = static_cast<MatchState::Action>(i);
+    if (!is_match_action_valid(state, player_index, action)) continue;
+
+    valid_actions[valid_count++] = action;
+    const uint32_t destination_tile_index = (i < 4) ? state.get_neighbour_tile_index(tile_index, action) : tile_index;
+    if (!is_match_tile_threatened(state, destination_tile_index)) safe_actions[safe_count++] = action;
+  }
+
+  if (safe_count > 0) return safe_actions[random.next_below(safe_count)];
+  return valid_actions[random.next_below(valid_count)];  // waiting is always valid
+}
+
+MatchState::Action choose_match_action_by_rollouts(const MatchState& state, const uint32_t player_index, const uint32_t rollout_count, const uint32_t depth_steps, tom::Random& random, uint64_t& step_count) {
+  constexpr int32_t survival_score = 100;  // staying alive outweighs everything else
+  constexpr int32_t opponent_score = 10;
+  constexpr int32_t brick_score    = 1;
+
+  const uint32_t root_opponent_count = std::popcount(static_cast<uint32_t>(state.alive_player_bits & ~(1u << player_index)));
+  MatchState::Action best_action     = MatchState::Action::Wait;
+  int64_t best_total_score           = INT64_MIN;
+  MatchState::Action actions[MatchState::max_player_count];
+
+  const uint32_t action_offset = random.next_below(MatchState::action_count);  // ties go to a random action
+  for (uint32_t i=0; i < MatchState::action_count; ++i) {
+    const MatchState::Action root_action = static_cast<MatchState::Action>((i + action_offset) % MatchState::action_count);
+    if (!is_match_action_valid(state, player_index, root_action)) continue;
+
+    int64_t total_score = 0;
+    for (uint32_t rollout_index=0; rollout_index < rollout_count; ++rollout_index) {
+      MatchState rollout_state = state;
+      for (uint32_t depth=0; (depth < depth_steps) && rollout_state.is_player_alive(player_index); ++depth) {
+        for (uint32_t j=0; j < rollout_state.player_count; ++j) {
+          actions[j] = rollout_state.is_player_alive(j) ? choose_rollout_action(rollout_state, j, random) : MatchState::Action::Wait;
+        }
+        if (depth == 0) actions[player_index] = root_action;
+        step_match(rollout_state, actions);
+        ++step_count;
+      }
+
+      const uint32_t opponent_count = std::popcount(static_cast<uint32_t>(rollout_state.alive_player_bits & ~(1u << player_index)));
+      total_score += (survival_score * static_cast<int32_t>(rollout_state.is_player_alive(player_index))) +
+                     (opponent_score * static_cast<int32_t>(root_opponent_count - opponent_count)) +
+                     (brick_score * static_cast<int32_t>(state.brick_count - rollout_state.brick_count));
+    }
+
+    if (total_score > best_total_score) {
+      best_total_score = total_score;
+      best_action      = root_action;
+    }
+  }
+  return best_action;
+}
+
+#endif  // TOM_ENGINE_MATCH_STATE_IMPLEMENTATION_SINGLE
+#endif  // TOM_ENGINE_MATCH_STATE_IMPLEMENTATION
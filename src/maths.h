@@ -59,7 +59,9 @@ void translate_transform_global(Transform& transform, Vector3f& translation);
 void translate_transform_local(Transform& transform, Vector3f& local_translation);
 void scale_transform(Transform& transform, Vector3f& scale);
 void scale_transform(Transform& transform, float scale_factor);
+#if !(defined(__GLIBCXX__) && (__cplusplus > 201703L))  // libstdc++ already declares std::lerp in the global namespace for C++20
 float lerp(const float start, const float end, const float interpolate_amount);
+#endif
 void create_matrix(float* array_of_16_floats, Matrix4x4f& matrix);
 void create_transform(Matrix4x4f& matrix, Transform& transform);
 void combine_transform(const Transform& transformation, Transform& current);
@@ -251,9 +253,11 @@ void inverse_quaternion(Quaternionf& quat) {
   *glm_quat = glm::inverse(*glm_quat);
 }
 
+#if !(defined(__GLIBCXX__) && (__cplusplus > 201703L))
 float lerp(const float start, const float end, const float interpolate_amount) {
   return glm::mix(start, end, interpolate_amount);
 }
+#endif
 
 Vector3f lerp(Vector3f& start, Vector3f& end, const float interpolate_amount) {
   glm::vec3* glm_start = reinterpret_cast<glm::vec3*>(&start);
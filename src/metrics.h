@@ -0,0 +1,199 @@
+#ifndef INCLUDE_TOM_ENGINE_METRICS_H
+#define INCLUDE_TOM_ENGINE_METRICS_H
+
+#include <cstdint>
+#include <cstddef>
+#include <fstream>
+
+struct FrameTimingSample {
+  float sim_update_milliseconds;
+  float render_sync_wait_milliseconds;    // time platform_render_frame waits for the render thread to finish the previous frame
+  float render_thread_cpu_milliseconds;   // cpu time of the render thread's most recently finished frame
+  float xr_wait_frame_milliseconds;       // time blocked in xrWaitFrame
+  float frame_milliseconds;               // total main loop time
+  float predicted_display_period_milliseconds;
+  int64_t predicted_display_time_nanoseconds;
+  bool should_render;
+};
+
+struct RollingHistogram {
+  static constexpr uint32_t window_size = 512;  // about 5 seconds at 90 Hz
+
+  struct Summary {
+    float p50;
+    float p90;
+    float p99;
+    float max;
+  };
+
+  float    values[window_size];
+  uint32_t count      = 0;
+  uint32_t next_index = 0;
+
+  void add(const float value);
+  Summary summarize() const;
+  void reset();
+};
+
+struct FrameMetrics {
+  enum Metric : uint32_t { SimUpdate, RenderSyncWait, RenderThreadCpu, XrWaitFrame, Frame, MetricCount };
+  static constexpr const char* metric_names[MetricCount] = { "sim", "sync", "render", "xr_wait", "frame" };
+  static constexpr float summary_interval_seconds        = 5.0f;
+  static constexpr float missed_deadline_threshold       = 1.5f;  // in display periods
+
+  RollingHistogram histograms[MetricCount];
+  uint64_t frame_count                       = 0;
+  uint64_t missed_display_deadline_count     = 0;
+  uint64_t skipped_render_count              = 0;
+  int64_t  previous_display_time_nanoseconds = 0;
+  float    predicted_display_period_milliseconds = 0.0f;
+  float    seconds_since_summary             = 0.0f;
+  std::ofstream csv_file;
+
+  bool record_frame(const FrameTimingSample& sample);  // returns true when a periodic summary is due
+  int  write_summary(char* buffer, const size_t buffer_size) const;
+  bool open_csv(const char* file_path);
+  void close_csv();
+  void reset();
+};
+
+uint64_t get_thread_cpu_time_nanoseconds();
+
+extern FrameMetrics      frame_metrics;
+extern FrameTimingSample frame_timing_sample;  // filled in by the platform layer each frame
+
+#endif  // INCLUDE_TOM_ENGINE_METRICS_H
+
+//////////////////////////////////////////////////
+
+#ifdef  TOM_ENGINE_METRICS_IMPLEMENTATION
+#ifndef TOM_ENGINE_METRICS_IMPLEMENTATION_SINGLE
+#define TOM_ENGINE_METRICS_IMPLEMENTATION_SINGLE
+
+#include <algorithm>
+#include <cstdio>
+#include <cmath>
+
+#if defined(OCULUS_PC)
+  #include <windows.h>
+#else
+  #include <time.h>
+#endif
+
+FrameMetrics      frame_metrics;
+FrameTimingSample frame_timing_sample = {};
+
+uint64_t get_thread_cpu_time_nanoseconds() {
+  #if defined(OCULUS_PC)
+  FILETIME creation_time, exit_time, kernel_time, user_time;
+  GetThreadTimes(GetCurrentThread(), &creation_time, &exit_time, &kernel_time, &user_time);
+  const uint64_t kernel_100_nanoseconds = (uint64_t(kernel_time.dwHighDateTime) << 32) | kernel_time.dwLowDateTime;
+  const uint64_t user_100_nanoseconds   = (uint64_t(user_time.dwHighDateTime) << 32) | user_time.dwLowDateTime;
+  return (kernel_100_nanoseconds + user_100_nanoseconds) * 100;
+  #else
+  timespec time;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+  return (uint64_t(time.tv_sec) * 1000000000ull) + uint64_t(time.tv_nsec);
+  #endif
+}
+
+void RollingHistogram::add(const float value) {
+  values[next_index] = value;
+  next_index = (next_index + 1) % window_size;
+  count      = std::min(count + 1, window_size);
+}
+
+RollingHistogram::Summary RollingHistogram::summarize() const {
+  if (count == 0) return {0.0f, 0.0f, 0.0f, 0.0f};
+
+  float sorted_values[window_size];
+  std::copy(values, values + count, sorted_values);
+  std::sort(sorted_values, sorted_values + count);
+
+  // nearest-rank percentiles
+  auto percentile = [&](const float fraction) {
+    const uint32_t rank = static_cast<uint32_t>(std::ceil(fraction * static_cast<float>(count)));
+    return sorted_values[std::max(rank, 1u) - 1];
+  };
+
+  return { percentile(0.5f), percentile(0.9f), percentile(0.99f), sorted_values[count - 1] };
+}
+
+void RollingHistogram::reset() {
+  count      = 0;
+  next_index = 0;
+}
+
+bool FrameMetrics::record_frame(const FrameTimingSample& sample) {
+  histograms[SimUpdate].add(sample.sim_update_milliseconds);
+  histograms[RenderSyncWait].add(sample.render_sync_wait_milliseconds);
+  histograms[RenderThreadCpu].add(sample.render_thread_cpu_milliseconds);
+  histograms[XrWaitFrame].add(sample.xr_wait_frame_milliseconds);
+  histograms[Frame].add(sample.frame_milliseconds);
+
+  predicted_display_period_milliseconds = sample.predicted_display_period_milliseconds;
+  skipped_render_count += static_cast<uint64_t>(!sample.should_render);
+
+  // the runtime skips ahead by whole display periods when a deadline is missed
+  if ( (previous_display_time_nanoseconds != 0) && (sample.predicted_display_period_milliseconds > 0.0f) ) {
+    const float display_time_delta_milliseconds = static_cast<float>(sample.predicted_display_time_nanoseconds - previous_display_time_nanoseconds) / 1000000.0f;
+    const float elapsed_periods                 = display_time_delta_milliseconds / sample.predicted_display_period_milliseconds;
+    if (elapsed_periods >= missed_deadline_threshold) {
+      missed_display_deadline_count += static_cast<uint64_t>(std::lround(elapsed_periods)) - 1;
+    }
+  }
+  previous_display_time_nanoseconds = sample.predicted_display_time_nanoseconds;
+
+  if (csv_file.is_open()) {
+    char line[256];
+    const int length = snprintf(line, sizeof(line), "%llu,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%d\n", static_cast<unsigned long long>(frame_count), sample.sim_update_milliseconds, sample.render_sync_wait_milliseconds,
+                                sample.render_thread_cpu_milliseconds, sample.xr_wait_frame_milliseconds, sample.frame_milliseconds, sample.predicted_display_period_milliseconds, static_cast<int>(sample.should_render));
+    csv_file.write(line, std::min(length, int(sizeof(line) - 1)));
+  }
+
+  ++frame_count;
+  seconds_since_summary += sample.frame_milliseconds / 1000.0f;
+  if (seconds_since_summary >= summary_interval_seconds) {
+    seconds_since_summary = 0.0f;
+    return true;
+  }
+
+  return false;
+}
+
+int FrameMetrics::write_summary(char* buffer, const size_t buffer_size) const {
+  int length = snprintf(buffer, buffer_size, "frames %llu missed %llu skipped %llu period %.2fms | p50/p90/p99/max ms",
+                        static_cast<unsigned long long>(frame_count), static_cast<unsigned long long>(missed_display_deadline_count), static_cast<unsigned long long>(skipped_render_count), predicted_display_period_milliseconds);
+
+  for (uint32_t metric=0; metric < MetricCount; ++metric) {
+    if ( (length < 0) || (size_t(length) >= buffer_size) ) break;
+    const RollingHistogram::Summary summary = histograms[metric].summarize();
+    length += snprintf(buffer + length, buffer_size - length, " %s %.2f/%.2f/%.2f/%.2f", metric_names[metric], summary.p50, summary.p90, summary.p99, summary.max);
+  }
+
+  return length;
+}
+
+bool FrameMetrics::open_csv(const char* file_path) {
+  csv_file.open(file_path, std::ios::out | std::ios::trunc);
+  if (!csv_file.is_open()) return false;
+
+  csv_file << "frame,sim_ms,render_sync_wait_ms,render_thread_cpu_ms,xr_wait_frame_ms,frame_ms,predicted_display_period_ms,should_render\n";
+  return true;
+}
+
+void FrameMetrics::close_csv() {
+  if (csv_file.is_open()) csv_file.close();
+}
+
+void FrameMetrics::reset() {
+  for (uint32_t metric=0; metric < MetricCount; ++metric) histograms[metric].reset();
+  frame_count                       = 0;
+  missed_display_deadline_count     = 0;
+  skipped_render_count              = 0;
+  previous_display_time_nanoseconds = 0;
+  seconds_since_summary             = 0.0f;
+}
+
+#endif  // TOM_ENGINE_METRICS_IMPLEMENTATION_SINGLE
+#endif  // TOM_ENGINE_METRICS_IMPLEMENTATION
@@ -0,0 +1,204 @@
+#ifndef INCLUDE_TOM_ENGINE_NAVIGATION_H
+#define INCLUDE_TOM_ENGINE_NAVIGATION_H
+
+#include <cstdint>
+#include <vector>
+
+// steps from every tile of a grid to the nearest source tile moving between walkable 4-neighbours, tiles are indexed row by row
+// tiles open and sources come and go one at a time and only the region whose distance changes is touched
+struct DistanceField {
+  static constexpr uint32_t unreachable = -1;
+  static constexpr uint32_t no_tile     = -1;
+
+  uint32_t column_count = 0;
+  uint32_t row_count    = 0;
+  std::vector<uint32_t> distances;
+  std::vector<bool>     is_tile_walkable;
+  std::vector<bool>     is_tile_source;
+  std::vector<bool>     is_tile_invalidated;
+  std::vector<uint32_t> update_tile_indexes;      // scratch for updates so they don't allocate once the field has been used a little
+  std::vector<uint32_t> invalidated_tile_indexes;
+
+  void init(const uint32_t column_count, const uint32_t row_count);  // every tile blocked and no sources
+
+  // setup without updating distances, call rebuild once done
+  void set_tile_walkable(const uint32_t tile_index, const bool is_walkable) { is_tile_walkable[tile_index] = is_walkable; }
+  void set_tile_source(const uint32_t tile_index, const bool is_source)     { is_tile_source[tile_index]   = is_source; }
+  void rebuild();
+
+  // incremental updates, sources must be walkable
+  void open_tile(const uint32_t tile_index);
+  void add_source(const uint32_t tile_index);
+  void remove_source(const uint32_t tile_index);
+
+  uint32_t get_distance(const uint32_t tile_index) const { return distances[tile_index]; }
+  uint32_t get_next_tile_index(const uint32_t tile_index) const;  // a neighbour one step closer to a source, no_tile on a source or an unreachable tile
+
+  void compute_distances_with_breadth_first_search(std::vector<uint32_t>& result_distances) const;  // from scratch, rebuild uses it and it is the reference for the incremental updates
+  bool is_consistent() const;  // incremental distances match a search from scratch
+};
+
+#endif  // INCLUDE_TOM_ENGINE_NAVIGATION_H
+
+//////////////////////////////////////////////////
+
+#ifdef  TOM_ENGINE_NAVIGATION_IMPLEMENTATION
+#ifndef TOM_ENGINE_NAVIGATION_IMPLEMENTATION_SINGLE
+#define TOM_ENGINE_NAVIGATION_IMPLEMENTATION_SINGLE
+
+#include <algorithm>
+
+// calls visit with each neighbour of tile_index that is on the grid
+template <typename Visit>
+static void for_each_grid_neighbour(const uint32_t tile_index, const uint32_t column_count, const uint32_t row_count, Visit&& visit) {
+  const uint32_t row_index    = tile_index / column_count;
+  const uint32_t column_index = tile_index % column_count;
+  if (row_index > 0)                      visit(tile_index - column_count);
+  if (row_index < (row_count - 1))        visit(tile_index + column_count);
+  if (column_index < (column_count - 1))  visit(tile_index + 1);
+  if (column_index > 0)                   visit(tile_index - 1);
+}
+
+// label correcting breadth first pass from the tiles in update_tile_indexes, a tile is queued again whenever its distance drops
+static void propagate_distance_decreases(DistanceField& field) {
+  for (size_t i=0; i < field.update_tile_indexes.size(); ++i) {
+    const uint32_t tile_index    = field.update_tile_indexes[i];
+    const uint32_t next_distance = field.distances[tile_index] + 1;
+    for_each_grid_neighbour(tile_index, field.column_count, field.row_count, [&](const uint32_t neighbour_tile_index) {
+      if ( field.is_tile_walkable[neighbour_tile_index] && (next_distance < field.distances[neighbour_tile_index]) ) {
+        field.distances[neighbour_tile_index] = next_distance;
+        field.update_tile_indexes.push_back(neighbour_tile_index);
+      }
+    });
+  }
+  field.update_tile_indexes.clear();
+}
+
+void DistanceField::init(const uint32_t column_count, const uint32_t row_count) {
+  this->column_count = column_count;
+  this->row_count    = row_count;
+  const size_t tile_count = size_t(column_count) * row_count;
+  distances.assign(tile_count, unreachable);
+  is_tile_walkable.assign(tile_count, false);
+  is_tile_source.assign(tile_count, false);
+  is_tile_invalidated.assign(tile_count, false);
+  update_tile_indexes.clear();
+  update_tile_indexes.reserve(tile_count);
+  invalidated_tile_indexes.clear();
+  invalidated_tile_indexes.reserve(tile_count);
+}
+
+void DistanceField::rebuild() {
+  compute_distances_with_breadth_first_search(distances);
+}
+
+void DistanceField::open_tile(const uint32_t tile_index) {
+  if (is_tile_walkable[tile_index]) return;
+  is_tile_walkable[tile_index] = true;
+
+  uint32_t closest_distance = unreachable;
+  for_each_grid_neighbour(tile_index, column_count, row_count, [&](const uint32_t neighbour_tile_index) {
+    if (is_tile_walkable[neighbour_tile_index]) closest_distance = std::min(closest_distance, distances[neighbour_tile_index]);
+  });
+  distances[tile_index] = is_tile_source[tile_index] ? 0 : ( (closest_distance == unreachable) ? unreachable : closest_distance + 1 );
+  if (distances[tile_index] == unreachable) return;
+
+  update_tile_indexes.push_back(tile_index);
+  propagate_distance_decreases(*this);
+}
+
+void DistanceField::add_source(const uint32_t tile_index) {
+  is_tile_source[tile_index] = true;
+  if (distances[tile_index] == 0) return;
+
+  distances[tile_index] = 0;
+  update_tile_indexes.push_back(tile_index);
+  propagate_distance_decreases(*this);
+}
+
+void DistanceField::remove_source(const uint32_t tile_index) {
+  if (!is_tile_source[tile_index]) return;
+  is_tile_source[tile_index] = false;
+
+  // first find every tile whose distance only ever came through the removed source, layer by layer outward so the tiles
+  // one step closer have all been settled by the time a tile is checked for another neighbour that still supports it
+  auto is_supported = [&](const uint32_t checked_tile_index) {
+    bool has_support = false;
+    for_each_grid_neighbour(checked_tile_index, column_count, row_count, [&](const uint32_t neighbour_tile_index) {
+      has_support |= is_tile_walkable[neighbour_tile_index] && !is_tile_invalidated[neighbour_tile_index] && ((distances[neighbour_tile_index] + 1) == distances[checked_tile_index]);
+    });
+    return has_support;
+  };
+
+  invalidated_tile_indexes.push_back(tile_index);
+  is_tile_invalidated[tile_index] = true;
+  for (size_t i=0; i < invalidated_tile_indexes.size(); ++i) {
+    const uint32_t invalidated_tile_index = invalidated_tile_indexes[i];
+    for_each_grid_neighbour(invalidated_tile_index, column_count, row_count, [&](const uint32_t neighbour_tile_index) {
+      if ( !is_tile_walkable[neighbour_tile_index] || is_tile_invalidated[neighbour_tile_index] || is_tile_source[neighbour_tile_index] ) return;
+      if ( (distances[neighbour_tile_index] != (distances[invalidated_tile_index] + 1)) || is_supported(neighbour_tile_index) ) return;
+      invalidated_tile_indexes.push_back(neighbour_tile_index);
+      is_tile_invalidated[neighbour_tile_index] = true;
+    });
+  }
+
+  // then refill the region from the tiles around it that kept their distance
+  for (const uint32_t invalidated_tile_index : invalidated_tile_indexes) distances[invalidated_tile_index] = unreachable;
+  for (const uint32_t invalidated_tile_index : invalidated_tile_indexes) {
+    uint32_t closest_distance = unreachable;
+    for_each_grid_neighbour(invalidated_tile_index, column_count, row_count, [&](const uint32_t neighbour_tile_index) {
+      if ( is_tile_walkable[neighbour_tile_index] && !is_tile_invalidated[neighbour_tile_index] ) closest_distance = std::min(closest_distance, distances[neighbour_tile_index]);
+    });
+    if (closest_distance != unreachable) {
+      distances[invalidated_tile_index] = closest_distance + 1;
+      update_tile_indexes.push_back(invalidated_tile_index);
+    }
+  }
+  for (const uint32_t invalidated_tile_index : invalidated_tile_indexes) is_tile_invalidated[invalidated_tile_index] = false;
+  invalidated_tile_indexes.clear();
+
+  std::sort(update_tile_indexes.begin(), update_tile_indexes.end(), [&](const uint32_t a, const uint32_t b) { return distances[a] < distances[b]; });  // closest first so few tiles are queued twice
+  propagate_distance_decreases(*this);
+}
+
+uint32_t DistanceField::get_next_tile_index(const uint32_t tile_index) const {
+  const uint32_t distance = distances[tile_index];
+  if ( (distance == 0) || (distance == unreachable) ) return no_tile;
+
+  uint32_t next_tile_index = no_tile;
+  for_each_grid_neighbour(tile_index, column_count, row_count, [&](const uint32_t neighbour_tile_index) {
+    if ( (next_tile_index == no_tile) && is_tile_walkable[neighbour_tile_index] && ((distances[neighbour_tile_index] + 1) == distance) ) next_tile_index = neighbour_tile_index;
+  });
+  return next_tile_index;
+}
+
+void DistanceField::compute_distances_with_breadth_first_search(std::vector<uint32_t>& result_distances) const {
+  result_distances.assign(distances.size(), unreachable);
+  std::vector<uint32_t> queue;
+  queue.reserve(distances.size());
+  for (uint32_t tile_index=0; tile_index < distances.size(); ++tile_index) {
+    if (is_tile_source[tile_index] && is_tile_walkable[tile_index]) {
+      result_distances[tile_index] = 0;
+      queue.push_back(tile_index);
+    }
+  }
+
+  for (size_t i=0; i < queue.size(); ++i) {
+    const uint32_t tile_index = queue[i];
+    for_each_grid_neighbour(tile_index, column_count, row_count, [&](const uint32_t neighbour_tile_index) {
+      if ( is_tile_walkable[neighbour_tile_index] && (result_distances[neighbour_tile_index] == unreachable) ) {
+        result_distances[neighbour_tile_index] = result_distances[tile_index] + 1;
+        queue.push_back(neighbour_tile_index);
+      }
+    });
+  }
+}
+
+bool DistanceField::is_consistent() const {
+  std::vector<uint32_t> expected_distances;
+  compute_distances_with_breadth_first_search(expected_distances);
+  return expected_distances == distances;
+}
+
+#endif  // TOM_ENGINE_NAVIGATION_IMPLEMENTATION_SINGLE
+#endif  // TOM_ENGINE_NAVIGATION_IMPLEMENTATION
@@ -5,6 +5,7 @@
 #include <vector>
 #include <bitset>
 #include <cstdio>
+#include <cstring>
 #include <string>
 #include <algorithm>
 #include <map>
@@ -20,7 +20,8 @@ void init_thread(void (*function_ptr)(), const uint32_t thread_pool_index);
 uint32_t get_thread_pool_size();
 void platform_request_exit();
 
-extern float      delta_time_seconds;
+extern float      delta_time_seconds;        // fixed simulation tick duration
+extern float      frame_delta_time_seconds;  // time between displayed frames
 extern InputState input_state;
 extern std::atomic<Vector3f> hmd_global_position;
 
@@ -36,7 +37,7 @@ extern std::atomic<Vector3f> hmd_global_position;
   #include <android/asset_manager.h>
   FILE* android_fopen(const char* file_name, const char* mode);
   #define fopen(name, mode) android_fopen(name, mode)
-#elif defined(OCULUS_PC)
+#elif defined(OCULUS_PC) || defined(HEADLESS)
   #ifndef NDEBUG
     #include <cstdio>
     #define DEBUG_LOG(...) printf(__VA_ARGS__)
@@ -59,6 +60,8 @@ extern std::atomic<Vector3f> hmd_global_position;
   #include "platform_oculus_pc.cpp"
 #elif defined(OCULUS_QUEST_2)
   #include "platform_oculus_quest_2.cpp"
+#elif defined(HEADLESS)
+  #include "platform_headless.cpp"
 #endif
 
 #endif  // TOM_ENGINE_PLATFORM_IMPLEMENTATION_SINGLE
@@ -0,0 +1,26 @@
+#include <atomic>
+#include <thread>
+#include "config.h"
+#include "maths.h"
+#include "simulation.h"
+#include "tom_std.h"
+
+// no headset, window or thread pool so the simulation can be driven directly from a desktop program (see benchmarks/)
+
+std::atomic<bool>     is_platform_quit_requested(false);
+InputState            input_state;
+std::atomic<Vector3f> hmd_global_position;
+SimulationState       sim_state;
+float                 delta_time_seconds       = 0.0f;
+float                 frame_delta_time_seconds = 0.0f;
+
+uint32_t get_thread_pool_size() {
+  return 0;
+}
+
+void init_thread(void (*function_ptr)(), const uint32_t thread_pool_index) {  // nothing is rendered or played so there are no render or audio threads to start
+}
+
+void platform_request_exit() {
+  is_platform_quit_requested = true;
+}
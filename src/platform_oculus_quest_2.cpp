@@ -16,6 +16,7 @@
 #include <assert.h>
 #include <vector>
 #include <thread>
+#include <time.h>
 #include <chrono>
 #include <map>
 #include <mutex>
@@ -28,6 +29,7 @@
 #include "simulation.h"
 #include "tom_std.h"
 #include "profiler.h"
+#include "metrics.h"
 
 
 struct XrSwapchainContext {
@@ -89,6 +91,7 @@ std::atomic<bool>                    set_audio_thread_affinity_mask(false);
 tom::Semaphore                       platform_render_semaphore;
 tom::Semaphore                       platform_render_thread_sync_semaphore;
 XrFrameState                         platform_render_thread_frame_state;
+std::atomic<uint64_t>                platform_render_thread_cpu_time_nanoseconds(0);
 InputState                           input_state;
 std::atomic<Vector3f>                hmd_global_position{};
 std::atomic<Quaternionf>             hmd_global_orientation{};
@@ -115,7 +118,8 @@ extern void vulkan_render_xr_views(const std::vector<XrCompositionLayerProjectio
 
 constexpr uint32_t audio_thread_pool_index = 1;
 SimulationState sim_state;
-float           delta_time_seconds = 0.0f;
+float           delta_time_seconds       = 0.0f;
+float           frame_delta_time_seconds = 0.0f;
 
 int android_readfn(void* cookie, char* buffer, int size_bytes) {
   return AAsset_read((AAsset*)cookie, buffer, size_bytes);
@@ -949,16 +953,29 @@ bool poll_platform_events() {
 
 void sync_render_thread_simulation_state() {
   PROFILE_FUNCTION();
-  memcpy(&graphics_render_thread_sim_state.mesh_instances, &graphics_all_mesh_instances, sizeof(GraphicsMeshInstances));
+  graphics_render_thread_sim_state.mesh_instances.copy_active_instances(graphics_all_mesh_instances);
   memcpy(&graphics_render_thread_sim_state.animation_states, &graphics_all_skeleton_instances.animation_states, sizeof(AnimationState) * std::size(graphics_render_thread_sim_state.animation_states));
 }
 
 void platform_render_frame() {
   PROFILE_FUNCTION();
+  tom::Clock render_sync_wait_clock;
+  render_sync_wait_clock.start();
   platform_render_thread_sync_semaphore.wait();
+  render_sync_wait_clock.stop();
 
   XrFrameState frame_state = {XR_TYPE_FRAME_STATE};
+  tom::Clock xr_wait_frame_clock;
+  xr_wait_frame_clock.start();
   xrWaitFrame(platform_xr_session, nullptr, &frame_state);
+  xr_wait_frame_clock.stop();
+
+  frame_timing_sample.render_sync_wait_milliseconds         = static_cast<float>(render_sync_wait_clock.get_elapsed_time_nanoseconds()) / 1000000.0f;
+  frame_timing_sample.xr_wait_frame_milliseconds            = static_cast<float>(xr_wait_frame_clock.get_elapsed_time_nanoseconds()) / 1000000.0f;
+  frame_timing_sample.render_thread_cpu_milliseconds        = static_cast<float>(platform_render_thread_cpu_time_nanoseconds.load()) / 1000000.0f;
+  frame_timing_sample.predicted_display_period_milliseconds = static_cast<float>(frame_state.predictedDisplayPeriod) / 1000000.0f;
+  frame_timing_sample.predicted_display_time_nanoseconds    = static_cast<int64_t>(frame_state.predictedDisplayTime);
+  frame_timing_sample.should_render                         = frame_state.shouldRender;
 
   xrBeginFrame(platform_xr_session, nullptr);
 
@@ -1009,6 +1026,7 @@ void platform_render_thread() {
     if (is_platform_quit_requested) {
       return;
     }
+    const uint64_t render_thread_cpu_start_time_nanoseconds = get_thread_cpu_time_nanoseconds();
 
     XrCompositionLayerBaseHeader* application_composition_layer           = nullptr;
     XrCompositionLayerProjection application_composition_layer_projection = {XR_TYPE_COMPOSITION_LAYER_PROJECTION};
@@ -1073,6 +1091,7 @@ void platform_render_thread() {
     end_info.layers               = composition_layers;
     xrEndFrame(platform_xr_session, &end_info);
 
+    platform_render_thread_cpu_time_nanoseconds = get_thread_cpu_time_nanoseconds() - render_thread_cpu_start_time_nanoseconds;
     platform_render_thread_sync_semaphore.signal();
   }
 }
@@ -1158,26 +1177,57 @@ void android_main(struct android_app* app) {  // entry point when using android_
   android_asset_manager = app->activity->assetManager;
 
   init_platform();
-  sim_state.init();
+  const std::string match_replay_file_path = std::string(app->activity->internalDataPath) + "/match.replay";
+  #ifdef PLAY_MATCH_REPLAY
+  sim_state.replay(match_replay_file_path.c_str());
+  platform_request_exit();
+  #else
+  sim_state.init(static_cast<uint64_t>(time(NULL)));
+  #endif
+  #ifdef RECORD_MATCH_REPLAY
+  sim_state.start_recording(match_replay_file_path.c_str());
+  #endif
 
   init_thread(platform_render_thread, 0);
   init_thread(platform_audio_thread, audio_thread_pool_index);  // audio_thread_pool_index should be 1
 
+  #ifdef WRITE_FRAME_METRICS_CSV
+  const std::string frame_metrics_file_path = std::string(app->activity->internalDataPath) + "/frame_metrics.csv";
+  frame_metrics.open_csv(frame_metrics_file_path.c_str());
+  #endif
+
   tom::Clock frame_rate_clock;
+  tom::Clock sim_update_clock;
   frame_rate_clock.start();
 
   while ( poll_platform_events() ) {
     PROFILE_FRAME("SimulationAndMainThread");
-    sim_state.update();
+    sim_update_clock.start();
+    sim_state.advance(frame_delta_time_seconds);
+    sim_update_clock.stop();
     platform_render_frame();
 
     frame_rate_clock.stop();
-    delta_time_seconds = frame_rate_clock.get_elapsed_time_seconds();
+    frame_delta_time_seconds = frame_rate_clock.get_elapsed_time_seconds();
     frame_rate_clock.restart();
+
+    frame_timing_sample.sim_update_milliseconds = static_cast<float>(sim_update_clock.get_elapsed_time_nanoseconds()) / 1000000.0f;
+    frame_timing_sample.frame_milliseconds      = static_cast<float>(frame_rate_clock.get_elapsed_time_nanoseconds()) / 1000000.0f;
+    if ( frame_metrics.record_frame(frame_timing_sample) ) {
+      char frame_metrics_summary[512];
+      frame_metrics.write_summary(frame_metrics_summary, sizeof(frame_metrics_summary));
+      DEBUG_LOG("%s\n", frame_metrics_summary);
+    }
   }
 
+  frame_metrics.close_csv();
+
   sim_state.exit();
   deactivate_platform();
+  #ifdef USE_PROFILER  // threads have been joined so the trace buffers are no longer being written
+  const std::string trace_file_path = std::string(app->activity->internalDataPath) + "/trace.json";  // pull with adb shell run-as
+  profiler_write_chrome_trace(trace_file_path.c_str());
+  #endif
   app->activity->vm->DetachCurrentThread();
 
   exit(0);
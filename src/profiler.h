@@ -1,39 +1,81 @@
 #ifndef INCLUDE_TOM_ENGINE_PROFILER_H
 #define INCLUDE_TOM_ENGINE_PROFILER_H
 
-#include <chrono>
-#include "platform.h"
+#include <atomic>
+#include <cstdint>
 
 void empty_profiler_function(const char* str="");
 
+struct ProfilerEvent {
+  enum class Type : uint8_t { Begin, End, Counter };
+
+  const char* name;
+  uint64_t    timestamp_ticks;
+  double      counter_value;
+  Type        type;
+};
+
+struct ProfilerThreadBuffer {
+  static constexpr uint32_t max_event_count = 1 << 15; // must be a power of 2
+  static constexpr uint32_t max_thread_count = 16;
+
+  ProfilerEvent         events[max_event_count]; // ring buffer only written by the owning thread
+  std::atomic<uint64_t> write_index{0};          // total events ever written (slot is write_index & (max_event_count - 1))
+  const char*           thread_name = nullptr;
+  uint32_t              thread_id;
+};
+
+uint64_t profiler_get_ticks();
+ProfilerThreadBuffer* profiler_register_current_thread();
+void profiler_set_thread_name(const char* name);
+void profiler_record_counter(const char* name, const double value);
+bool profiler_write_chrome_trace(const char* file_path);
+
+extern thread_local ProfilerThreadBuffer* profiler_current_thread_buffer;
+
+inline void profiler_record_event(const char* name, const ProfilerEvent::Type type, const double counter_value=0.0) {
+  ProfilerThreadBuffer* buffer = profiler_current_thread_buffer;
+  if (!buffer) buffer = profiler_register_current_thread();
+  if (!buffer) return; // more threads than max_thread_count
+
+  const uint64_t index  = buffer->write_index.load(std::memory_order_relaxed);
+  ProfilerEvent& event  = buffer->events[index & (ProfilerThreadBuffer::max_event_count - 1)];
+  event.name            = name;
+  event.timestamp_ticks = profiler_get_ticks();
+  event.counter_value   = counter_value;
+  event.type            = type;
+  buffer->write_index.store(index + 1, std::memory_order_release);
+}
+
 struct ScopedTimer {
   const char* name;
-  std::chrono::time_point<std::chrono::steady_clock> start_time_point;
 
-  ScopedTimer(const char* p_name);
-  ~ScopedTimer();
+  ScopedTimer(const char* p_name) : name(p_name) { profiler_record_event(name, ProfilerEvent::Type::Begin); }
+  ~ScopedTimer() { profiler_record_event(name, ProfilerEvent::Type::End); }
 };
 
+#define PROFILER_CONCAT_INNER(a, b) a##b
+#define PROFILER_CONCAT(a, b) PROFILER_CONCAT_INNER(a, b)
+
 #ifdef USE_PROFILER
-  #if defined(OCULUS_PC)
-  #include <optick.h>
-  #define PROFILE_THREAD OPTICK_THREAD
-  #define PROFILE_FUNCTION OPTICK_EVENT
-  #define PROFILE_FRAME OPTICK_FRAME
-  #define PROFILE_GPU_INIT OPTICK_GPU_INIT_VULKAN
-  #define PROFILE_GPU_CONTEXT OPTICK_GPU_CONTEXT
-  #define PROFILE_GPU_EVENT OPTICK_GPU_EVENT
-  #define PROFILE_GPU_PRESENT OPTICK_GPU_FLIP
-  #endif
+#define PROFILE_SCOPE(name) ScopedTimer PROFILER_CONCAT(profiler_scoped_timer_, __LINE__)(name)
+#define PROFILE_FUNCTION() PROFILE_SCOPE(__func__)
+#define PROFILE_FRAME(name) PROFILE_SCOPE(name)
+#define PROFILE_THREAD(name) profiler_set_thread_name(name)
+#define PROFILE_COUNTER(name, value) profiler_record_counter(name, static_cast<double>(value))
 #else
-#define PROFILE_FRAME empty_profiler_function
+#define PROFILE_SCOPE(name) empty_profiler_function(name)
 #define PROFILE_FUNCTION empty_profiler_function
+#define PROFILE_FRAME empty_profiler_function
 #define PROFILE_THREAD empty_profiler_function
+#define PROFILE_COUNTER(name, value) empty_profiler_function(name)
+#endif  // USE_PROFILER
+
+// the built-in profiler only records cpu events so gpu events are no-ops, there are no gpu zones in a trace like optick's vulkan ones
 #define PROFILE_GPU_INIT empty_profiler_function
 #define PROFILE_GPU_CONTEXT empty_profiler_function
 #define PROFILE_GPU_EVENT empty_profiler_function
 #define PROFILE_GPU_PRESENT empty_profiler_function
-#endif  // USE_PROFILER
 
 #endif  // INCLUDE_TOM_ENGINE_PROFILER_H
 
@@ -43,20 +85,135 @@ struct ScopedTimer {
 #ifndef TOM_ENGINE_PROFILER_IMPLEMENTATION_SINGLE
 #define TOM_ENGINE_PROFILER_IMPLEMENTATION_SINGLE
 
+#include <chrono>
+#include <fstream>
+#include <algorithm>
+#include <cstdio>
+
+#if defined(__x86_64__) || defined(_M_X64)
+  #if defined(_MSC_VER)
+    #include <intrin.h>
+  #else
+    #include <x86intrin.h>
+  #endif
+#elif !defined(__aarch64__)
+  #include <time.h>
+#endif
+
+struct ProfilerClockCalibration {
+  uint64_t start_ticks;
+  uint64_t start_nanoseconds;
+};
+
+thread_local ProfilerThreadBuffer* profiler_current_thread_buffer = nullptr;
+std::atomic<ProfilerThreadBuffer*> profiler_thread_buffers[ProfilerThreadBuffer::max_thread_count];
+std::atomic<uint32_t> profiler_thread_buffer_count{0};
+
+static uint64_t profiler_get_steady_nanoseconds() {
+  using namespace std::chrono;
+  return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+const ProfilerClockCalibration profiler_clock_calibration = { profiler_get_ticks(), profiler_get_steady_nanoseconds() };
+
 void empty_profiler_function(const char* str) {};
 
-ScopedTimer::ScopedTimer(const char* p_name) : name(p_name) {
-  this->start_time_point = std::chrono::high_resolution_clock::now();
+uint64_t profiler_get_ticks() {
+  #if defined(__x86_64__) || defined(_M_X64)
+  return __rdtsc();
+  #elif defined(__aarch64__)
+  uint64_t ticks;
+  asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+  return ticks;
+  #else
+  timespec time;
+  clock_gettime(CLOCK_MONOTONIC_RAW, &time);
+  return (uint64_t(time.tv_sec) * 1000000000ull) + uint64_t(time.tv_nsec);
+  #endif
+}
+
+ProfilerThreadBuffer* profiler_register_current_thread() {
+  const uint32_t thread_id = profiler_thread_buffer_count.fetch_add(1, std::memory_order_relaxed);
+  if (thread_id >= ProfilerThreadBuffer::max_thread_count) return nullptr;
+
+  ProfilerThreadBuffer* buffer = new ProfilerThreadBuffer();
+  buffer->thread_id = thread_id;
+  profiler_thread_buffers[thread_id].store(buffer, std::memory_order_release);
+  profiler_current_thread_buffer = buffer;
+
+  return buffer;
 }
 
-ScopedTimer::~ScopedTimer() {
-  const auto end_time_point = std::chrono::high_resolution_clock::now();
+void profiler_set_thread_name(const char* name) {
+  ProfilerThreadBuffer* buffer = profiler_current_thread_buffer;
+  if (!buffer) buffer = profiler_register_current_thread();
+  if (buffer) buffer->thread_name = name;
+}
+
+void profiler_record_counter(const char* name, const double value) {
+  profiler_record_event(name, ProfilerEvent::Type::Counter, value);
+}
+
+bool profiler_write_chrome_trace(const char* file_path) {  // events that are being recorded while writing may be torn so call after other threads are idle
+  std::ofstream file(file_path, std::ios::out | std::ios::trunc);
+  if (!file.is_open()) return false;
+
+  // convert ticks to microseconds by comparing against the steady clock over the whole capture
+  const uint64_t end_ticks          = profiler_get_ticks();
+  const uint64_t end_nanoseconds    = profiler_get_steady_nanoseconds();
+  const double elapsed_ticks        = static_cast<double>(end_ticks - profiler_clock_calibration.start_ticks);
+  const double elapsed_microseconds = static_cast<double>(end_nanoseconds - profiler_clock_calibration.start_nanoseconds) / 1000.0;
+  const double microseconds_per_tick = (elapsed_ticks > 0.0) ? (elapsed_microseconds / elapsed_ticks) : 0.0;
+
+  char line[512];
+  bool is_first_event = true;
+  auto write_line = [&](const int length) {
+    if (!is_first_event) file.write(",\n", 2);
+    file.write(line, std::min(length, int(sizeof(line) - 1)));
+    is_first_event = false;
+  };
+
+  file << "{\"traceEvents\":[\n";
+
+  const uint32_t thread_count = std::min(profiler_thread_buffer_count.load(std::memory_order_acquire), ProfilerThreadBuffer::max_thread_count);
+  for (uint32_t thread_index=0; thread_index < thread_count; ++thread_index) {
+    const ProfilerThreadBuffer* buffer = profiler_thread_buffers[thread_index].load(std::memory_order_acquire);
+    if (!buffer) continue;
+
+    if (buffer->thread_name) {
+      write_line( snprintf(line, sizeof(line), "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"%s\"}}", buffer->thread_id, buffer->thread_name) );
+    }
+
+    const uint64_t write_index = buffer->write_index.load(std::memory_order_acquire);
+    const uint64_t first_index = (write_index > ProfilerThreadBuffer::max_event_count) ? (write_index - ProfilerThreadBuffer::max_event_count) : 0;
+    uint32_t scope_depth = 0;
+
+    for (uint64_t event_index=first_index; event_index < write_index; ++event_index) {
+      const ProfilerEvent& event     = buffer->events[event_index & (ProfilerThreadBuffer::max_event_count - 1)];
+      const double timestamp_microseconds = static_cast<double>(int64_t(event.timestamp_ticks - profiler_clock_calibration.start_ticks)) * microseconds_per_tick;
 
-  const long long start_time_microseconds = std::chrono::time_point_cast<std::chrono::microseconds>(start_time_point).time_since_epoch().count();
-  const long long end_time_microseconds   = std::chrono::time_point_cast<std::chrono::microseconds>(end_time_point).time_since_epoch().count();
+      switch (event.type) {
+        case ProfilerEvent::Type::Begin: {
+          ++scope_depth;
+          write_line( snprintf(line, sizeof(line), "{\"name\":\"%s\",\"ph\":\"B\",\"ts\":%.3f,\"pid\":0,\"tid\":%u}", event.name, timestamp_microseconds, buffer->thread_id) );
+          break;
+        }
+        case ProfilerEvent::Type::End: {
+          if (scope_depth == 0) break;  // the matching begin event was overwritten by the ring buffer
+          --scope_depth;
+          write_line( snprintf(line, sizeof(line), "{\"name\":\"%s\",\"ph\":\"E\",\"ts\":%.3f,\"pid\":0,\"tid\":%u}", event.name, timestamp_microseconds, buffer->thread_id) );
+          break;
+        }
+        case ProfilerEvent::Type::Counter: {
+          write_line( snprintf(line, sizeof(line), "{\"name\":\"%s\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":0,\"tid\":%u,\"args\":{\"value\":%f}}", event.name, timestamp_microseconds, buffer->thread_id, event.counter_value) );
+          break;
+        }
+      }
+    }
+  }
 
-  // TODO: implement for release mode
-  DEBUG_LOG("%s: %lld microseconds\n", name, end_time_microseconds - start_time_microseconds);
+  file << "\n]}\n";
+  return file.good();
 }
 
 #endif  // TOM_ENGINE_PROFILER_IMPLEMENTATION_SINGLE
@@ -0,0 +1,183 @@
+#ifndef INCLUDE_TOM_ENGINE_REPLAY_H
+#define INCLUDE_TOM_ENGINE_REPLAY_H
+
+#include "platform.h"
+#include <cstdint>
+#include <fstream>
+#include <vector>
+
+struct ReplayHeader {
+  static constexpr uint32_t current_magic   = 0x52525842;  // "BXRR"
+  static constexpr uint32_t current_version = 6;  // 2: player positions in the checksum are in board space so moving the board doesn't change them
+                                                  // 3: the match settings SimulationState takes before init are recorded
+                                                  // 4: bombs and fire run on timer wheels in whole ticks, chain reactions resolve in the tick they start
+                                                  // 5: AIs plan against the shared danger map
+                                                  // 6: AIs with nothing in reach follow the distance field to the closest brick instead of wandering
+
+  uint32_t magic;
+  uint32_t version;
+  uint64_t seed;
+  float    tick_duration_seconds;
+  uint32_t board_width;
+  uint32_t board_height;
+  uint32_t player_count;
+  uint32_t ai_rollout_count;
+  uint32_t is_player_1_ai_controlled;
+};
+
+struct ReplayInputRecord {  // InputState without padding so records can be compared and written as raw bytes
+  enum ButtonBits : uint32_t { ActionButton = 1 << 0, MoveBoard = 1 << 1, Exit = 1 << 2, GamepadActionButton = 1 << 3, GamepadExit = 1 << 4 };
+
+  uint32_t  repeat_tick_count;  // number of consecutive ticks with this input, 0 marks the end of the input stream
+  uint32_t  button_bits;
+  Transform left_hand_transform;
+  Transform right_hand_transform;
+  Vector2f  move_player;
+  Vector2f  gamepad_move_player;
+};
+
+struct ReplayFooter {
+  uint64_t tick_count;
+  uint64_t checksum;  // SimulationState::compute_checksum after the last tick
+};
+
+struct ReplayRecorder {
+  std::ofstream     file;
+  ReplayInputRecord current_record;
+  uint64_t          tick_count = 0;
+
+  bool open(const char* file_path, ReplayHeader header);  // magic and version are filled in
+  void record_tick(const InputState& input);
+  void close(const uint64_t checksum);
+  bool is_recording() const { return file.is_open(); }
+};
+
+struct ReplayPlayer {
+  std::vector<uint8_t> data;
+  size_t               read_offset = 0;
+  ReplayHeader         header;
+  ReplayFooter         footer;
+  ReplayInputRecord    current_record;
+  uint64_t             tick_count  = 0;
+
+  bool open(const char* file_path);
+  bool next_tick(InputState& input);  // returns false once all recorded ticks have been played
+};
+
+#endif  // INCLUDE_TOM_ENGINE_REPLAY_H
+
+//////////////////////////////////////////////////
+
+#ifdef  TOM_ENGINE_REPLAY_IMPLEMENTATION
+#ifndef TOM_ENGINE_REPLAY_IMPLEMENTATION_SINGLE
+#define TOM_ENGINE_REPLAY_IMPLEMENTATION_SINGLE
+
+#include <cstring>
+#include <iterator>
+
+static_assert(sizeof(ReplayInputRecord) == (sizeof(uint32_t) * 2) + (sizeof(Transform) * 2) + (sizeof(Vector2f) * 2), "ReplayInputRecord must not contain padding");
+
+static ReplayInputRecord pack_replay_input(const InputState& input) {
+  ReplayInputRecord record;
+  memset(&record, 0, sizeof(record));
+  record.button_bits = ( ReplayInputRecord::ActionButton        * static_cast<uint32_t>(input.action_button) ) |
+                       ( ReplayInputRecord::MoveBoard           * static_cast<uint32_t>(input.move_board) ) |
+                       ( ReplayInputRecord::Exit                * static_cast<uint32_t>(input.exit) ) |
+                       ( ReplayInputRecord::GamepadActionButton * static_cast<uint32_t>(input.gamepad_action_button) ) |
+                       ( ReplayInputRecord::GamepadExit         * static_cast<uint32_t>(input.gamepad_exit) );
+  record.left_hand_transform  = input.left_hand_transform;
+  record.right_hand_transform = input.right_hand_transform;
+  record.move_player          = input.move_player;
+  record.gamepad_move_player  = input.gamepad_move_player;
+  return record;
+}
+
+static void unpack_replay_input(const ReplayInputRecord& record, InputState& input) {
+  input.action_button         = (record.button_bits & ReplayInputRecord::ActionButton) != 0;
+  input.move_board            = (record.button_bits & ReplayInputRecord::MoveBoard) != 0;
+  input.exit                  = (record.button_bits & ReplayInputRecord::Exit) != 0;
+  input.gamepad_action_button = (record.button_bits & ReplayInputRecord::GamepadActionButton) != 0;
+  input.gamepad_exit          = (record.button_bits & ReplayInputRecord::GamepadExit) != 0;
+  input.left_hand_transform   = record.left_hand_transform;
+  input.right_hand_transform  = record.right_hand_transform;
+  input.move_player           = record.move_player;
+  input.gamepad_move_player   = record.gamepad_move_player;
+}
+
+static_assert(sizeof(ReplayHeader) == (sizeof(uint32_t) * 7) + sizeof(uint64_t) + sizeof(float), "ReplayHeader must not contain padding");
+
+bool ReplayRecorder::open(const char* file_path, ReplayHeader header) {
+  file.open(file_path, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!file.is_open()) return false;
+
+  header.magic   = ReplayHeader::current_magic;
+  header.version = ReplayHeader::current_version;
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  memset(&current_record, 0, sizeof(current_record));
+  tick_count = 0;
+  return true;
+}
+
+void ReplayRecorder::record_tick(const InputState& input) {
+  if (!file.is_open()) return;
+
+  // only changes are written, a tick with the same input as the previous one just extends the current record
+  ReplayInputRecord record = pack_replay_input(input);
+  record.repeat_tick_count = current_record.repeat_tick_count;
+  if ( (current_record.repeat_tick_count > 0) && (memcmp(&record, &current_record, sizeof(record)) == 0) && (current_record.repeat_tick_count < UINT32_MAX) ) {
+    ++current_record.repeat_tick_count;
+  } else {
+    if (current_record.repeat_tick_count > 0) file.write(reinterpret_cast<const char*>(&current_record), sizeof(current_record));
+    current_record = record;
+    current_record.repeat_tick_count = 1;
+  }
+  ++tick_count;
+}
+
+void ReplayRecorder::close(const uint64_t checksum) {
+  if (!file.is_open()) return;
+
+  if (current_record.repeat_tick_count > 0) file.write(reinterpret_cast<const char*>(&current_record), sizeof(current_record));
+
+  ReplayInputRecord end_record;
+  memset(&end_record, 0, sizeof(end_record));
+  file.write(reinterpret_cast<const char*>(&end_record), sizeof(end_record));
+
+  const ReplayFooter footer = { tick_count, checksum };
+  file.write(reinterpret_cast<const char*>(&footer), sizeof(footer));
+  file.close();
+}
+
+bool ReplayPlayer::open(const char* file_path) {
+  std::ifstream file(file_path, std::ios::in | std::ios::binary);
+  if (!file.is_open()) return false;
+
+  data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  if (data.size() < (sizeof(ReplayHeader) + sizeof(ReplayInputRecord) + sizeof(ReplayFooter))) return false;
+
+  memcpy(&header, data.data(), sizeof(header));
+  if ( (header.magic != ReplayHeader::current_magic) || (header.version != ReplayHeader::current_version) ) return false;
+
+  memcpy(&footer, data.data() + data.size() - sizeof(footer), sizeof(footer));
+  read_offset = sizeof(header);
+  memset(&current_record, 0, sizeof(current_record));
+  tick_count = 0;
+  return true;
+}
+
+bool ReplayPlayer::next_tick(InputState& input) {
+  if (current_record.repeat_tick_count == 0) {
+    if ( (read_offset + sizeof(ReplayInputRecord)) > data.size() ) return false;
+    memcpy(&current_record, data.data() + read_offset, sizeof(current_record));
+    read_offset += sizeof(current_record);
+    if (current_record.repeat_tick_count == 0) return false;  // end of the input stream
+  }
+
+  unpack_replay_input(current_record, input);
+  --current_record.repeat_tick_count;
+  ++tick_count;
+  return true;
+}
+
+#endif  // TOM_ENGINE_REPLAY_IMPLEMENTATION_SINGLE
+#endif  // TOM_ENGINE_REPLAY_IMPLEMENTATION
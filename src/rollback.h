@@ -0,0 +1,266 @@
+#ifndef INCLUDE_TOM_ENGINE_ROLLBACK_H
+#define INCLUDE_TOM_ENGINE_ROLLBACK_H
+
+#include "match_state.h"
+#include <cstdint>
+#include <vector>
+
+// rollback netcode on a MatchState, a frame is one step and peer i controls player i while players without a peer wait
+// every peer steps its own input after a small delay right away and predicts the others' by repeating their last move,
+// when a remote input turns out different from the prediction the snapshot before it is restored and the frames since are stepped again
+
+struct RollbackPacket {  // a peer's inputs from first_frame on, each packet repeats every input the receiver hasn't acknowledged so lost packets are never resent
+  static constexpr uint32_t max_input_count = 32;
+
+  uint8_t            sender_peer_index;
+  uint8_t            input_count;
+  uint16_t           reserved;
+  uint32_t           acknowledged_frame_count;  // frames of the receiver's inputs the sender has
+  uint32_t           first_frame;
+  MatchState::Action inputs[max_input_count];
+};
+
+struct RollbackTransport {  // unreliable and unordered delivery to the other peers, a socket on a platform or a LoopbackNetwork endpoint for testing
+  void* context;
+  void (*send)(void* context, const uint32_t to_peer_index, const RollbackPacket& packet);
+  bool (*receive)(void* context, RollbackPacket& packet);  // false once no more packets have arrived
+};
+
+struct RollbackSession {
+  static constexpr uint32_t max_peer_count         = 4;
+  static constexpr uint32_t max_input_delay_frames = 8;
+  static constexpr uint32_t max_prediction_frames  = 16;  // the session stalls rather than run further ahead of the last frame it has every input for
+  static constexpr uint32_t frame_ring_size        = 64;  // inputs and snapshots kept, enough for the frames peers can be apart within the limits above
+  static constexpr uint32_t no_frame               = -1;
+
+  uint32_t                peer_count               = 0;
+  uint32_t                local_peer_index         = 0;
+  uint32_t                input_delay_frames       = 0;
+  uint32_t                current_frame            = 0;  // the current state is snapshots[current_frame % frame_ring_size]
+  uint32_t                first_mispredicted_frame = no_frame;
+  uint32_t                confirmed_frame_count    = 0;  // states no input still to come can change
+  uint64_t                confirmed_checksum       = 0;  // chained over every confirmed state, peers that agree on it played the same match
+  uint32_t                received_frame_counts[max_peer_count];      // consecutive inputs known for each peer, the local peer's include the delay
+  uint32_t                acknowledged_frame_counts[max_peer_count];  // local inputs each remote peer is known to have
+  MatchState::Action      inputs[frame_ring_size][MatchState::max_player_count];  // received or predicted
+  std::vector<MatchState> snapshots;  // the state at the start of each frame
+  RollbackTransport       transport;
+  uint64_t                rollback_count          = 0;
+  uint64_t                resimulated_frame_count = 0;
+
+  void init(const MatchState& start_state, const uint32_t peer_count, const uint32_t local_peer_index, const uint32_t input_delay_frames, const RollbackTransport& transport);
+  bool needs_local_input() const { return received_frame_counts[local_peer_index] <= (current_frame + input_delay_frames); }
+  void add_local_input(const MatchState::Action action);  // the input for the first frame after the ones already given
+  void poll();         // takes in the packets that have arrived
+  void synchronize();  // rolls back and steps forward again if a prediction was wrong, then confirms the states that are now final
+  bool advance_frame();  // synchronizes and steps the current frame, false while the local input is missing or the session is too far ahead
+  void send();         // the unacknowledged local inputs to every remote peer
+  const MatchState& get_state() const { return snapshots[current_frame % frame_ring_size]; }
+  uint32_t get_min_received_frame_count() const;
+};
+
+struct LoopbackNetwork {  // every peer in one process for testing, packets arrive after the latency plus random jitter and some never arrive
+  struct Endpoint {
+    LoopbackNetwork* network;
+    uint32_t         peer_index;
+  };
+
+  struct Delivery {
+    uint64_t       arrival_time_microseconds;
+    uint32_t       to_peer_index;
+    RollbackPacket packet;
+  };
+
+  uint32_t              latency_microseconds = 0;
+  uint32_t              jitter_microseconds  = 0;  // extra delay up to this much so packets also overtake each other
+  uint32_t              loss_percentage      = 0;
+  uint64_t              time_microseconds    = 0;
+  uint64_t              sent_packet_count    = 0;
+  uint64_t              lost_packet_count    = 0;
+  tom::Random           random;
+  Endpoint              endpoints[RollbackSession::max_peer_count];
+  std::vector<Delivery> deliveries;  // in flight
+
+  void init(const uint32_t latency_microseconds, const uint32_t jitter_microseconds, const uint32_t loss_percentage, const uint64_t seed);
+  RollbackTransport get_transport(const uint32_t peer_index);  // the network must stay where it is while transports point into it
+  void advance_time(const uint64_t microseconds) { time_microseconds += microseconds; }
+};
+
+#endif  // INCLUDE_TOM_ENGINE_ROLLBACK_H
+
+//////////////////////////////////////////////////
+
+#ifdef  TOM_ENGINE_ROLLBACK_IMPLEMENTATION
+#ifndef TOM_ENGINE_ROLLBACK_IMPLEMENTATION_SINGLE
+#define TOM_ENGINE_ROLLBACK_IMPLEMENTATION_SINGLE
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+// a remote peer is predicted to keep doing what it last did, except that nobody places two bombs in a row
+static MatchState::Action predict_rollback_input(const RollbackSession& session, const uint32_t peer_index) {
+  const uint32_t received_frame_count = session.received_frame_counts[peer_index];
+  if (received_frame_count == 0) return MatchState::Action::Wait;
+
+  const MatchState::Action last_action = session.inputs[(received_frame_count - 1) % RollbackSession::frame_ring_size][peer_index];
+  return (last_action == MatchState::Action::PlaceBomb) ? MatchState::Action::Wait : last_action;
+}
+
+// steps the snapshot of frame into the next one with the inputs received so far and predictions for the rest
+static void step_rollback_frame(RollbackSession& session, const uint32_t frame) {
+  MatchState::Action* const frame_inputs = session.inputs[frame % RollbackSession::frame_ring_size];
+  for (uint32_t i=0; i < session.peer_count; ++i) {
+    if (frame >= session.received_frame_counts[i]) frame_inputs[i] = predict_rollback_input(session, i);
+  }
+
+  MatchState& next_state = session.snapshots[(frame + 1) % RollbackSession::frame_ring_size];
+  next_state = session.snapshots[frame % RollbackSession::frame_ring_size];
+  step_match(next_state, frame_inputs);
+}
+
+void RollbackSession::init(const MatchState& start_state, const uint32_t peer_count, const uint32_t local_peer_index, const uint32_t input_delay_frames, const RollbackTransport& transport) {
+  assert( (peer_count <= max_peer_count) && (peer_count <= start_state.player_count) && (local_peer_index < peer_count) && (input_delay_frames <= max_input_delay_frames) );
+  this->peer_count         = peer_count;
+  this->local_peer_index   = local_peer_index;
+  this->input_delay_frames = input_delay_frames;
+  this->transport          = transport;
+  current_frame            = 0;
+  first_mispredicted_frame = no_frame;
+  confirmed_frame_count    = 0;
+  confirmed_checksum       = 0;
+  rollback_count           = 0;
+  resimulated_frame_count  = 0;
+
+  for (uint32_t i=0; i < max_peer_count; ++i) {
+    received_frame_counts[i]     = 0;
+    acknowledged_frame_counts[i] = 0;
+  }
+  received_frame_counts[local_peer_index] = input_delay_frames;  // the frames before the first local input wait
+  for (uint32_t frame=0; frame < frame_ring_size; ++frame) {
+    for (uint32_t i=0; i < MatchState::max_player_count; ++i) inputs[frame][i] = MatchState::Action::Wait;
+  }
+  snapshots.assign(frame_ring_size, start_state);
+}
+
+void RollbackSession::add_local_input(const MatchState::Action action) {
+  uint32_t& frame_count = received_frame_counts[local_peer_index];
+  assert(frame_count < (get_min_received_frame_count() + frame_ring_size));
+  inputs[frame_count % frame_ring_size][local_peer_index] = action;
+  ++frame_count;
+}
+
+void RollbackSession::poll() {
+  RollbackPacket packet;
+  while (transport.receive(transport.context, packet)) {
+    const uint32_t peer_index = packet.sender_peer_index;
+    if ( (peer_index >= peer_count) || (peer_index == local_peer_index) ) continue;
+
+    acknowledged_frame_counts[peer_index] = std::max(acknowledged_frame_counts[peer_index], packet.acknowledged_frame_count);
+    uint32_t& frame_count = received_frame_counts[peer_index];
+    if (packet.first_frame > frame_count) continue;  // something before it is still missing, the next packet starts early enough again
+
+    for (uint32_t i=frame_count - packet.first_frame; i < packet.input_count; ++i) {
+      const uint32_t frame = packet.first_frame + i;
+      assert(frame < (get_min_received_frame_count() + frame_ring_size));
+      MatchState::Action& input = inputs[frame % frame_ring_size][peer_index];
+      if ( (frame < current_frame) && (input != packet.inputs[i]) ) first_mispredicted_frame = std::min(first_mispredicted_frame, frame);
+      input = packet.inputs[i];
+      ++frame_count;
+    }
+  }
+}
+
+void RollbackSession::synchronize() {
+  if (first_mispredicted_frame < current_frame) {
+    for (uint32_t frame=first_mispredicted_frame; frame < current_frame; ++frame) step_rollback_frame(*this, frame);
+    ++rollback_count;
+    resimulated_frame_count += current_frame - first_mispredicted_frame;
+  }
+  first_mispredicted_frame = no_frame;
+
+  const uint32_t last_final_frame = std::min(get_min_received_frame_count(), current_frame);  // every input before it is known
+  for (; confirmed_frame_count <= last_final_frame; ++confirmed_frame_count) {
+    confirmed_checksum = (confirmed_checksum * 0x100000001b3ull) ^ snapshots[confirmed_frame_count % frame_ring_size].compute_checksum();
+  }
+}
+
+bool RollbackSession::advance_frame() {
+  synchronize();
+  if (received_frame_counts[local_peer_index] <= current_frame) return false;
+  if (current_frame >= (get_min_received_frame_count() + max_prediction_frames)) return false;
+
+  step_rollback_frame(*this, current_frame);
+  ++current_frame;
+  return true;
+}
+
+void RollbackSession::send() {
+  const uint32_t local_frame_count = received_frame_counts[local_peer_index];
+  const uint32_t oldest_frame      = (local_frame_count > frame_ring_size) ? (local_frame_count - frame_ring_size) : 0;  // older local inputs have been overwritten
+
+  RollbackPacket packet;
+  memset(&packet, 0, sizeof(packet));
+  packet.sender_peer_index = static_cast<uint8_t>(local_peer_index);
+  for (uint32_t peer_index=0; peer_index < peer_count; ++peer_index) {
+    if (peer_index == local_peer_index) continue;
+
+    packet.acknowledged_frame_count = received_frame_counts[peer_index];
+    packet.first_frame              = std::max(acknowledged_frame_counts[peer_index], oldest_frame);
+    packet.input_count              = static_cast<uint8_t>(std::min(local_frame_count - packet.first_frame, RollbackPacket::max_input_count));
+    for (uint32_t i=0; i < packet.input_count; ++i) {
+      packet.inputs[i] = inputs[(packet.first_frame + i) % frame_ring_size][local_peer_index];
+    }
+    transport.send(transport.context, peer_index, packet);
+  }
+}
+
+uint32_t RollbackSession::get_min_received_frame_count() const {
+  uint32_t min_frame_count = received_frame_counts[0];
+  for (uint32_t i=1; i < peer_count; ++i) min_frame_count = std::min(min_frame_count, received_frame_counts[i]);
+  return min_frame_count;
+}
+
+static void send_loopback_packet(void* context, const uint32_t to_peer_index, const RollbackPacket& packet) {
+  LoopbackNetwork& network = *static_cast<LoopbackNetwork::Endpoint*>(context)->network;
+  ++network.sent_packet_count;
+  if (network.random.next_below(100) < network.loss_percentage) {
+    ++network.lost_packet_count;
+    return;
+  }
+
+  const uint64_t delay_microseconds = network.latency_microseconds + network.random.next_below(network.jitter_microseconds + 1);
+  network.deliveries.push_back({ network.time_microseconds + delay_microseconds, to_peer_index, packet });
+}
+
+static bool receive_loopback_packet(void* context, RollbackPacket& packet) {
+  const LoopbackNetwork::Endpoint& endpoint = *static_cast<LoopbackNetwork::Endpoint*>(context);
+  std::vector<LoopbackNetwork::Delivery>& deliveries = endpoint.network->deliveries;
+  for (size_t i=0; i < deliveries.size(); ++i) {
+    if ( (deliveries[i].to_peer_index == endpoint.peer_index) && (deliveries[i].arrival_time_microseconds <= endpoint.network->time_microseconds) ) {
+      packet = deliveries[i].packet;
+      deliveries.erase(deliveries.begin() + i);
+      return true;
+    }
+  }
+  return false;
+}
+
+void LoopbackNetwork::init(const uint32_t latency_microseconds, const uint32_t jitter_microseconds, const uint32_t loss_percentage, const uint64_t seed) {
+  this->latency_microseconds = latency_microseconds;
+  this->jitter_microseconds  = jitter_microseconds;
+  this->loss_percentage      = loss_percentage;
+  time_microseconds          = 0;
+  sent_packet_count          = 0;
+  lost_packet_count          = 0;
+  random.seed(seed, 2);
+  deliveries.clear();
+}
+
+RollbackTransport LoopbackNetwork::get_transport(const uint32_t peer_index) {
+  endpoints[peer_index] = { this, peer_index };
+  return { &endpoints[peer_index], send_loopback_packet, receive_loopback_packet };
+}
+
+#endif  // TOM_ENGINE_ROLLBACK_IMPLEMENTATION_SINGLE
+#endif  // TOM_ENGINE_ROLLBACK_IMPLEMENTATION
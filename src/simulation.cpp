@@ -1,10 +1,11 @@
 #include "tom_engine.h"
+#include <algorithm>
+#include <bit>
 #include <cstdlib>
 #include <time.h>
-#include <bitset>
+#include <vector>
 
-constexpr float global_scale    = 0.25f;
-constexpr uint32_t player_count = 4;
+constexpr float global_scale = 0.25f;
 
 struct HandControllers {
   GraphicsMeshInstanceArray mesh_instance_array;
@@ -59,8 +60,8 @@ struct Bomb {
   float current_scale_factor   = min_scale_factor;
   float scale_sign             = 1.0f;
 
-  void update() {
-    const float scale_magnitude = fmod(speed * delta_time_seconds, max_scale_factor);
+  void update(const float elapsed_seconds=0.0f) {
+    const float scale_magnitude = fmod(speed * elapsed_seconds, max_scale_factor);
     scale_sign = (  1.0f * static_cast<float>((scale_sign == 1.0f)  && (this->current_scale_factor + scale_magnitude) <= max_scale_factor) ) +
                  (  1.0f * static_cast<float>((scale_sign == -1.0f) && (this->current_scale_factor - scale_magnitude) < min_scale_factor)  ) +
                  ( -1.0f * static_cast<float>((scale_sign == 1.0f)  && (this->current_scale_factor + scale_magnitude) > max_scale_factor)  ) +
@@ -82,11 +83,11 @@ struct Fire {
   const float max_scale_factor = 0.15f;
   const float speed            = 0.11f;
   static constexpr float scale = 0.145f;
-  float current_y_scale_factor = lerp(min_scale_factor, max_scale_factor, float(rand() % 10) / 10.0f);
+  float current_y_scale_factor = min_scale_factor;  // randomized by the board so it is reproducible from the seed
   float scale_sign             = -1.0f;
 
-  void update() {
-    const float scale_magnitude = fmod(speed * delta_time_seconds, max_scale_factor);
+  void update(const float elapsed_seconds=0.0f) {
+    const float scale_magnitude = fmod(speed * elapsed_seconds, max_scale_factor);
     scale_sign = (  1.0f * static_cast<float>((scale_sign == 1.0f)  && (this->current_y_scale_factor + scale_magnitude) <= max_scale_factor) ) +
                  (  1.0f * static_cast<float>((scale_sign == -1.0f) && (this->current_y_scale_factor - scale_magnitude) < min_scale_factor)  ) +
                  ( -1.0f * static_cast<float>((scale_sign == 1.0f)  && (this->current_y_scale_factor + scale_magnitude) > max_scale_factor)  ) +
@@ -113,56 +114,131 @@ struct BrickBlock {
   }
 };
 
-struct StoneBlock {
+struct StoneBlock {  // never moves on the board, drawn from the board's static batches
   Vector3f position;
   Quaternionf orientation;
   uint32_t material_id;
-  GraphicsMeshInstanceArray mesh_instance_array;
   static constexpr float scale = 0.05f;
 
-  void update() {
-    Transform transform = {this->position,this->orientation,{scale * global_scale, scale * global_scale, scale * global_scale}};
-    for (uint32_t i=0; i < this->mesh_instance_array.size; ++i) update_graphics_mesh_instance_array(this->mesh_instance_array, transform, material_id, uint32_t(-1), i);
+  GraphicsStaticInstance get_static_instance() const {
+    return { {this->position,this->orientation,{scale * global_scale, scale * global_scale, scale * global_scale}}, material_id };
   }
 };
 
-struct FloorWallBlock {
+struct FloorWallBlock {  // never moves on the board, drawn from the board's static batches
   Vector3f position;
   Quaternionf orientation;
   uint32_t material_id;
-  GraphicsMeshInstanceArray mesh_instance_array;
   static constexpr float scale = 0.1f;
 
-  void update() {
-    Transform transform = {this->position,this->orientation,{scale * global_scale, scale * global_scale, scale * global_scale}};
-    for (uint32_t i=0; i < this->mesh_instance_array.size; ++i) update_graphics_mesh_instance_array(this->mesh_instance_array, transform, material_id, uint32_t(-1), i);
+  GraphicsStaticInstance get_static_instance() const {
+    return { {this->position,this->orientation,{scale * global_scale, scale * global_scale, scale * global_scale}}, material_id };
+  }
+};
+
+struct TileBits { // one bit per floor tile in tile index order, 64 tiles to a word
+  std::vector<uint64_t> words;
+
+  void resize(const size_t tile_count)     { words.assign((tile_count + 63) / 64, 0); }
+  void clear()                             { std::fill(words.begin(), words.end(), 0); }
+  bool test(const size_t tile_index) const { return (words[tile_index >> 6] >> (tile_index & 63)) & 1; }
+  void set(const size_t tile_index)        { words[tile_index >> 6] |= (uint64_t(1) << (tile_index & 63)); }
+  void reset(const size_t tile_index)      { words[tile_index >> 6] &= ~(uint64_t(1) << (tile_index & 63)); }
+
+  // first tile at or after first_tile_index that is set in either, words.size() * 64 when there is none so empty stretches of the board are skipped 64 tiles at a time
+  static size_t find_next_in_either(const TileBits& a, const TileBits& b, const size_t first_tile_index) {
+    size_t word_index = first_tile_index >> 6;
+    if (word_index >= a.words.size()) return a.words.size() * 64;
+
+    uint64_t word = (a.words[word_index] | b.words[word_index]) & (~uint64_t(0) << (first_tile_index & 63));
+    while (word == 0) {
+      if (++word_index == a.words.size()) return a.words.size() * 64;
+      word = a.words[word_index] | b.words[word_index];
+    }
+    return (word_index << 6) + std::countr_zero(word);
+  }
+};
+
+struct TimerWheel { // events are ids below event_count that are scheduled at most once, each slot is an intrusive list so scheduling and cancelling are O(1)
+  static constexpr uint32_t no_event = -1;
+  static constexpr uint64_t no_tick  = -1;
+
+  uint64_t slot_mask;
+  std::vector<uint32_t> first_slot_events;
+  std::vector<uint32_t> next_events;
+  std::vector<uint32_t> previous_events;
+  std::vector<uint64_t> due_ticks; // no_tick when the event isn't scheduled
+
+  void reset(const uint32_t event_count, const uint32_t max_delay_ticks) { // there are more slots than the longest delay so a slot only holds events due on the same tick
+    slot_mask = std::bit_ceil(uint64_t(max_delay_ticks) + 1) - 1;
+    first_slot_events.assign(slot_mask + 1, no_event);
+    next_events.assign(event_count, no_event);
+    previous_events.assign(event_count, no_event);
+    due_ticks.assign(event_count, no_tick);
+  }
+
+  bool is_scheduled(const uint32_t event) const {
+    return due_ticks[event] != no_tick;
+  }
+
+  void cancel(const uint32_t event) {
+    if (!is_scheduled(event)) return;
+    if (previous_events[event] != no_event) next_events[previous_events[event]]                 = next_events[event];
+    else                                    first_slot_events[due_ticks[event] & slot_mask] = next_events[event];
+    if (next_events[event] != no_event)     previous_events[next_events[event]]                 = previous_events[event];
+    due_ticks[event] = no_tick;
+  }
+
+  void schedule(const uint32_t event, const uint64_t due_tick) {
+    cancel(event);
+    const uint64_t slot_index = due_tick & slot_mask;
+    due_ticks[event]       = due_tick;
+    previous_events[event] = no_event;
+    next_events[event]     = first_slot_events[slot_index];
+    if (next_events[event] != no_event) previous_events[next_events[event]] = event;
+    first_slot_events[slot_index] = event;
+  }
+
+  uint32_t pop_due(const uint64_t tick) { // no_event once every event due on tick has been popped
+    const uint32_t event = first_slot_events[tick & slot_mask];
+    if (event != no_event) cancel(event);
+    return event;
   }
 };
 
 struct Board {
   enum class TileState : uint8_t { Stone, Brick, Bomb, Fire, Empty };
 
-  static constexpr size_t height                 = 13;
-  static constexpr size_t width                  = 15;
-  static constexpr float block_offset            = 0.1f * global_scale;
-  static constexpr size_t floor_wall_block_count = (height * width) + (height * 2) + (width * 2) - 4;
-  static constexpr size_t floor_row_count        = height - 2;
-  static constexpr size_t floor_column_count     = width - 2;
-  static constexpr Vector3f hide_position        = { 1000000.0f, 1000000.0f, 1000000.0f };
+  static constexpr float block_offset     = 0.1f * global_scale;
+  static constexpr uint32_t floor_wall_blocks_per_chunk = 64;
+  static constexpr uint32_t stones_per_chunk            = 8;
 
+  size_t height = 13; // dimensions include the outer walls and are set by init
+  size_t width  = 15;
+  size_t floor_wall_block_count;
+  size_t floor_row_count;
+  size_t floor_column_count;
+  size_t tile_count;
+
+  // positions on the board are in the board's own space where it was built, moving the board only moves its root transform
   Vector3f first_block_position = {0.0f, 1.0f, 1.0f}; // position of top left floor block
   Vector3f first_floor_position; // position of top left floor block
-  Vector3f player_1_start_position;
-  Vector3f player_2_start_position;
-  Vector3f player_3_start_position;
-  Vector3f player_4_start_position;
-
-  FloorWallBlock floor_wall_blocks[floor_wall_block_count];
-  StoneBlock all_stones[ (floor_row_count / 2) * (floor_column_count / 2) ];
-  BrickBlock all_bricks[floor_row_count * floor_column_count];
-  Bomb all_bombs[floor_row_count * floor_column_count];
-  Fire all_fire[floor_row_count * floor_column_count];
-  TileState tile_states[floor_row_count * floor_column_count];
+  Vector3f root_translation = {0.0f, 0.0f, 0.0f};
+  uint32_t root_transform_parent_id;
+  std::vector<uint32_t> player_start_tile_indexes;
+  std::vector<Vector3f> player_start_positions;
+
+  std::vector<FloorWallBlock> floor_wall_blocks;
+  std::vector<StoneBlock> all_stones;
+  GraphicsMeshInstanceArray floor_wall_batch;
+  GraphicsMeshInstanceArray stone_batch;
+  std::vector<BrickBlock> all_bricks;
+  std::vector<Bomb> all_bombs;
+  std::vector<Fire> all_fire;
+  std::vector<TileState> tile_states;
+  TileBits tile_state_bits[static_cast<size_t>(TileState::Empty)]; // a bitplane per state except empty, always changed together with tile_states by set_tile_state
+  std::vector<bool> is_tile_in_player_spawn_space;
+  DistanceField brick_spot_distances; // steps to the closest spot next to a brick, stones and bricks block the way
 
   uint32_t wall_material_id;
   uint32_t floor_1_material_id;
@@ -172,11 +248,21 @@ struct Board {
   uint32_t brick_material_id_1;
   uint32_t bomb_material_id;
   uint32_t fire_material_id;
+  tom::Random random;
+
+  const TileBits& get_tile_bits(const TileState state) const {
+    return tile_state_bits[static_cast<size_t>(state)];
+  }
+
+  void set_tile_state(const size_t tile_index, const TileState state) {
+    if (tile_states[tile_index] != TileState::Empty) tile_state_bits[static_cast<size_t>(tile_states[tile_index])].reset(tile_index);
+    if (state != TileState::Empty)                   tile_state_bits[static_cast<size_t>(state)].set(tile_index);
+    tile_states[tile_index] = state;
+  }
 
   void reset_tile_states() {
-    for (size_t tile_index=0; tile_index < std::size(tile_states); ++tile_index) {
-      tile_states[tile_index] = TileState::Empty;
-    }
+    std::fill(tile_states.begin(), tile_states.end(), TileState::Empty);
+    for (TileBits& bits : tile_state_bits) bits.clear();
 
     for (size_t i=0; i < std::size(all_bricks); ++i) { hide_brick(i); }
     for (size_t i=0; i < std::size(all_bombs); ++i)  { hide_bomb(i);  }
@@ -184,42 +270,73 @@ struct Board {
 
     for (size_t row_index=1; row_index < floor_row_count; row_index+=2) {
       for (size_t column_index=1; column_index < floor_column_count; column_index+=2) {
-        tile_states[(row_index * floor_column_count) + column_index] = TileState::Stone;
+        set_tile_state((row_index * floor_column_count) + column_index, TileState::Stone);
       }
     }
 
-    static_assert( (floor_row_count == 11) && (floor_column_count == 13) ); // if fails then update is_tile_in_player_spawn_space
-    srand(static_cast<unsigned int>(time(NULL)));
     for (size_t tile_index=0; tile_index < std::size(tile_states); ++tile_index) {
-      bool is_tile_in_player_spawn_space = (tile_index == 0)   || (tile_index == 1)   || (tile_index == 13)
-                                        || (tile_index == 11)  || (tile_index == 12)  || (tile_index == 25)
-                                        || (tile_index == 130) || (tile_index == 117) || (tile_index == 131)
-                                        || (tile_index == 129) || (tile_index == 141) || (tile_index == 142);
       bool is_tile_stone = tile_states[tile_index] == TileState::Stone;
-      if ( is_tile_stone || is_tile_in_player_spawn_space ) continue;
+      if ( is_tile_stone || is_tile_in_player_spawn_space[tile_index] ) continue;
 
-      const int random_number = (rand() % 10 + 1);
+      const int random_number = static_cast<int>(random.next_below(10)) + 1;
       if (random_number <= 6) {
-        tile_states[tile_index] = TileState::Brick;
+        set_tile_state(tile_index, TileState::Brick);
         show_brick(tile_index);
       }
     }
+
+    for (size_t tile_index=0; tile_index < tile_count; ++tile_index) {
+      brick_spot_distances.set_tile_walkable(static_cast<uint32_t>(tile_index), (tile_states[tile_index] != TileState::Stone) && (tile_states[tile_index] != TileState::Brick));
+      brick_spot_distances.set_tile_source(static_cast<uint32_t>(tile_index), is_brick_spot(tile_index));
+    }
+    brick_spot_distances.rebuild();
+  }
+
+  bool is_brick_spot(const size_t tile_index) const { // a bomb here would clear a brick
+    if ( (tile_states[tile_index] == TileState::Stone) || (tile_states[tile_index] == TileState::Brick) ) return false;
+    const size_t row_index    = calculate_row_index_from_tile_index(tile_index);
+    const size_t column_index = calculate_column_index_from_tile_index(tile_index);
+    return ( (row_index > 0)                           && (tile_states[tile_index - floor_column_count] == TileState::Brick) ) ||
+           ( (row_index < (floor_row_count - 1))       && (tile_states[tile_index + floor_column_count] == TileState::Brick) ) ||
+           ( (column_index > 0)                        && (tile_states[tile_index - 1] == TileState::Brick) )                  ||
+           ( (column_index < (floor_column_count - 1)) && (tile_states[tile_index + 1] == TileState::Brick) );
+  }
+
+  void destroy_brick(const size_t tile_index) { // only the brick's tile and its neighbours change so the distance field is updated around them instead of rebuilt
+    set_tile_state(tile_index, TileState::Empty);
+    hide_brick(tile_index);
+    brick_spot_distances.open_tile(static_cast<uint32_t>(tile_index));
+
+    auto update_brick_spot = [&](const size_t spot_tile_index) {
+      const bool is_spot = is_brick_spot(spot_tile_index);
+      if (is_spot == brick_spot_distances.is_tile_source[spot_tile_index]) return;
+      if (is_spot) brick_spot_distances.add_source(static_cast<uint32_t>(spot_tile_index));
+      else         brick_spot_distances.remove_source(static_cast<uint32_t>(spot_tile_index));
+    };
+    const size_t row_index    = calculate_row_index_from_tile_index(tile_index);
+    const size_t column_index = calculate_column_index_from_tile_index(tile_index);
+    update_brick_spot(tile_index);
+    if (row_index > 0)                           update_brick_spot(tile_index - floor_column_count);
+    if (row_index < (floor_row_count - 1))       update_brick_spot(tile_index + floor_column_count);
+    if (column_index > 0)                        update_brick_spot(tile_index - 1);
+    if (column_index < (floor_column_count - 1)) update_brick_spot(tile_index + 1);
+    assert(brick_spot_distances.is_consistent());
   }
 
-  static size_t calculate_row_index_from_tile_index(const size_t tile_index) {
+  size_t calculate_row_index_from_tile_index(const size_t tile_index) const {
     return tile_index / floor_column_count;
   }
 
-  static size_t calculate_column_index_from_tile_index(const size_t tile_index) {
+  size_t calculate_column_index_from_tile_index(const size_t tile_index) const {
     return tile_index % floor_column_count;
   }
 
   Vector3f calculate_top_right_block_position() {
-    return { first_block_position.x + (14.0f * block_offset), first_block_position.y, first_block_position.z };
+    return { first_block_position.x + ((float)(width - 1) * block_offset), first_block_position.y, first_block_position.z };
   }
 
   Vector3f calculate_bottom_left_block_position() {
-    return { first_block_position.x, first_block_position.y, first_block_position.z + (12.0f * block_offset) };
+    return { first_block_position.x, first_block_position.y, first_block_position.z + ((float)(height - 1) * block_offset) };
   }
 
   void show_brick(const size_t tile_index) {
@@ -227,47 +344,96 @@ struct Board {
     const size_t column_index       = calculate_column_index_from_tile_index(tile_index);
     all_bricks[tile_index].position = { first_floor_position.x + ((float)column_index * block_offset), first_floor_position.y + block_offset, first_floor_position.z + ((float)row_index * block_offset) };
     all_bricks[tile_index].update();
+    set_graphics_mesh_instance_array_visibility(all_bricks[tile_index].mesh_instance_array, true);
   }
 
   void hide_brick(const size_t tile_index) {
-    all_bricks[tile_index].position = Board::hide_position;
-    all_bricks[tile_index].update();
+    set_graphics_mesh_instance_array_visibility(all_bricks[tile_index].mesh_instance_array, false);
   }
 
   void show_bomb(const size_t tile_index) {
     const size_t row_index    = calculate_row_index_from_tile_index(tile_index);
     const size_t column_index = calculate_column_index_from_tile_index(tile_index);
-    tile_states[tile_index]   = TileState::Bomb;
+    set_tile_state(tile_index, TileState::Bomb);
     all_bombs[tile_index].position = { first_floor_position.x + ((float)column_index * block_offset), first_floor_position.y + (block_offset / 2.0f), first_floor_position.z + ((float)row_index * block_offset) };
     all_bombs[tile_index].update();
+    set_graphics_mesh_instance_array_visibility(all_bombs[tile_index].mesh_instance_array, true);
   }
 
   void hide_bomb(const size_t tile_index) {
-    tile_states[tile_index]        = TileState::Empty;
-    all_bombs[tile_index].position = Board::hide_position;
-    all_bombs[tile_index].update();
+    set_tile_state(tile_index, TileState::Empty);
+    set_graphics_mesh_instance_array_visibility(all_bombs[tile_index].mesh_instance_array, false);
   }
 
   void show_fire(const size_t tile_index) {
     const size_t row_index    = calculate_row_index_from_tile_index(tile_index);
     const size_t column_index = calculate_column_index_from_tile_index(tile_index);
-    tile_states[tile_index]   = TileState::Fire;
+    set_tile_state(tile_index, TileState::Fire);
     all_fire[tile_index].position = { first_floor_position.x + ((float)column_index * block_offset), first_floor_position.y + (block_offset / 2.0f) - 0.005f, first_floor_position.z + ((float)row_index * block_offset) };
     all_fire[tile_index].update();
+    set_graphics_mesh_instance_array_visibility(all_fire[tile_index].mesh_instance_array, true);
   }
 
   void hide_fire(const size_t tile_index) {
-    tile_states[tile_index]       = TileState::Empty;
-    all_fire[tile_index].position = Board::hide_position;
-    all_fire[tile_index].update();
+    set_tile_state(tile_index, TileState::Empty);
+    set_graphics_mesh_instance_array_visibility(all_fire[tile_index].mesh_instance_array, false);
   }
 
-  Vector3f calculate_player_1_start_position() { return {first_floor_position.x - (block_offset / 2.5f), first_block_position.y + (block_offset / 2.0f), first_floor_position.z}; }
-  Vector3f calculate_player_2_start_position() { return {first_floor_position.x + (block_offset * 12.0f) - (block_offset / 2.5f), first_block_position.y + (block_offset / 2.0f), first_floor_position.z}; }
-  Vector3f calculate_player_3_start_position() { return {first_floor_position.x - (block_offset / 2.5f), first_block_position.y + (block_offset / 2.0f), first_floor_position.z + (block_offset * 10.0f)}; }
-  Vector3f calculate_player_4_start_position() { return {first_floor_position.x + (block_offset * 12.0f) - (block_offset / 2.5f), first_block_position.y + (block_offset / 2.0f), first_floor_position.z + (block_offset * 10.0f)}; }
+  Vector3f calculate_player_start_position(const size_t tile_index) {
+    const size_t row_index    = calculate_row_index_from_tile_index(tile_index);
+    const size_t column_index = calculate_column_index_from_tile_index(tile_index);
+    return {first_floor_position.x + (block_offset * (float)column_index) - (block_offset / 2.5f), first_block_position.y + (block_offset / 2.0f), first_floor_position.z + (block_offset * (float)row_index)};
+  }
+
+  // players are spread over an even grid of tiles with even row and column indexes (never a stone) starting from the corners, for 4 players these are the 4 corners
+  // the spawn space is the start tile and its neighbours so every player can place a bomb and step out of the blast
+  void create_player_start_tiles(const uint32_t player_count) {
+    const size_t even_row_count     = (floor_row_count + 1) / 2;
+    const size_t even_column_count  = (floor_column_count + 1) / 2;
+    const size_t spawn_column_count = std::min(static_cast<size_t>(ceil(sqrt(static_cast<float>(player_count)))), even_column_count);
+    const size_t spawn_row_count    = (player_count + spawn_column_count - 1) / spawn_column_count;
+    assert(spawn_row_count <= even_row_count); // too many players for the board size
+
+    auto spread = [](const size_t index, const size_t count, const size_t even_count) -> size_t {
+      if (count == 1) return 0;
+      return 2 * ( ((index * (even_count - 1)) + ((count - 1) / 2)) / (count - 1) );
+    };
+
+    player_start_tile_indexes.resize(player_count);
+    is_tile_in_player_spawn_space.assign(tile_count, false);
+    for (uint32_t player_index=0; player_index < player_count; ++player_index) {
+      const size_t row_index    = spread(player_index / spawn_column_count, spawn_row_count, even_row_count);
+      const size_t column_index = spread(player_index % spawn_column_count, spawn_column_count, even_column_count);
+      const size_t tile_index   = (row_index * floor_column_count) + column_index;
+      player_start_tile_indexes[player_index] = static_cast<uint32_t>(tile_index);
+
+      is_tile_in_player_spawn_space[tile_index] = true;
+      if (row_index > 0)                            is_tile_in_player_spawn_space[tile_index - floor_column_count] = true;
+      if (row_index < (floor_row_count - 1))        is_tile_in_player_spawn_space[tile_index + floor_column_count] = true;
+      if (column_index > 0)                         is_tile_in_player_spawn_space[tile_index - 1]                  = true;
+      if (column_index < (floor_column_count - 1))  is_tile_in_player_spawn_space[tile_index + 1]                  = true;
+    }
+  }
+
+  void init(const size_t width, const size_t height, const uint32_t player_count) {
+    assert( (width >= 5) && (height >= 5) );
+    this->width              = width;
+    this->height             = height;
+    floor_wall_block_count   = (height * width) + (height * 2) + (width * 2) - 4;
+    floor_row_count          = height - 2;
+    floor_column_count       = width - 2;
+    tile_count               = floor_row_count * floor_column_count;
+
+    floor_wall_blocks.resize(floor_wall_block_count);
+    all_stones.resize( (floor_row_count / 2) * (floor_column_count / 2) );
+    all_bricks.resize(tile_count);
+    all_bombs.resize(tile_count);
+    all_fire.resize(tile_count);
+    tile_states.assign(tile_count, TileState::Empty);
+    for (TileBits& bits : tile_state_bits) bits.resize(tile_count);
+    brick_spot_distances.init(static_cast<uint32_t>(floor_column_count), static_cast<uint32_t>(floor_row_count));
+    create_player_start_tiles(player_count);
 
-  void init() {
     this->wall_material_id    = create_graphics_material(Vector4f{0.27843f, 0.27451f, 0.2549f, 1.0f}, 0.6f, 0.7f);
     this->floor_1_material_id = create_graphics_material(Vector4f{0.22353f, 0.43922f, 0.1451f, 1.0f}, 0.0f, 0.9f);
     this->floor_2_material_id = create_graphics_material(Vector4f{0.27843f, 0.52941f, 0.18039f, 1.0f}, 0.0f, 0.9f);
@@ -280,67 +446,50 @@ struct Board {
     size_t floor_wall_blocks_index = 0;
 
     /* create walls */
-    static_assert( (floor_row_count == 11) && (floor_column_count == 13) ); // if fails then update create walls
     const Vector3f top_right_block_position   = calculate_top_right_block_position();
     const Vector3f bottom_left_block_position = calculate_bottom_left_block_position();
     for (size_t i=0; i < width; ++i) {
       floor_wall_blocks[floor_wall_blocks_index].orientation = identity_orientation;
       floor_wall_blocks[floor_wall_blocks_index].position    = { first_block_position.x + ((float)i * block_offset), first_block_position.y, first_block_position.z };
       floor_wall_blocks[floor_wall_blocks_index].material_id = wall_material_id;
-      create_graphics_mesh_instance_array_from_glb("assets/models/cube.glb", floor_wall_blocks[floor_wall_blocks_index].mesh_instance_array);
-      floor_wall_blocks[floor_wall_blocks_index].update();
       ++floor_wall_blocks_index;
 
       floor_wall_blocks[floor_wall_blocks_index].orientation = identity_orientation;
       floor_wall_blocks[floor_wall_blocks_index].position    = { first_block_position.x + ((float)i * block_offset), first_block_position.y + block_offset, first_block_position.z };
       floor_wall_blocks[floor_wall_blocks_index].material_id = wall_material_id;
-      create_graphics_mesh_instance_array_from_glb("assets/models/cube.glb", floor_wall_blocks[floor_wall_blocks_index].mesh_instance_array);
-      floor_wall_blocks[floor_wall_blocks_index].update();
       ++floor_wall_blocks_index;
     }
     for (size_t i=1; i < height; ++i) {
       floor_wall_blocks[floor_wall_blocks_index].orientation = identity_orientation;
       floor_wall_blocks[floor_wall_blocks_index].position    = { first_block_position.x, first_block_position.y, first_block_position.z + (i * block_offset) };
       floor_wall_blocks[floor_wall_blocks_index].material_id = wall_material_id;
-      create_graphics_mesh_instance_array_from_glb("assets/models/cube.glb", floor_wall_blocks[floor_wall_blocks_index].mesh_instance_array);
-      floor_wall_blocks[floor_wall_blocks_index].update();
       ++floor_wall_blocks_index;
 
       floor_wall_blocks[floor_wall_blocks_index].orientation = identity_orientation;
       floor_wall_blocks[floor_wall_blocks_index].position    = { first_block_position.x, first_block_position.y + block_offset, first_block_position.z + ((float)i * block_offset) };
       floor_wall_blocks[floor_wall_blocks_index].material_id = wall_material_id;
-      create_graphics_mesh_instance_array_from_glb("assets/models/cube.glb", floor_wall_blocks[floor_wall_blocks_index].mesh_instance_array);
-      floor_wall_blocks[floor_wall_blocks_index].update();
       ++floor_wall_blocks_index;
     }
-    for (size_t i=1; i < 13; ++i) {
+    for (size_t i=1; i < height; ++i) {
       floor_wall_blocks[floor_wall_blocks_index].orientation = identity_orientation;
       floor_wall_blocks[floor_wall_blocks_index].position    = { top_right_block_position.x, top_right_block_position.y, top_right_block_position.z + ((float)i * block_offset) };
       floor_wall_blocks[floor_wall_blocks_index].material_id = wall_material_id;
-      create_graphics_mesh_instance_array_from_glb("assets/models/cube.glb", floor_wall_blocks[floor_wall_blocks_index].mesh_instance_array);
-      floor_wall_blocks[floor_wall_blocks_index].update();
       ++floor_wall_blocks_index;
 
       floor_wall_blocks[floor_wall_blocks_index].orientation = identity_orientation;
       floor_wall_blocks[floor_wall_blocks_index].position    = { top_right_block_position.x, top_right_block_position.y + block_offset, top_right_block_position.z + ((float)i * block_offset) };
       floor_wall_blocks[floor_wall_blocks_index].material_id = wall_material_id;
-      create_graphics_mesh_instance_array_from_glb("assets/models/cube.glb", floor_wall_blocks[floor_wall_blocks_index].mesh_instance_array);
-      floor_wall_blocks[floor_wall_blocks_index].update();
       ++floor_wall_blocks_index;
     }
-    for (size_t i=1; i < 14; ++i) {
+    for (size_t i=1; i < (width - 1); ++i) {
       floor_wall_blocks[floor_wall_blocks_index].orientation = identity_orientation;
       floor_wall_blocks[floor_wall_blocks_index].position    = { bottom_left_block_position.x + ((float)i * block_offset), bottom_left_block_position.y, bottom_left_block_position.z };
       floor_wall_blocks[floor_wall_blocks_index].material_id = wall_material_id;
-      create_graphics_mesh_instance_array_from_glb("assets/models/cube.glb", floor_wall_blocks[floor_wall_blocks_index].mesh_instance_array);
-      floor_wall_blocks[floor_wall_blocks_index].update();
       ++floor_wall_blocks_index;
 
       floor_wall_blocks[floor_wall_blocks_index].orientation = identity_orientation;
       floor_wall_blocks[floor_wall_blocks_index].position    = { bottom_left_block_position.x + ((float)i * block_offset), bottom_left_block_position.y + block_offset, bottom_left_block_position.z };
       floor_wall_blocks[floor_wall_blocks_index].material_id = wall_material_id;
-      create_graphics_mesh_instance_array_from_glb("assets/models/cube.glb", floor_wall_blocks[floor_wall_blocks_index].mesh_instance_array);
-      floor_wall_blocks[floor_wall_blocks_index].update();
       ++floor_wall_blocks_index;
     }
 
@@ -351,8 +500,6 @@ struct Board {
         floor_wall_blocks[floor_wall_blocks_index].orientation = identity_orientation;
         floor_wall_blocks[floor_wall_blocks_index].position    = { first_floor_position.x + ((float)column_index * block_offset), first_floor_position.y, first_floor_position.z + ((float)row_index * block_offset) };
         floor_wall_blocks[floor_wall_blocks_index].material_id = ( !(row_index % 2) == !(column_index % 2) ) ? floor_1_material_id : floor_2_material_id;
-        create_graphics_mesh_instance_array_from_glb("assets/models/cube.glb", floor_wall_blocks[floor_wall_blocks_index].mesh_instance_array);
-        floor_wall_blocks[floor_wall_blocks_index].update();
         ++floor_wall_blocks_index;
       }
     }
@@ -364,8 +511,6 @@ struct Board {
         all_stones[stone_index].orientation = identity_orientation;
         all_stones[stone_index].position    = { first_floor_position.x + ((float)column_index * block_offset), first_floor_position.y + block_offset, first_floor_position.z + ((float)row_index * block_offset) };
         all_stones[stone_index].material_id = stone_material_id;
-        create_graphics_mesh_instance_array_from_glb("assets/models/block_rock.glb", all_stones[stone_index].mesh_instance_array);
-        all_stones[stone_index].update();
         ++stone_index;
       }
     }
@@ -387,6 +532,7 @@ struct Board {
 
         all_fire[tile_index].orientation = identity_orientation;
         all_fire[tile_index].material_id = fire_material_id;
+        all_fire[tile_index].current_y_scale_factor = lerp(all_fire[tile_index].min_scale_factor, all_fire[tile_index].max_scale_factor, float(random.next_below(10)) / 10.0f);
         create_graphics_mesh_instance_array_from_glb("assets/models/fire.glb", all_fire[tile_index].mesh_instance_array);
         this->hide_fire(tile_index);
 
@@ -394,107 +540,51 @@ struct Board {
       }
     }
 
-    player_1_start_position = calculate_player_1_start_position();
-    player_2_start_position = calculate_player_2_start_position();
-    player_3_start_position = calculate_player_3_start_position();
-    player_4_start_position = calculate_player_4_start_position();
-
-    reset_tile_states();
-  }
-
-  Vector3f move(const Vector3f& position) {
-    const Vector3f displacement = { position.x - this->first_block_position.x, position.y - this->first_block_position.y, position.z - this->first_block_position.z };
-    this->first_block_position = position;
-
-    size_t floor_wall_blocks_index = 0;
-
-    static_assert( (width == 15) && (height == 13) ); // if fails then update this method
-    const Vector3f top_right_block_position   = calculate_top_right_block_position();
-    const Vector3f bottom_left_block_position = calculate_bottom_left_block_position();
-    for (size_t i=0; i < 15; ++i) {
-      floor_wall_blocks[floor_wall_blocks_index].position = { first_block_position.x + ((float)i * block_offset), first_block_position.y, first_block_position.z };
-      ++floor_wall_blocks_index;
-
-      floor_wall_blocks[floor_wall_blocks_index].position = { first_block_position.x + ((float)i * block_offset), first_block_position.y + block_offset, first_block_position.z };
-      ++floor_wall_blocks_index;
-    }
-    for (size_t i=1; i < 13; ++i) {
-      floor_wall_blocks[floor_wall_blocks_index].position = { first_block_position.x, first_block_position.y, first_block_position.z + (i * block_offset) };
-      ++floor_wall_blocks_index;
-
-      floor_wall_blocks[floor_wall_blocks_index].position = { first_block_position.x, first_block_position.y + block_offset, first_block_position.z + ((float)i * block_offset) };
-      ++floor_wall_blocks_index;
-    }
-    for (size_t i=1; i < 13; ++i) {
-      floor_wall_blocks[floor_wall_blocks_index].orientation = identity_orientation;
-      floor_wall_blocks[floor_wall_blocks_index].position    = { top_right_block_position.x, top_right_block_position.y, top_right_block_position.z + ((float)i * block_offset) };
-      ++floor_wall_blocks_index;
-
-      floor_wall_blocks[floor_wall_blocks_index].position = { top_right_block_position.x, top_right_block_position.y + block_offset, top_right_block_position.z + ((float)i * block_offset) };
-      ++floor_wall_blocks_index;
-    }
-    for (size_t i=1; i < 14; ++i) {
-      floor_wall_blocks[floor_wall_blocks_index].position = { bottom_left_block_position.x + ((float)i * block_offset), bottom_left_block_position.y, bottom_left_block_position.z };
-      ++floor_wall_blocks_index;
-
-      floor_wall_blocks[floor_wall_blocks_index].position = { bottom_left_block_position.x + ((float)i * block_offset), bottom_left_block_position.y + block_offset, bottom_left_block_position.z };
-      ++floor_wall_blocks_index;
-    }
+    create_static_batches();
 
-    first_floor_position = { first_block_position.x + block_offset, first_block_position.y, first_block_position.z + block_offset };
-    for (size_t row_index=0; row_index < floor_row_count; ++row_index) {
-      for (size_t column_index=0; column_index < floor_column_count; ++column_index) {
-        floor_wall_blocks[floor_wall_blocks_index].position = { first_floor_position.x + ((float)column_index * block_offset), first_floor_position.y, first_floor_position.z + ((float)row_index * block_offset) };
-        ++floor_wall_blocks_index;
-      }
-    }
+    root_transform_parent_id = create_graphics_transform_parent();
+    set_graphics_mesh_instance_array_parent(floor_wall_batch, root_transform_parent_id);
+    set_graphics_mesh_instance_array_parent(stone_batch, root_transform_parent_id);
+    for (const BrickBlock& brick : all_bricks)            set_graphics_mesh_instance_array_parent(brick.mesh_instance_array, root_transform_parent_id);
+    for (const Bomb& bomb : all_bombs)                    set_graphics_mesh_instance_array_parent(bomb.mesh_instance_array, root_transform_parent_id);
+    for (const Fire& fire : all_fire)                     set_graphics_mesh_instance_array_parent(fire.mesh_instance_array, root_transform_parent_id);
 
-    size_t stone_index = 0;
-    for (size_t row_index=1; row_index < floor_row_count; row_index+=2) {
-      for (size_t column_index=1; column_index < floor_column_count; column_index+=2) {
-        all_stones[stone_index].position = { first_floor_position.x + ((float)column_index * block_offset), first_floor_position.y + block_offset, first_floor_position.z + ((float)row_index * block_offset) };
-        ++stone_index;
-      }
+    player_start_positions.resize(player_start_tile_indexes.size());
+    for (size_t i=0; i < player_start_tile_indexes.size(); ++i) {
+      player_start_positions[i] = calculate_player_start_position(player_start_tile_indexes[i]);
     }
 
-    size_t tile_index = 0;
-    for (size_t row_index=0; row_index < floor_row_count; ++row_index) {
-      for (size_t column_index=0; column_index < floor_column_count; ++column_index) {
-        switch (tile_states[tile_index]) {
-          case TileState::Brick: {
-            all_bricks[tile_index].position = { first_floor_position.x + ((float)column_index * block_offset), first_floor_position.y + block_offset, first_floor_position.z + ((float)row_index * block_offset) };
-            all_bricks[tile_index].update();
-            break;
-          }
-          case TileState::Bomb: {
-            all_bombs[tile_index].position = { first_floor_position.x + ((float)column_index * block_offset), first_floor_position.y + (block_offset / 2.0f), first_floor_position.z + ((float)row_index * block_offset) };
-            all_bombs[tile_index].update();
-            break;
-          }
-          case TileState::Fire: {
-            all_fire[tile_index].position = { first_floor_position.x + ((float)column_index * block_offset), first_floor_position.y + (block_offset / 2.0f) - 0.005f, first_floor_position.z + ((float)row_index * block_offset) };
-            all_fire[tile_index].update();
-            break;
-          }
-        }
-
-        ++tile_index;
-      }
-    }
+    reset_tile_states();
+  }
 
-    player_1_start_position = calculate_player_1_start_position();
-    player_2_start_position = calculate_player_2_start_position();
-    player_3_start_position = calculate_player_3_start_position();
-    player_4_start_position = calculate_player_4_start_position();
+  // the floor, walls and stones never move relative to the board so they are merged into a few big meshes once,
+  // blocks are sorted by row so every chunk covers a compact part of the board and is culled as one
+  void create_static_batches() {
+    auto is_before = [](const GraphicsStaticInstance& a, const GraphicsStaticInstance& b) {
+      if (a.transform.position.z != b.transform.position.z) return a.transform.position.z < b.transform.position.z;
+      if (a.transform.position.x != b.transform.position.x) return a.transform.position.x < b.transform.position.x;
+      return a.transform.position.y < b.transform.position.y;
+    };
+
+    std::vector<GraphicsStaticInstance> instances;
+    instances.reserve(floor_wall_blocks.size());
+    for (const FloorWallBlock& block : floor_wall_blocks) instances.push_back(block.get_static_instance());
+    std::sort(instances.begin(), instances.end(), is_before);
+    create_graphics_static_batch_from_glb("assets/models/cube.glb", instances.data(), static_cast<uint32_t>(instances.size()), floor_wall_blocks_per_chunk, floor_wall_batch);
+
+    instances.clear();
+    for (const StoneBlock& stone : all_stones) instances.push_back(stone.get_static_instance());
+    std::sort(instances.begin(), instances.end(), is_before);
+    create_graphics_static_batch_from_glb("assets/models/block_rock.glb", instances.data(), static_cast<uint32_t>(instances.size()), stones_per_chunk, stone_batch);
+  }
 
-    for (size_t i=0; i < std::size(floor_wall_blocks); ++i) {
-      floor_wall_blocks[i].update();
-    }
-    for (size_t i=0; i < std::size(all_stones); ++i) {
-      all_stones[i].update();
-    }
+  void move(const Vector3f& position) {  // first_block_position follows the hand, every block and player stays where it is relative to the root
+    root_translation = { position.x - first_block_position.x, position.y - first_block_position.y, position.z - first_block_position.z };
+    update_graphics_transform_parent(root_transform_parent_id, { root_translation, identity_orientation, default_scale });
+  }
 
-    return displacement;
+  Vector3f calculate_global_position(const Vector3f& board_position) const {
+    return add_vectors(board_position, root_translation);
   }
 };
 
@@ -504,6 +594,7 @@ struct Bomberman {
   static constexpr uint32_t idle_animation_offset    = 1;
   static constexpr uint32_t running_animation_offset = 2;
   static constexpr uint32_t dancing_animation_offset = 3;
+  static constexpr uint32_t color_count              = 4;  // white, red, green and blue repeat in big arenas
 
   Transform transform;
   uint32_t material_id;
@@ -511,6 +602,7 @@ struct Bomberman {
   AnimationArray animations;
   uint32_t player_id;
   GlobalDirection current_direction;
+  Vector3f previous_position; // position at the start of the current tick for render interpolation
   static constexpr float scale = 0.00035f;
 
   void init(const uint32_t player_id) {
@@ -518,9 +610,9 @@ struct Bomberman {
     this->transform.orientation = identity_orientation;
     this->transform.position    = {0.0f,0.0f,0.0f};
     this->transform.scale       = {scale * global_scale, scale * global_scale, scale * global_scale};
-    this->current_direction     = ( (this->player_id == 0) || (this->player_id == 1) ) ? GlobalDirection::Down : GlobalDirection::Up;
+    this->current_direction     = GlobalDirection::Down; // faces away from the closest wall once MovementSystem places it
 
-    switch (this->player_id) {
+    switch (this->player_id % color_count) {
       case 0: {
         this->material_id = create_graphics_material(Vector4f{1.0f, 1.0f, 1.0f, 1.0f}, Vector3f{0.0f, 0.0f, 0.0f}, 0.0f, 1.0f, "assets/textures/bomberman.png");
         break;
@@ -549,8 +641,10 @@ struct Bomberman {
     this->skin.play_animation(this->animations.first_animation + idle_animation_offset, 1.0f, true);
   }
 
-  void update() {
-    Transform target_transform = {this->transform.position,this->transform.orientation, this->transform.scale};
+  void update(const float interpolation_alpha=1.0f) {
+    Vector3f previous = this->previous_position;
+    Vector3f current  = this->transform.position;
+    Transform target_transform = {lerp(previous, current, interpolation_alpha),this->transform.orientation, this->transform.scale};
 
     if (this->current_direction != GlobalDirection::Down) {
       Vector3f y_axis = { 0.0f, 1.0f, 0.0f };
@@ -580,108 +674,102 @@ struct Bomberman {
 };
 
 struct SoundSystem {
-  uint32_t place_bomb_sound_ids[player_count];
-  uint32_t explosion_sound_ids[player_count];
-  uint32_t win_sound_ids[player_count];
-  uint32_t death_sound_ids[player_count];
+  // announcements win over bombs for real voices, bombs are fired as extra voices of their source so they overlap however many go off
+  static constexpr float announcement_priority = 4.0f;
+  static constexpr float explosion_priority    = 1.0f;
+  static constexpr float place_bomb_priority   = 0.5f;
+
+  uint32_t place_bomb_sound_id;
+  uint32_t explosion_sound_id;
+  uint32_t win_sound_ids[Bomberman::color_count];
+  uint32_t death_sound_ids[Bomberman::color_count];
   uint32_t start_bell_sound_id;
   Board*   board_state;
-  Bomberman* players[player_count];
+  Bomberman* players;
 
-  void init(Board* const board_state, Bomberman* const player_1, Bomberman* const player_2, Bomberman* const player_3, Bomberman* const player_4) {
+  void init(Board* const board_state, Bomberman* const players) {
     this->board_state = board_state;
-    this->players[0]  = player_1;
-    this->players[1]  = player_2;
-    this->players[2]  = player_3;
-    this->players[3]  = player_4;
+    this->players     = players;
 
     const float attenuation_range_min_meters = 4.0f;
     const float attenuation_range_max_meters = 16.0f;
     const float radius_meters                = 0.0f;
     const float reverb_send_level            = 1.0f;
 
-    for (uint32_t i=0; i < player_count; ++i) {
-      place_bomb_sound_ids[i] = create_audio_source("assets/sounds/place_bomb.wav", attenuation_range_min_meters, attenuation_range_max_meters, radius_meters, reverb_send_level);
-      explosion_sound_ids[i]  = create_audio_source("assets/sounds/explosion.wav", attenuation_range_min_meters, attenuation_range_max_meters, radius_meters, reverb_send_level);
-    }
-
-    start_bell_sound_id = create_audio_source("assets/sounds/start_bell.wav", attenuation_range_min_meters, attenuation_range_max_meters, radius_meters, reverb_send_level);
-    win_sound_ids[0]    = create_audio_source("assets/sounds/white_win.wav", attenuation_range_min_meters, attenuation_range_max_meters, radius_meters, reverb_send_level);
-    win_sound_ids[1]    = create_audio_source("assets/sounds/red_win.wav", attenuation_range_min_meters, attenuation_range_max_meters, radius_meters, reverb_send_level);
-    win_sound_ids[2]    = create_audio_source("assets/sounds/green_win.wav", attenuation_range_min_meters, attenuation_range_max_meters, radius_meters, reverb_send_level);
-    win_sound_ids[3]    = create_audio_source("assets/sounds/blue_win.wav", attenuation_range_min_meters, attenuation_range_max_meters, radius_meters, reverb_send_level);
-    death_sound_ids[0]  = create_audio_source("assets/sounds/white_death.wav", attenuation_range_min_meters, attenuation_range_max_meters, radius_meters, reverb_send_level);
-    death_sound_ids[1]  = create_audio_source("assets/sounds/red_death.wav", attenuation_range_min_meters, attenuation_range_max_meters, radius_meters, reverb_send_level);
-    death_sound_ids[2]  = create_audio_source("assets/sounds/green_death.wav", attenuation_range_min_meters, attenuation_range_max_meters, radius_meters, reverb_send_level);
-    death_sound_ids[3]  = create_audio_source("assets/sounds/blue_death.wav", attenuation_range_min_meters, attenuation_range_max_meters, radius_meters, reverb_send_level);
+    place_bomb_sound_id = create_audio_source("assets/sounds/place_bomb.adpcm", attenuation_range_min_meters, attenuation_range_max_meters, radius_meters, reverb_send_level, false, place_bomb_priority);
+    explosion_sound_id  = create_audio_source("assets/sounds/explosion.adpcm", attenuation_range_min_meters, attenuation_range_max_meters, radius_meters, reverb_send_level, false, explosion_priority);
+    start_bell_sound_id = create_audio_source("assets/sounds/start_bell.adpcm", attenuation_range_min_meters, attenuation_range_max_meters, radius_meters, reverb_send_level, false, announcement_priority);
+    win_sound_ids[0]    = create_audio_source("assets/sounds/white_win.adpcm", attenuation_range_min_meters, attenuation_range_max_meters, radius_meters, reverb_send_level, false, announcement_priority);
+    win_sound_ids[1]    = create_audio_source("assets/sounds/red_win.adpcm", attenuation_range_min_meters, attenuation_range_max_meters, radius_meters, reverb_send_level, false, announcement_priority);
+    win_sound_ids[2]    = create_audio_source("assets/sounds/green_win.adpcm", attenuation_range_min_meters, attenuation_range_max_meters, radius_meters, reverb_send_level, false, announcement_priority);
+    win_sound_ids[3]    = create_audio_source("assets/sounds/blue_win.adpcm", attenuation_range_min_meters, attenuation_range_max_meters, radius_meters, reverb_send_level, false, announcement_priority);
+    death_sound_ids[0]  = create_audio_source("assets/sounds/white_death.adpcm", attenuation_range_min_meters, attenuation_range_max_meters, radius_meters, reverb_send_level, false, announcement_priority);
+    death_sound_ids[1]  = create_audio_source("assets/sounds/red_death.adpcm", attenuation_range_min_meters, attenuation_range_max_meters, radius_meters, reverb_send_level, false, announcement_priority);
+    death_sound_ids[2]  = create_audio_source("assets/sounds/green_death.adpcm", attenuation_range_min_meters, attenuation_range_max_meters, radius_meters, reverb_send_level, false, announcement_priority);
+    death_sound_ids[3]  = create_audio_source("assets/sounds/blue_death.adpcm", attenuation_range_min_meters, attenuation_range_max_meters, radius_meters, reverb_send_level, false, announcement_priority);
   }
 
   void play_start_bell() {
-    update_audio_source(start_bell_sound_id, { board_state->first_floor_position.x + (Board::block_offset * float(Board::width / 2)), board_state->first_floor_position.y, board_state->first_floor_position.z });
+    update_audio_source(start_bell_sound_id, board_state->calculate_global_position({ board_state->first_floor_position.x + (Board::block_offset * float(board_state->width / 2)), board_state->first_floor_position.y, board_state->first_floor_position.z }));
     play_audio_source(start_bell_sound_id);
   }
 
   void play_place_bomb(const uint32_t player_id) {
-    static uint32_t sound_source_id = 0;
-
-    update_audio_source(place_bomb_sound_ids[sound_source_id], players[player_id]->transform.position);
-    play_audio_source(place_bomb_sound_ids[sound_source_id]);
-    sound_source_id = (sound_source_id + 1) % std::size(place_bomb_sound_ids);
+    fire_audio_source(place_bomb_sound_id, board_state->calculate_global_position(players[player_id].transform.position));
   }
 
   void play_bomb_explosion(const uint32_t tile_index) {
-    static uint32_t sound_source_id = 0;
-
-    const int32_t column_index = static_cast<int32_t>(Board::calculate_column_index_from_tile_index(tile_index));
-    const int32_t row_index    = static_cast<int32_t>(Board::calculate_row_index_from_tile_index(tile_index));
+    const int32_t column_index = static_cast<int32_t>(board_state->calculate_column_index_from_tile_index(tile_index));
+    const int32_t row_index    = static_cast<int32_t>(board_state->calculate_row_index_from_tile_index(tile_index));
     const Vector3f position { board_state->first_floor_position.x + (Board::block_offset * (float)column_index), board_state->first_floor_position.y, board_state->first_floor_position.z + (Board::block_offset * (float)row_index) };
 
-    update_audio_source(explosion_sound_ids[sound_source_id], position);
-    play_audio_source(explosion_sound_ids[sound_source_id]);
-    sound_source_id = (sound_source_id + 1) % std::size(explosion_sound_ids);
+    fire_audio_source(explosion_sound_id, board_state->calculate_global_position(position));
   }
 
   void play_player_win(const uint32_t player_id) {
-    update_audio_source(win_sound_ids[player_id], players[player_id]->transform.position);
-    play_audio_source(win_sound_ids[player_id]);
+    const uint32_t color_index = player_id % Bomberman::color_count;
+    update_audio_source(win_sound_ids[color_index], board_state->calculate_global_position(players[player_id].transform.position));
+    play_audio_source(win_sound_ids[color_index]);
   }
 
   void play_player_lose(const uint32_t player_id) {
-    update_audio_source(death_sound_ids[player_id], players[player_id]->transform.position);
-    play_audio_source(death_sound_ids[player_id]);
+    const uint32_t color_index = player_id % Bomberman::color_count;
+    update_audio_source(death_sound_ids[color_index], board_state->calculate_global_position(players[player_id].transform.position));
+    play_audio_source(death_sound_ids[color_index]);
   }
 };
 
 struct GameState {
-  std::bitset<player_count> is_player_alive;
+  std::vector<bool> is_player_alive;
+  uint32_t alive_player_count;
   bool is_game_active;
   Board* board_state;
   SoundSystem* sound_state;
-  Bomberman* players[player_count];
-
-  void init(Board* const board_state, SoundSystem* const sound_state, Bomberman* const player_1, Bomberman* const player_2, Bomberman* const player_3, Bomberman* const player_4) {
-    this->board_state = board_state;
-    this->sound_state = sound_state;
-    this->players[0]  = player_1;
-    this->players[1]  = player_2;
-    this->players[2]  = player_3;
-    this->players[3]  = player_4;
+  Bomberman* players;
+  uint32_t player_count;
+
+  void init(Board* const board_state, SoundSystem* const sound_state, Bomberman* const players, const uint32_t player_count) {
+    this->board_state  = board_state;
+    this->sound_state  = sound_state;
+    this->players      = players;
+    this->player_count = player_count;
+    is_player_alive.assign(player_count, false);
+    alive_player_count = 0;
   }
 
   void restart_game() {
     is_game_active     = true;
-    is_player_alive[0] = true;
-    is_player_alive[1] = true;
-    is_player_alive[2] = true;
-    is_player_alive[3] = true;
+    alive_player_count = player_count;
+    is_player_alive.assign(player_count, true);
   }
 
   void eliminate_player(const uint32_t player_id) {
+    alive_player_count -= static_cast<uint32_t>(is_player_alive[player_id]);
     is_player_alive[player_id] = false;
-    if (is_player_alive.count() == 1) {
+    if (alive_player_count == 1) {
       for (uint32_t i=0; i < is_player_alive.size(); ++i) {
         if (is_player_alive[i]) {
-          players[i]->skin.play_animation(players[i]->animations.first_animation + Bomberman::dancing_animation_offset, 1.0f, true);
+          players[i].skin.play_animation(players[i].animations.first_animation + Bomberman::dancing_animation_offset, 1.0f, true);
           sound_state->play_player_win(i);
           break;
         }
@@ -700,59 +788,62 @@ struct MovementSystem {
     Bomberman* player;
   };
 
+  static constexpr uint32_t hide_tile_index  = -1; // eliminated players are taken off the board
+  static constexpr float    tiles_per_second = 4.0f;
+
   Board* board_state;
   GameState* current_game_state;
-  std::bitset<player_count * 2> is_player_moving_bits; // first half player is moving; second half player has chained move
-  PlayerMovementState player_movement_states[player_count];
-  Bomberman::GlobalDirection chain_move_directions[player_count];
-
-  void reset(GameState* const current_game_state, Board* const board_state, Bomberman* const player_1, Bomberman* const player_2, Bomberman* const player_3, Bomberman* const player_4) {
+  uint32_t player_count;
+  std::vector<bool> is_player_moving_bits; // first half player is moving; second half player has chained move
+  std::vector<PlayerMovementState> player_movement_states;
+  std::vector<Bomberman::GlobalDirection> chain_move_directions;
+  TileBits current_tile_bits; // player occupancy planes so checks don't scan every player, a tile is never the current or target tile of two players
+  TileBits target_tile_bits;
+
+  void reset(GameState* const current_game_state, Board* const board_state, Bomberman* const players, const uint32_t player_count) {
     this->current_game_state = current_game_state;
     this->board_state        = board_state;
+    this->player_count       = player_count;
+
+    player_movement_states.resize(player_count);
+    chain_move_directions.resize(player_count);
+    is_player_moving_bits.assign(player_count * 2, false);
+    current_tile_bits.resize(board_state->tile_count);
+    target_tile_bits.resize(board_state->tile_count);
+
+    for (uint32_t i=0; i < player_count; ++i) {
+      PlayerMovementState& movement_state = player_movement_states[i];
+      movement_state.player = &players[i];
+      movement_state.player->skin.play_animation(movement_state.player->animations.first_animation + Bomberman::idle_animation_offset, 1.0f, true);
 
-    player_movement_states[0].player = player_1;
-    player_movement_states[1].player = player_2;
-    player_movement_states[2].player = player_3;
-    player_movement_states[3].player = player_4;
-
-    player_movement_states[0].player->skin.play_animation(player_movement_states[0].player->animations.first_animation + Bomberman::idle_animation_offset, 1.0f, true);
-    player_movement_states[1].player->skin.play_animation(player_movement_states[1].player->animations.first_animation + Bomberman::idle_animation_offset, 1.0f, true);
-    player_movement_states[2].player->skin.play_animation(player_movement_states[2].player->animations.first_animation + Bomberman::idle_animation_offset, 1.0f, true);
-    player_movement_states[3].player->skin.play_animation(player_movement_states[3].player->animations.first_animation + Bomberman::idle_animation_offset, 1.0f, true);
-
-    static_assert( (Board::height == 13) && (Board::width == 15) ); // update current and target tile indexes if assert fails
-    player_movement_states[0].current_tile_index = 0;
-    player_movement_states[0].target_tile_index  = 0;
-    player_movement_states[1].current_tile_index = 12;
-    player_movement_states[1].target_tile_index  = 12;
-    player_movement_states[2].current_tile_index = 130;
-    player_movement_states[2].target_tile_index  = 130;
-    player_movement_states[3].current_tile_index = 142;
-    player_movement_states[3].target_tile_index  = 142;
-
-    is_player_moving_bits.reset();
-
-    player_movement_states[0].initial_position = board_state->player_1_start_position;
-    player_movement_states[1].initial_position = board_state->player_2_start_position;
-    player_movement_states[2].initial_position = board_state->player_3_start_position;
-    player_movement_states[3].initial_position = board_state->player_4_start_position;
-    player_movement_states[0].target_position  = board_state->player_1_start_position;
-    player_movement_states[1].target_position  = board_state->player_2_start_position;
-    player_movement_states[2].target_position  = board_state->player_3_start_position;
-    player_movement_states[3].target_position  = board_state->player_4_start_position;
-
-    player_1->transform.position = board_state->player_1_start_position;
-    player_2->transform.position = board_state->player_2_start_position;
-    player_3->transform.position = board_state->player_3_start_position;
-    player_4->transform.position = board_state->player_4_start_position;
-
-    player_1->current_direction = Bomberman::GlobalDirection::Down;
-    player_2->current_direction = Bomberman::GlobalDirection::Down;
-    player_3->current_direction = Bomberman::GlobalDirection::Up;
-    player_4->current_direction = Bomberman::GlobalDirection::Up;
-  }
-
-  bool move_player(const uint32_t player_id, const Bomberman::GlobalDirection direction, const bool is_player_AI=false) {
+      movement_state.current_tile_index = board_state->player_start_tile_indexes[i];
+      movement_state.target_tile_index  = board_state->player_start_tile_indexes[i];
+      current_tile_bits.set(movement_state.current_tile_index);
+      target_tile_bits.set(movement_state.target_tile_index);
+
+      movement_state.initial_position = board_state->player_start_positions[i];
+      movement_state.target_position  = board_state->player_start_positions[i];
+
+      movement_state.player->transform.position = board_state->player_start_positions[i];
+      movement_state.player->previous_position  = movement_state.player->transform.position;
+      movement_state.player->current_direction  = (board_state->calculate_row_index_from_tile_index(movement_state.current_tile_index) < (board_state->floor_row_count / 2)) ? Bomberman::GlobalDirection::Down : Bomberman::GlobalDirection::Up;
+    }
+  }
+
+  void set_tile_indexes(PlayerMovementState& movement_state, const uint32_t current_tile_index, const uint32_t target_tile_index) { // keeps the occupancy planes in sync
+    if (movement_state.current_tile_index != hide_tile_index) current_tile_bits.reset(movement_state.current_tile_index);
+    if (movement_state.target_tile_index != hide_tile_index)  target_tile_bits.reset(movement_state.target_tile_index);
+    movement_state.current_tile_index = current_tile_index;
+    movement_state.target_tile_index  = target_tile_index;
+    if (current_tile_index != hide_tile_index) current_tile_bits.set(current_tile_index);
+    if (target_tile_index != hide_tile_index)  target_tile_bits.set(target_tile_index);
+  }
+
+  bool is_tile_occupied(const uint32_t tile_index) const {
+    return current_tile_bits.test(tile_index) || target_tile_bits.test(tile_index);
+  }
+
+  bool move_player(const uint32_t player_id, const Bomberman::GlobalDirection direction) {
     PlayerMovementState& movement_state = player_movement_states[player_id];
     if (!current_game_state->is_player_alive[player_id] || !current_game_state->is_game_active) return false;
 
@@ -766,16 +857,16 @@ struct MovementSystem {
       return false;
     }
 
-    const size_t row_index    = Board::calculate_row_index_from_tile_index(movement_state.current_tile_index);
-    const size_t column_index = Board::calculate_column_index_from_tile_index(movement_state.current_tile_index);
+    const size_t row_index    = board_state->calculate_row_index_from_tile_index(movement_state.current_tile_index);
+    const size_t column_index = board_state->calculate_column_index_from_tile_index(movement_state.current_tile_index);
     uint32_t target_tile_index;
     Vector3f position_offset = {0.0f, 0.0f, 0.0f};
     if (direction == Bomberman::GlobalDirection::Up) {
       if (row_index == 0) return false;
-      target_tile_index = movement_state.current_tile_index - Board::floor_column_count;
+      target_tile_index = movement_state.current_tile_index - board_state->floor_column_count;
       position_offset.z -= board_state->Board::block_offset;
     } else if (direction == Bomberman::GlobalDirection::Right) {
-      if (column_index == (Board::floor_column_count - 1) ) return false;
+      if (column_index == (board_state->floor_column_count - 1) ) return false;
       target_tile_index = movement_state.current_tile_index + 1;
       position_offset.x += board_state->Board::block_offset;
     } else if (direction == Bomberman::GlobalDirection::Left) {
@@ -783,52 +874,15 @@ struct MovementSystem {
       target_tile_index = movement_state.current_tile_index - 1;
       position_offset.x -= board_state->Board::block_offset;
     } else if (direction == Bomberman::GlobalDirection::Down) {
-      if (row_index == (Board::floor_row_count - 1)) return false;
-      target_tile_index = movement_state.current_tile_index + Board::floor_column_count;
+      if (row_index == (board_state->floor_row_count - 1)) return false;
+      target_tile_index = movement_state.current_tile_index + board_state->floor_column_count;
       position_offset.z += board_state->Board::block_offset;
     }
 
     if (board_state->tile_states[target_tile_index] != Board::TileState::Empty) return false;
-    for (uint32_t i=0; i < player_count; ++i) {
-      if (i == player_id) continue;
-      if (player_movement_states[i].current_tile_index == target_tile_index) return false;
-      if (player_movement_states[i].target_tile_index == target_tile_index)  return false;
-    }
+    if (is_tile_occupied(target_tile_index)) return false; // the moving player is idle so it only occupies its current tile
 
-    if (is_player_AI) {
-      const size_t target_tile_row_index    = Board::calculate_row_index_from_tile_index(target_tile_index);
-      const size_t target_tile_column_index = Board::calculate_column_index_from_tile_index(target_tile_index);
-
-      const bool is_bomb_leftward  = ( (target_tile_column_index > 0) && (board_state->tile_states[target_tile_index - 1] == Board::TileState::Bomb) ) ||
-                                     ( (target_tile_column_index > 1) && (board_state->tile_states[target_tile_index - 2] == Board::TileState::Bomb) );
-      const bool is_bomb_rightward = ( (target_tile_column_index < (Board::floor_column_count - 1)) && (board_state->tile_states[target_tile_index + 1] == Board::TileState::Bomb) ) ||
-                                     ( (target_tile_column_index < (Board::floor_column_count - 2)) && (board_state->tile_states[target_tile_index + 2] == Board::TileState::Bomb) );
-      const bool is_bomb_upward    = ( (target_tile_row_index > 0) && (board_state->tile_states[target_tile_index - Board::floor_column_count] == Board::TileState::Bomb) ) ||
-                                     ( (target_tile_row_index > 1) && (board_state->tile_states[target_tile_index - (Board::floor_column_count * 2)] == Board::TileState::Bomb) );
-      const bool is_bomb_downward  = ( (target_tile_row_index < (Board::floor_row_count - 1)) && (board_state->tile_states[target_tile_index + Board::floor_column_count] == Board::TileState::Bomb) ) ||
-                                     ( (target_tile_row_index < (Board::floor_row_count - 2)) && (board_state->tile_states[target_tile_index + (Board::floor_column_count * 2)] == Board::TileState::Bomb) );
-
-      switch (direction) {
-        case Bomberman::GlobalDirection::Left : {
-          if (is_bomb_leftward || is_bomb_upward || is_bomb_downward) return false;
-          break;
-        }
-        case Bomberman::GlobalDirection::Right : {
-          if (is_bomb_rightward || is_bomb_upward || is_bomb_downward) return false;
-          break;
-        }
-        case Bomberman::GlobalDirection::Up : {
-          if (is_bomb_upward || is_bomb_rightward || is_bomb_leftward) return false;
-          break;
-        }
-        case Bomberman::GlobalDirection::Down : {
-          if (is_bomb_downward || is_bomb_rightward || is_bomb_leftward) return false;
-          break;
-        }
-      }
-    }
-
-    movement_state.target_tile_index         = target_tile_index;
+    set_tile_indexes(movement_state, movement_state.current_tile_index, target_tile_index);
     movement_state.initial_position          = movement_state.player->transform.position;
     movement_state.target_position           = { movement_state.initial_position.x + position_offset.x, movement_state.initial_position.y + position_offset.y, movement_state.initial_position.z + position_offset.z };
     movement_state.player->current_direction = direction;
@@ -838,13 +892,13 @@ struct MovementSystem {
   }
 
   void update() {
+    PROFILE_SCOPE("MovementSystem::update");
     for (uint32_t i=0; i < player_count; ++i) {
       if (is_player_moving_bits[i] && current_game_state->is_player_alive[i]) {
         PlayerMovementState& movement_state = player_movement_states[i];
         const Vector3f direction         = { movement_state.target_position.x - movement_state.initial_position.x, 0.0f, movement_state.target_position.z - movement_state.initial_position.z };
         const bool is_moving_x_axis      = direction.x != 0.0f;
         const float direction_sign       = (static_cast<float>(direction.x > 0.0f || direction.z > 0.0f) * 1.0f) + (static_cast<float>(direction.x < 0.0f || direction.z < 0.0f) * -1.0f);
-        constexpr float tiles_per_second = 4.0f;
 
         const Vector3f velocity    = { (board_state->Board::block_offset * tiles_per_second) * delta_time_seconds * direction_sign * static_cast<float>(is_moving_x_axis), 0.0f, (board_state->Board::block_offset * tiles_per_second) * delta_time_seconds * direction_sign * static_cast<float>(!is_moving_x_axis) };
         Vector3f& current_position = movement_state.player->transform.position;
@@ -855,7 +909,7 @@ struct MovementSystem {
         const Vector3f current_distance = { movement_state.player->transform.position.x - movement_state.initial_position.x, 0.0f, movement_state.player->transform.position.z - movement_state.initial_position.z };
 
         const bool change_current_tile_index = ((current_distance.x != 0.0f) && (current_distance.x / total_distance.x) > 0.5f) || ((current_distance.z != 0.0f) && (current_distance.z / total_distance.z) > 0.5f);
-        movement_state.current_tile_index    = ( movement_state.target_tile_index * static_cast<uint32_t>(change_current_tile_index) ) + ( movement_state.current_tile_index * static_cast<uint32_t>(!change_current_tile_index) );
+        set_tile_indexes(movement_state, ( movement_state.target_tile_index * static_cast<uint32_t>(change_current_tile_index) ) + ( movement_state.current_tile_index * static_cast<uint32_t>(!change_current_tile_index) ), movement_state.target_tile_index);
 
         bool reached_destination = ( (velocity.x > 0.0f) && (current_position.x >= movement_state.target_position.x) ) ||
                                    ( (velocity.x < 0.0f) && (current_position.x <= movement_state.target_position.x) ) ||
@@ -867,10 +921,10 @@ struct MovementSystem {
 
           is_player_moving_bits[i]                  = false;
           movement_state.player->transform.position = movement_state.target_position;
-          movement_state.current_tile_index         = movement_state.target_tile_index;
+          set_tile_indexes(movement_state, movement_state.target_tile_index, movement_state.target_tile_index);
 
           if (is_player_moving_bits[i + player_count]) { // check if chained move
-            if ( this->move_player(movement_state.player->player_id, chain_move_directions[i], i > 0) ) {
+            if ( this->move_player(movement_state.player->player_id, chain_move_directions[i]) ) {
               const Vector3f chain_direction    = { movement_state.target_position.x - movement_state.initial_position.x, 0.0f, movement_state.target_position.z - movement_state.initial_position.z };
               const bool chain_is_moving_x_axis = chain_direction.x != 0.0f;
               const float chain_direction_sign  = (static_cast<float>(chain_direction.x > 0.0f || chain_direction.z > 0.0f) * 1.0f) + (static_cast<float>(chain_direction.x < 0.0f || chain_direction.z < 0.0f) * -1.0f);
@@ -886,7 +940,7 @@ struct MovementSystem {
               if (chain_reached_destination) {
                 is_player_moving_bits[i]                  = false;
                 movement_state.player->transform.position = movement_state.target_position;
-                movement_state.current_tile_index         = movement_state.target_tile_index;
+                set_tile_indexes(movement_state, movement_state.target_tile_index, movement_state.target_tile_index);
                 movement_state.player->skin.play_animation(movement_state.player->animations.first_animation + Bomberman::idle_animation_offset, 1.0f, true);
               }
 
@@ -903,417 +957,551 @@ struct MovementSystem {
   }
 };
 
+struct DangerMap { // tick each tile is next caught in a blast, chain reactions included, kept by the bomb system and shared by every AI
+  static constexpr uint64_t no_tick = -1;
+
+  Board* board_state;
+  uint32_t blast_radius_tiles;
+  std::vector<uint64_t> fire_ticks;           // no_tick when no bomb on the board reaches the tile
+  std::vector<uint32_t> painted_tile_indexes; // tiles with a fire tick so clearing doesn't touch the whole board
+  std::vector<uint32_t> pending_tile_indexes; // bombs whose fire tick was brought forward and still have to repaint their blast
+  uint32_t version; // bumped on every change so plans made against an older map get checked again
+
+  void reset(Board* const board_state, const uint32_t blast_radius_tiles) {
+    this->board_state        = board_state;
+    this->blast_radius_tiles = blast_radius_tiles;
+    fire_ticks.assign(board_state->tile_count, no_tick);
+    painted_tile_indexes.clear();
+    painted_tile_indexes.reserve(board_state->tile_count);
+    pending_tile_indexes.clear();
+    pending_tile_indexes.reserve(board_state->tile_count);
+    version = 0;
+  }
+
+  // visits the tiles a bomb on tile_index would reach, the blast stops before a stone and on the first brick or bomb
+  // players are ignored since they move, so the map errs on the side of danger
+  template <typename Visit>
+  void for_each_blast_tile(const uint32_t tile_index, Visit&& visit) const {
+    const TileBits& stone_bits = board_state->get_tile_bits(Board::TileState::Stone);
+    const TileBits& brick_bits = board_state->get_tile_bits(Board::TileState::Brick);
+    const TileBits& bomb_bits  = board_state->get_tile_bits(Board::TileState::Bomb);
+
+    const int32_t column_index      = static_cast<int32_t>(board_state->calculate_column_index_from_tile_index(tile_index));
+    const int32_t row_index         = static_cast<int32_t>(board_state->calculate_row_index_from_tile_index(tile_index));
+    const int32_t tile_steps[4]     = { -int32_t(board_state->floor_column_count), int32_t(board_state->floor_column_count), 1, -1 };
+    const int32_t tiles_to_edges[4] = { row_index, (int32_t(board_state->floor_row_count) - 1) - row_index, (int32_t(board_state->floor_column_count) - 1) - column_index, column_index };
+
+    for (uint32_t ray_index=0; ray_index < 4; ++ray_index) {
+      const uint32_t max_count = static_cast<uint32_t>(std::min(int32_t(blast_radius_tiles), tiles_to_edges[ray_index]));
+      uint32_t target_tile_index = tile_index;
+      for (uint32_t count=0; count < max_count; ++count) {
+        target_tile_index += tile_steps[ray_index];
+        if (stone_bits.test(target_tile_index)) break;
+
+        visit(target_tile_index);
+        if (brick_bits.test(target_tile_index) || bomb_bits.test(target_tile_index)) break;
+      }
+    }
+  }
+
+  bool bring_forward(const uint32_t tile_index, const uint64_t fire_tick) {
+    if (fire_tick >= fire_ticks[tile_index]) return false;
+    if (fire_ticks[tile_index] == no_tick) painted_tile_indexes.push_back(tile_index);
+    fire_ticks[tile_index] = fire_tick;
+    return true;
+  }
+
+  void add_bomb(const uint32_t tile_index, const uint64_t detonation_tick) { // a new bomb only ever brings fire ticks forward so the map is relaxed outward from it instead of rebuilt
+    const TileBits& bomb_bits = board_state->get_tile_bits(Board::TileState::Bomb);
+    bring_forward(tile_index, detonation_tick); // a bomb already in a blast goes off with it
+    pending_tile_indexes.push_back(tile_index);
+
+    while (!pending_tile_indexes.empty()) {
+      const uint32_t bomb_tile_index = pending_tile_indexes.back();
+      const uint64_t fire_tick       = fire_ticks[bomb_tile_index];
+      pending_tile_indexes.pop_back();
+
+      for_each_blast_tile(bomb_tile_index, [&](const uint32_t target_tile_index) {
+        if (bring_forward(target_tile_index, fire_tick) && bomb_bits.test(target_tile_index)) pending_tile_indexes.push_back(target_tile_index);
+      });
+    }
+    ++version;
+  }
+
+  void rebuild(const TimerWheel& detonations) { // a detonation clears bricks and can lengthen other blasts, so the map is repainted from the bombs left on the board
+    for (const uint32_t tile_index : painted_tile_indexes) fire_ticks[tile_index] = no_tick;
+    painted_tile_indexes.clear();
+    ++version;
+
+    const TileBits& bomb_bits = board_state->get_tile_bits(Board::TileState::Bomb);
+    for (size_t tile_index = TileBits::find_next_in_either(bomb_bits, bomb_bits, 0); tile_index < board_state->tile_count; tile_index = TileBits::find_next_in_either(bomb_bits, bomb_bits, tile_index + 1)) {
+      if (detonations.is_scheduled(static_cast<uint32_t>(tile_index))) add_bomb(static_cast<uint32_t>(tile_index), detonations.due_ticks[tile_index]);
+    }
+  }
+};
+
 struct BombSystem {
   GameState* current_game_state;
   Board* board_state;
   MovementSystem* movement_state;
   SoundSystem* sound_state;
-  std::bitset<Board::floor_row_count * Board::floor_column_count> is_bomb_active_bits;
-  std::bitset<Board::floor_row_count * Board::floor_column_count> is_fire_active_bits;
-  float timers[Board::floor_row_count * Board::floor_column_count];
-  const float detonation_time_seconds = 3.0f;
-  const float explosion_time_seconds  = 1.0f;
-  const uint32_t blast_radius_tiles   = 2;
+  TimerWheel detonations; // event ids are tile indexes
+  TimerWheel fire_expiries;
+  std::vector<uint32_t> detonating_tile_indexes; // bombs going off this tick, ones caught in a blast are appended
+  DangerMap danger_map;
+  uint64_t current_tick;
+  const uint32_t detonation_time_ticks = static_cast<uint32_t>(3.0f * SimulationState::tick_rate_hz);
+  const uint32_t explosion_time_ticks  = static_cast<uint32_t>(1.0f * SimulationState::tick_rate_hz);
+  const uint32_t blast_radius_tiles    = 2;
 
   void reset(GameState* const current_game_state, Board* const board_state, MovementSystem* const movement_state, SoundSystem* const sound_state) {
     this->current_game_state = current_game_state;
     this->board_state        = board_state;
     this->movement_state     = movement_state;
     this->sound_state        = sound_state;
-    is_bomb_active_bits.reset();
-    is_fire_active_bits.reset();
-    for (uint32_t i=0; i < (Board::floor_row_count * Board::floor_column_count); ++i) timers[i] = 0.0f;
+    current_tick             = 0;
+    detonations.reset(static_cast<uint32_t>(board_state->tile_count), detonation_time_ticks);
+    fire_expiries.reset(static_cast<uint32_t>(board_state->tile_count), explosion_time_ticks);
+    detonating_tile_indexes.reserve(board_state->tile_count);
+    danger_map.reset(board_state, blast_radius_tiles);
   }
 
-  void place_bomb(const uint32_t player_id, Bomberman::GlobalDirection* const ai_behavior_directions=nullptr) {
+  void place_bomb(const uint32_t player_id) {
     const uint32_t tile_index = movement_state->player_movement_states[player_id].current_tile_index;
     if (!current_game_state->is_player_alive[player_id]) return;
     if (board_state->tile_states[tile_index] == Board::TileState::Bomb) return;
 
-    if (ai_behavior_directions) {
-      const size_t tile_row_index    = Board::calculate_row_index_from_tile_index(tile_index);
-      const size_t tile_column_index = Board::calculate_column_index_from_tile_index(tile_index);
-
-      const bool leftward_up_escape_path_exists      = ( (tile_column_index > 0) && (board_state->tile_states[tile_index - 1] == Board::TileState::Empty) ) &&
-                                                       ( (tile_row_index > 0) && (board_state->tile_states[tile_index - 1 - Board::floor_column_count] == Board::TileState::Empty) );
-      const bool leftward_down_escape_path_exists    = ( (tile_column_index > 0) && (board_state->tile_states[tile_index - 1] == Board::TileState::Empty) ) &&
-                                                       ( (tile_row_index < (Board::floor_row_count - 1)) && (board_state->tile_states[tile_index - 1 + Board::floor_column_count] == Board::TileState::Empty) );
-      const bool rightward_up_escape_path_exists     = ( (tile_column_index < (Board::floor_column_count - 1)) && (board_state->tile_states[tile_index + 1] == Board::TileState::Empty) ) &&
-                                                       ( (tile_row_index > 0) && (board_state->tile_states[(tile_index + 1) - Board::floor_column_count] == Board::TileState::Empty) );
-      const bool rightward_down_escape_path_exists   = ( (tile_column_index < (Board::floor_column_count - 1)) && (board_state->tile_states[tile_index + 1] == Board::TileState::Empty) ) &&
-                                                       ( (tile_row_index < (Board::floor_row_count - 1)) && (board_state->tile_states[tile_index + 1 + Board::floor_column_count] == Board::TileState::Empty) );
-      const bool upward_left_path_exists             = ( (tile_row_index > 0) && (board_state->tile_states[tile_index - Board::floor_column_count] == Board::TileState::Empty) ) &&
-                                                       ( (tile_column_index > 0) && (board_state->tile_states[(tile_index - Board::floor_column_count - 1)] == Board::TileState::Empty) );
-      const bool upward_right_path_exists            = ( (tile_row_index > 0) && (board_state->tile_states[tile_index - Board::floor_column_count] == Board::TileState::Empty) ) &&
-                                                       ( (tile_column_index < (Board::floor_column_count - 1)) && (board_state->tile_states[tile_index - Board::floor_column_count + 1] == Board::TileState::Empty) );
-      const bool downward_left_path_exists           = ( (tile_row_index < (Board::floor_row_count - 1)) && (board_state->tile_states[tile_index + Board::floor_column_count] == Board::TileState::Empty) ) &&
-                                                       ( (tile_column_index > 0) && (board_state->tile_states[tile_index + Board::floor_column_count - 1] == Board::TileState::Empty) );
-      const bool downward_right_path_exists          = ( (tile_row_index < (Board::floor_row_count - 1)) && (board_state->tile_states[tile_index + Board::floor_column_count] == Board::TileState::Empty) ) &&
-                                                       ( (tile_column_index < (Board::floor_column_count - 1)) && (board_state->tile_states[tile_index + Board::floor_column_count + 1] == Board::TileState::Empty) );
-      const bool triple_left_escape_path_exists      = ( (tile_column_index > 2) && (board_state->tile_states[tile_index - 1] == Board::TileState::Empty) ) &&
-                                                       ( (board_state->tile_states[tile_index - 2] == Board::TileState::Empty) ) &&
-                                                       ( (board_state->tile_states[tile_index - 3] == Board::TileState::Empty) );
-      const bool triple_right_escape_path_exists     = ( (tile_column_index < (Board::floor_column_count - 3)) && (board_state->tile_states[tile_index + 1] == Board::TileState::Empty) ) &&
-                                                       ( (board_state->tile_states[tile_index + 2] == Board::TileState::Empty) ) &&
-                                                       ( (board_state->tile_states[tile_index + 3] == Board::TileState::Empty) );
-      const bool triple_up_path_exists               = ( (tile_row_index > 2) && (board_state->tile_states[tile_index - Board::floor_column_count] == Board::TileState::Empty) ) &&
-                                                       ( (board_state->tile_states[tile_index - (Board::floor_column_count * 2)] == Board::TileState::Empty) ) &&
-                                                       ( (board_state->tile_states[tile_index - (Board::floor_column_count * 3)] == Board::TileState::Empty) );
-      const bool triple_down_path_exists             = ( (tile_row_index < (Board::floor_row_count - 3)) && (board_state->tile_states[tile_index + Board::floor_column_count] == Board::TileState::Empty) ) &&
-                                                       ( (board_state->tile_states[tile_index + (Board::floor_column_count * 2)] == Board::TileState::Empty) ) &&
-                                                       ( (board_state->tile_states[tile_index + (Board::floor_column_count * 3)] == Board::TileState::Empty) );
-      const bool leftward_2_up_escape_path_exists    = ( (tile_column_index > 1) && (board_state->tile_states[tile_index - 1] == Board::TileState::Empty) ) &&
-                                                       ( board_state->tile_states[tile_index - 2] == Board::TileState::Empty ) &&
-                                                       ( (tile_row_index > 0) && (board_state->tile_states[tile_index - 2 - Board::floor_column_count] == Board::TileState::Empty) );
-      const bool leftward_2_down_escape_path_exists  = ( (tile_column_index > 1) && (board_state->tile_states[tile_index - 1] == Board::TileState::Empty) ) &&
-                                                       ( board_state->tile_states[tile_index - 2] == Board::TileState::Empty ) &&
-                                                       ( (tile_row_index < (Board::floor_row_count - 1)) && (board_state->tile_states[tile_index - 2 + Board::floor_column_count] == Board::TileState::Empty) );
-      const bool rightward_2_up_escape_path_exists   = ( (tile_column_index < (Board::floor_column_count - 2)) && (board_state->tile_states[tile_index + 1] == Board::TileState::Empty) ) &&
-                                                       ( board_state->tile_states[tile_index + 2] == Board::TileState::Empty ) &&
-                                                       ( (tile_row_index > 0) && (board_state->tile_states[(tile_index + 2) - Board::floor_column_count] == Board::TileState::Empty) );
-      const bool rightward_2_down_escape_path_exists = ( (tile_column_index < (Board::floor_column_count - 2)) && (board_state->tile_states[tile_index + 1] == Board::TileState::Empty) ) &&
-                                                       ( board_state->tile_states[tile_index + 2] == Board::TileState::Empty ) &&
-                                                       ( (tile_row_index < (Board::floor_row_count - 1)) && (board_state->tile_states[tile_index + 2 + Board::floor_column_count] == Board::TileState::Empty) );
-      const bool upward_2_left_path_exists           = ( (tile_row_index > 1) && (board_state->tile_states[tile_index - Board::floor_column_count] == Board::TileState::Empty) ) &&
-                                                       ( board_state->tile_states[tile_index - (Board::floor_column_count * 2)] == Board::TileState::Empty ) &&
-                                                       ( (tile_column_index > 0) && (board_state->tile_states[(tile_index - (Board::floor_column_count * 2) - 1)] == Board::TileState::Empty) );
-      const bool upward_2_right_path_exists          = ( (tile_row_index > 1) && (board_state->tile_states[tile_index - Board::floor_column_count] == Board::TileState::Empty) ) &&
-                                                       ( board_state->tile_states[tile_index - (Board::floor_column_count * 2)] == Board::TileState::Empty ) &&
-                                                       ( (tile_column_index < (Board::floor_column_count - 1)) && (board_state->tile_states[tile_index - (Board::floor_column_count * 2) + 1] == Board::TileState::Empty) );
-      const bool downward_2_left_path_exists         = ( (tile_row_index < (Board::floor_row_count - 2)) && (board_state->tile_states[tile_index + Board::floor_column_count] == Board::TileState::Empty) ) &&
-                                                       ( board_state->tile_states[tile_index + (Board::floor_column_count * 2)] == Board::TileState::Empty ) &&
-                                                       ( (tile_column_index > 0) && (board_state->tile_states[tile_index + (Board::floor_column_count * 2) - 1] == Board::TileState::Empty) );
-      const bool downward_2_right_path_exists        = ( (tile_row_index < (Board::floor_row_count - 2)) && (board_state->tile_states[tile_index + Board::floor_column_count] == Board::TileState::Empty) ) &&
-                                                       ( board_state->tile_states[tile_index + (Board::floor_column_count * 2)] == Board::TileState::Empty ) &&
-                                                       ( (tile_column_index < (Board::floor_column_count - 1)) && (board_state->tile_states[tile_index + (Board::floor_column_count * 2) + 1] == Board::TileState::Empty) );
-      if ( !(leftward_up_escape_path_exists      ||
-             leftward_down_escape_path_exists    ||
-             rightward_up_escape_path_exists     ||
-             rightward_down_escape_path_exists   ||
-             upward_left_path_exists             ||
-             upward_right_path_exists            ||
-             downward_left_path_exists           ||
-             downward_right_path_exists          ||
-             triple_left_escape_path_exists      ||
-             triple_right_escape_path_exists     ||
-             triple_up_path_exists               ||
-             triple_down_path_exists             ||
-             leftward_2_up_escape_path_exists    ||
-             leftward_2_down_escape_path_exists  ||
-             rightward_2_up_escape_path_exists   ||
-             rightward_2_down_escape_path_exists ||
-             upward_2_left_path_exists           ||
-             upward_2_right_path_exists          ||
-             downward_2_left_path_exists         ||
-             downward_2_right_path_exists
-         ) ) return;
-
-       ai_behavior_directions[0] = (leftward_up_escape_path_exists || leftward_2_up_escape_path_exists || leftward_down_escape_path_exists || leftward_2_down_escape_path_exists || triple_left_escape_path_exists) ? Bomberman::GlobalDirection::Left : ai_behavior_directions[0];
-       ai_behavior_directions[0] = (rightward_up_escape_path_exists || rightward_2_up_escape_path_exists || rightward_down_escape_path_exists || rightward_2_down_escape_path_exists || triple_right_escape_path_exists) ? Bomberman::GlobalDirection::Right : ai_behavior_directions[0];
-       ai_behavior_directions[0] = (upward_left_path_exists || upward_2_left_path_exists || upward_right_path_exists || upward_2_right_path_exists || triple_up_path_exists) ? Bomberman::GlobalDirection::Up : ai_behavior_directions[0];
-       ai_behavior_directions[0] = (downward_left_path_exists || downward_2_left_path_exists || downward_right_path_exists || downward_2_right_path_exists || triple_down_path_exists) ? Bomberman::GlobalDirection::Down : ai_behavior_directions[0];
-
-       ai_behavior_directions[1] = (upward_left_path_exists || downward_left_path_exists || leftward_2_up_escape_path_exists || leftward_2_down_escape_path_exists || triple_left_escape_path_exists) ? Bomberman::GlobalDirection::Left : ai_behavior_directions[1];
-       ai_behavior_directions[1] = (upward_right_path_exists || downward_right_path_exists || rightward_2_up_escape_path_exists || rightward_2_down_escape_path_exists || triple_right_escape_path_exists) ? Bomberman::GlobalDirection::Right : ai_behavior_directions[1];
-       ai_behavior_directions[1] = (leftward_up_escape_path_exists || rightward_up_escape_path_exists || upward_2_left_path_exists || upward_2_right_path_exists || triple_up_path_exists) ? Bomberman::GlobalDirection::Up : ai_behavior_directions[1];
-       ai_behavior_directions[1] = (leftward_down_escape_path_exists || rightward_down_escape_path_exists || downward_2_left_path_exists || downward_2_right_path_exists || triple_down_path_exists) ? Bomberman::GlobalDirection::Down : ai_behavior_directions[1];
-    }
-
     board_state->show_bomb(tile_index);
-    is_bomb_active_bits[tile_index] = true;
-    timers[tile_index] = 0.0f;
+    detonations.schedule(tile_index, current_tick + detonation_time_ticks);
+    danger_map.add_bomb(tile_index, current_tick + detonation_time_ticks);
     sound_state->play_place_bomb(player_id);
   }
 
-  void update() {
-    for (uint32_t tile_index=0; tile_index < (Board::floor_row_count * Board::floor_column_count); ++tile_index) {
-      uint32_t chain_loop_tile_index = tile_index;
-      bool fire_created_this_frame   = false;
-      bool chained_explosion         = false;
-
-      if (is_bomb_active_bits[tile_index]) {
-        board_state->all_bombs[tile_index].update();
-        timers[tile_index] += delta_time_seconds;
-
-        if (timers[tile_index] >= detonation_time_seconds) {
-          board_state->hide_bomb(tile_index);
-          is_bomb_active_bits[tile_index] = false;
-          timers[tile_index]              = timers[tile_index] - detonation_time_seconds;  // timer is being used for fire now
-          bool render_fire                = timers[tile_index] < explosion_time_seconds;
-          fire_created_this_frame         = true;
-
-          static_assert( (Board::floor_row_count == 11) && (Board::floor_column_count == 13) ); // if fails then update this method
-
-          const int32_t column_index = static_cast<int32_t>(Board::calculate_column_index_from_tile_index(tile_index));
-          const int32_t row_index    = static_cast<int32_t>(Board::calculate_row_index_from_tile_index(tile_index));
-
-          uint32_t blast_up_count = 0;
-          for (int32_t i=1; i <= int32_t(blast_radius_tiles); ++i) {
-            const int32_t target_tile_index = int32_t(tile_index) + (i * int32_t(-1 * Board::floor_column_count));
-
-            if ( (row_index - i) < 0 ) break;
-            if (board_state->tile_states[target_tile_index] == Board::TileState::Stone) break;
-
-            ++blast_up_count;
-            timers[target_tile_index] = timers[tile_index];
-            if ( (board_state->tile_states[target_tile_index] == Board::TileState::Brick) || (board_state->tile_states[target_tile_index] == Board::TileState::Bomb) ) break;
-            if ( (target_tile_index == movement_state->player_movement_states[0].current_tile_index) || (target_tile_index == movement_state->player_movement_states[1].current_tile_index) || (target_tile_index == movement_state->player_movement_states[2].current_tile_index) || (target_tile_index == movement_state->player_movement_states[3].current_tile_index) ) break;
-          }
-          uint32_t blast_down_count = 0;
-          for (int32_t i=1; i <= int32_t(blast_radius_tiles); ++i) {
-            const int32_t target_tile_index = int32_t(tile_index) + (i * int32_t(Board::floor_column_count));
+  // the blast stops before a stone and on the first brick, bomb or player, returns how many tiles it covers
+  // a ray is at most blast_radius_tiles long so it reads tile_states directly, only players come from their occupancy plane
+  uint32_t propagate_blast(const uint32_t tile_index, const int32_t tile_step, const int32_t tiles_to_edge) {
+    const Board::TileState* const tile_states = board_state->tile_states.data();
+    const TileBits&               player_bits = movement_state->current_tile_bits;
+    const uint32_t                max_count   = static_cast<uint32_t>(std::min(int32_t(blast_radius_tiles), tiles_to_edge));
 
-            if ( (row_index + i) > 10 ) break;
-            if (board_state->tile_states[target_tile_index] == Board::TileState::Stone) break;
+    uint32_t count = 0;
+    for (uint32_t target_tile_index = tile_index + tile_step; count < max_count; target_tile_index += tile_step) {
+      if (tile_states[target_tile_index] == Board::TileState::Stone) break;
 
-            ++blast_down_count;
-            timers[target_tile_index] = timers[tile_index];
-            if ( (board_state->tile_states[target_tile_index] == Board::TileState::Brick) || (board_state->tile_states[target_tile_index] == Board::TileState::Bomb) ) break;
-            if ( (target_tile_index == movement_state->player_movement_states[0].current_tile_index) || (target_tile_index == movement_state->player_movement_states[1].current_tile_index) || (target_tile_index == movement_state->player_movement_states[2].current_tile_index) || (target_tile_index == movement_state->player_movement_states[3].current_tile_index) ) break;
-          }
-          uint32_t blast_right_count = 0;
-          for (int32_t i=1; i <= int32_t(blast_radius_tiles); ++i) {
-            const int32_t target_tile_index = int32_t(tile_index) + i;
+      ++count;
+      if ( (tile_states[target_tile_index] == Board::TileState::Brick) || (tile_states[target_tile_index] == Board::TileState::Bomb) || player_bits.test(target_tile_index) ) break;
+    }
+    return count;
+  }
 
-            if ( (column_index + i) > 12 ) break;
-            if (board_state->tile_states[target_tile_index] == Board::TileState::Stone) break;
+  void explode_tile(const uint32_t tile_index) {
+    switch (board_state->tile_states[tile_index]) {
+      case Board::TileState::Brick: {
+        board_state->destroy_brick(tile_index);
+        break;
+      }
+      case Board::TileState::Bomb: {
+        if (detonations.is_scheduled(tile_index)) { // chain reaction, it goes off in this same tick
+          detonations.cancel(tile_index);
+          detonating_tile_indexes.push_back(tile_index);
+        }
+        break;
+      }
+    }
 
-            ++blast_right_count;
-            timers[target_tile_index] = timers[tile_index];
-            if ( (board_state->tile_states[target_tile_index] == Board::TileState::Brick) || (board_state->tile_states[target_tile_index] == Board::TileState::Bomb) ) break;
-            if ( (target_tile_index == movement_state->player_movement_states[0].current_tile_index) || (target_tile_index == movement_state->player_movement_states[1].current_tile_index) || (target_tile_index == movement_state->player_movement_states[2].current_tile_index) || (target_tile_index == movement_state->player_movement_states[3].current_tile_index) ) break;
-          }
-          uint32_t blast_left_count = 0;
-          for (int32_t i=1; i <= int32_t(blast_radius_tiles); ++i) {
-            const int32_t target_tile_index = int32_t(tile_index) - i;
+    for (uint32_t player_index=0; (player_index < movement_state->player_count) && movement_state->current_tile_bits.test(tile_index); ++player_index) {
+      if (tile_index == movement_state->player_movement_states[player_index].current_tile_index) {
+        current_game_state->eliminate_player(movement_state->player_movement_states[player_index].player->player_id);
+        movement_state->player_movement_states[player_index].player->skin.play_animation(movement_state->player_movement_states[player_index].player->animations.first_animation + Bomberman::death_animation_offset, 1.0f, false);
+        movement_state->set_tile_indexes(movement_state->player_movement_states[player_index], MovementSystem::hide_tile_index, MovementSystem::hide_tile_index);
+        sound_state->play_player_lose(player_index);
+      }
+    }
 
-            if ( (column_index - i) < 0 ) break;
-            if (board_state->tile_states[target_tile_index] == Board::TileState::Stone) break;
+    board_state->show_fire(tile_index);
+    fire_expiries.schedule(tile_index, current_tick + explosion_time_ticks); // fire that is already burning is relit
+  }
 
-            ++blast_left_count;
-            timers[target_tile_index] = timers[tile_index];
-            if ( (board_state->tile_states[target_tile_index] == Board::TileState::Brick) || (board_state->tile_states[target_tile_index] == Board::TileState::Bomb) ) break;
-            if ( (target_tile_index == movement_state->player_movement_states[0].current_tile_index) || (target_tile_index == movement_state->player_movement_states[1].current_tile_index) || (target_tile_index == movement_state->player_movement_states[2].current_tile_index) || (target_tile_index == movement_state->player_movement_states[3].current_tile_index) ) break;
-          }
+  void detonate(const uint32_t tile_index) {
+    board_state->hide_bomb(tile_index);
 
-          auto explode_tile = [&](const uint32_t p_target_tile_index) {
-            switch (board_state->tile_states[p_target_tile_index]) {
-              case Board::TileState::Brick: {
-                board_state->hide_brick(p_target_tile_index);
-                break;
-              }
-              case Board::TileState::Bomb: {
-                timers[p_target_tile_index] = detonation_time_seconds + timers[tile_index] - delta_time_seconds; // delta_time_seconds will be added to it again
-                if ( (p_target_tile_index < tile_index) && (p_target_tile_index < chain_loop_tile_index)) {
-                  chain_loop_tile_index   = p_target_tile_index;
-                  chained_explosion       = true;
-                }
-                break;
-              }
-            }
+    const int32_t column_index = static_cast<int32_t>(board_state->calculate_column_index_from_tile_index(tile_index));
+    const int32_t row_index    = static_cast<int32_t>(board_state->calculate_row_index_from_tile_index(tile_index));
 
-            for (uint32_t player_index=0; player_index < player_count; ++player_index) {
-              constexpr uint32_t hide_tile_index = -1;
-              if (p_target_tile_index == movement_state->player_movement_states[player_index].current_tile_index) {
-                current_game_state->eliminate_player(movement_state->player_movement_states[player_index].player->player_id);
-                movement_state->player_movement_states[player_index].player->skin.play_animation(movement_state->player_movement_states[player_index].player->animations.first_animation + Bomberman::death_animation_offset, 1.0f, false);
-                movement_state->player_movement_states[player_index].current_tile_index = hide_tile_index;
-                movement_state->player_movement_states[player_index].target_tile_index  = hide_tile_index;
-                sound_state->play_player_lose(player_index);
-              }
-            }
+    const uint32_t blast_up_count    = propagate_blast(tile_index, -int32_t(board_state->floor_column_count), row_index);
+    const uint32_t blast_down_count  = propagate_blast(tile_index, int32_t(board_state->floor_column_count), (int32_t(board_state->floor_row_count) - 1) - row_index);
+    const uint32_t blast_right_count = propagate_blast(tile_index, 1, (int32_t(board_state->floor_column_count) - 1) - column_index);
+    const uint32_t blast_left_count  = propagate_blast(tile_index, -1, column_index);
 
-            if (render_fire) {
-              board_state->show_fire(p_target_tile_index);
-              is_fire_active_bits[p_target_tile_index] = true;
-            }
-          };
+    explode_tile(tile_index);
 
-          explode_tile(tile_index);
+    for (uint32_t i=1; i <= blast_up_count; ++i) {
+      const uint32_t target_tile_index = tile_index - (i * board_state->floor_column_count);
+      explode_tile(target_tile_index);
+    }
+    for (uint32_t i=1; i <= blast_down_count; ++i) {
+      const uint32_t target_tile_index = tile_index + (i * board_state->floor_column_count);
+      explode_tile(target_tile_index);
+    }
+    for (uint32_t i=1; i <= blast_right_count; ++i) {
+      const uint32_t target_tile_index = tile_index + i;
+      explode_tile(target_tile_index);
+    }
+    for (uint32_t i=1; i <= blast_left_count; ++i) {
+      const uint32_t target_tile_index = tile_index - i;
+      explode_tile(target_tile_index);
+    }
 
-          for (uint32_t i=1; i <= blast_up_count; ++i) {
-            const uint32_t target_tile_index = tile_index - (i * Board::floor_column_count);
-            explode_tile(target_tile_index);
-          }
-          for (uint32_t i=1; i <= blast_down_count; ++i) {
-            const uint32_t target_tile_index = tile_index + (i * Board::floor_column_count);
-            explode_tile(target_tile_index);
-          }
-          for (uint32_t i=1; i <= blast_right_count; ++i) {
-            const uint32_t target_tile_index = tile_index + i;
-            explode_tile(target_tile_index);
-          }
-          for (uint32_t i=1; i <= blast_left_count; ++i) {
-            const uint32_t target_tile_index = tile_index - i;
-            explode_tile(target_tile_index);
-          }
+    sound_state->play_bomb_explosion(tile_index);
+  }
 
-          sound_state->play_bomb_explosion(tile_index);
-        }
-      }
+  void update() { // only the bombs and fire due this tick are touched
+    PROFILE_SCOPE("BombSystem::update");
+    ++current_tick;
 
-      if (is_fire_active_bits[tile_index]) {
-        board_state->all_fire[tile_index].update();
-        timers[tile_index] += (delta_time_seconds * static_cast<float>(!fire_created_this_frame));
+    for (uint32_t tile_index = fire_expiries.pop_due(current_tick); tile_index != TimerWheel::no_event; tile_index = fire_expiries.pop_due(current_tick)) {
+      board_state->hide_fire(tile_index);
+    }
 
-        if (timers[tile_index] >= explosion_time_seconds) {
-          is_fire_active_bits[tile_index] = false;
-          board_state->hide_fire(tile_index);
-        }
-      }
+    detonating_tile_indexes.clear();
+    for (uint32_t tile_index = detonations.pop_due(current_tick); tile_index != TimerWheel::no_event; tile_index = detonations.pop_due(current_tick)) {
+      detonating_tile_indexes.push_back(tile_index);
+    }
+    for (size_t i=0; i < detonating_tile_indexes.size(); ++i) { // breadth first through chain reactions
+      detonate(detonating_tile_indexes[i]);
+    }
+    if (!detonating_tile_indexes.empty()) danger_map.rebuild(detonations);
+  }
 
-      if (chained_explosion) {
-        tile_index = chain_loop_tile_index;
-      }
+  void animate(const float elapsed_seconds) { // bombs pulse and fire flickers per displayed frame rather than per tick
+    const TileBits& bomb_bits = board_state->get_tile_bits(Board::TileState::Bomb);
+    const TileBits& fire_bits = board_state->get_tile_bits(Board::TileState::Fire);
+    for (size_t tile_index = TileBits::find_next_in_either(bomb_bits, fire_bits, 0); tile_index < board_state->tile_count; tile_index = TileBits::find_next_in_either(bomb_bits, fire_bits, tile_index + 1)) {
+      if (bomb_bits.test(tile_index)) board_state->all_bombs[tile_index].update(elapsed_seconds);
+      else                            board_state->all_fire[tile_index].update(elapsed_seconds);
     }
   }
 };
 
-struct AISystem {
-  struct Behavior {
-    enum class Action : uint8_t { Move, PlaceBomb };
+struct AISystem { // every AI plans against the bomb system's shared danger map with a short breadth first search
+  struct Plan {
+    enum class Action : uint8_t { Wait, Move, PlaceBomb };
 
-    MovementSystem* movement_state;
-    BombSystem* bomb_state;
+    Action action;
+    Bomberman::GlobalDirection direction;
+    uint64_t wait_until_tick;
+  };
+
+  struct Behavior {
     Bomberman* player;
-    Action current_action;
-    Action previous_action;
-    Bomberman::GlobalDirection target_directions[2];
-    Bomberman::GlobalDirection target_direction;
-    float current_move_time;
-    float target_move_time;
+    Plan plan;
+    uint32_t plan_tile_index;  // a plan is kept until the player reaches another tile, the bomb comes off cooldown or the danger map invalidates it
+    uint32_t plan_danger_map_version;
+    bool plan_is_bomb_ready;
     float current_bomb_time;
-    uint32_t current_target_direction_index;
-    bool force_direction;
-
-    void decide() {
-      if (previous_action == Action::Move) {
-        current_action = Action::PlaceBomb;
-      } else if (previous_action == Action::PlaceBomb) {
-        current_action    = Action::Move;
-        current_move_time = 0.0f;
-
-        if (!force_direction) {
-          target_move_time = (static_cast<float>(rand() % 125) / 100.0f) + delta_time_seconds;
-
-          switch(rand() % 4) {
-            case 0 : {
-              target_direction = Bomberman::GlobalDirection::Up;
-              break;
-            }
-            case 1 : {
-              target_direction = Bomberman::GlobalDirection::Down;
-              break;
-            }
-            case 2 : {
-              target_direction = Bomberman::GlobalDirection::Left;
-              break;
-            }
-            case 3 : {
-              target_direction = Bomberman::GlobalDirection::Right;
-              break;
-            }
-          }
-        } else {
-          assert(current_target_direction_index < 2);
+    tom::Random random;
+  };
 
-          target_move_time = (static_cast<float>(rand() % 20) / 100.0f) + delta_time_seconds;
+  static constexpr uint32_t no_plan_tile_index    = -1;
+  static constexpr uint32_t no_path               = -1;
+  static constexpr uint32_t max_search_depth      = 12;  // tiles, bounds the cost of a plan on big boards
+  static constexpr float    bomb_interval_seconds = 3.0f;
+  static constexpr uint64_t ticks_per_tile        = static_cast<uint64_t>(SimulationState::tick_rate_hz / MovementSystem::tiles_per_second);
+  static constexpr uint32_t rollout_depth_steps   = 16;  // a match state step is ticks_per_tile long so this looks 4 seconds ahead, past a bomb's fuse
 
-          if (current_target_direction_index == 1) {
-            force_direction  = false;
-            target_direction = target_directions[1];
-            current_target_direction_index = 0;
-          } else {
-            target_direction = target_directions[0];
-            ++current_target_direction_index;
-          }
-        }
+  MovementSystem* movement_state;
+  BombSystem* bomb_state;
+  Board* board_state;
+  std::vector<Behavior> behavior;
+  uint32_t first_ai_player_id = 1;  // 0 when player 1 is also controlled by the AI
+  uint32_t rollout_count      = 0;
+  MatchState match_state;            // captured at most once per tick and shared by every AI that looks ahead
+  uint64_t match_state_tick;
+
+  // search scratch shared by every AI, tiles are stamped rather than cleared so a search only touches the tiles it reaches
+  std::vector<uint32_t> search_stamps;
+  std::vector<uint32_t> search_depths;
+  std::vector<Bomberman::GlobalDirection> search_first_directions;
+  std::vector<uint32_t> search_tile_indexes;
+  uint32_t search_stamp;
+  std::vector<uint32_t> planned_blast_stamps; // the blast of a bomb the AI is thinking of placing
+  uint32_t planned_blast_stamp;
+  uint64_t planned_fire_tick;
+
+  void seed(const uint64_t seed, const uint32_t player_count) {  // each behavior gets its own stream so one AI's choices don't shift the others (stream 0 is the board's)
+    behavior.resize(player_count);
+    for (uint32_t i=0; i < player_count; ++i) behavior[i].random.seed(seed, i + 1);
+  }
+
+  void reset(MovementSystem* const movement_state, BombSystem* const bomb_state, Bomberman* const players) {
+    this->movement_state = movement_state;
+    this->bomb_state     = bomb_state;
+    this->board_state    = movement_state->board_state;
+
+    for (uint32_t i=0; i < behavior.size(); ++i) {
+      behavior[i].player = &players[i];
+    }
+
+    for (uint32_t i=first_ai_player_id; i < behavior.size(); ++i) {
+      behavior[i].plan_tile_index   = no_plan_tile_index;
+      behavior[i].current_bomb_time = 0.0f;
+    }
+
+    search_stamps.assign(board_state->tile_count, 0);
+    search_depths.resize(board_state->tile_count);
+    search_first_directions.resize(board_state->tile_count);
+    search_tile_indexes.clear();
+    search_tile_indexes.reserve(board_state->tile_count);
+    search_stamp = 0;
+    planned_blast_stamps.assign(board_state->tile_count, 0);
+    planned_blast_stamp = 0;
+    planned_fire_tick   = DangerMap::no_tick;
+    match_state_tick    = DangerMap::no_tick;
+  }
+
+  uint32_t get_neighbour_tile_index(const uint32_t tile_index, const Bomberman::GlobalDirection direction) const { // no_path off the edge of the board
+    const size_t row_index    = board_state->calculate_row_index_from_tile_index(tile_index);
+    const size_t column_index = board_state->calculate_column_index_from_tile_index(tile_index);
+    switch (direction) {
+      case Bomberman::GlobalDirection::Up    : return (row_index == 0)                                     ? no_path : tile_index - static_cast<uint32_t>(board_state->floor_column_count);
+      case Bomberman::GlobalDirection::Down  : return (row_index == (board_state->floor_row_count - 1))    ? no_path : tile_index + static_cast<uint32_t>(board_state->floor_column_count);
+      case Bomberman::GlobalDirection::Right : return (column_index == (board_state->floor_column_count - 1)) ? no_path : tile_index + 1;
+      case Bomberman::GlobalDirection::Left  : return (column_index == 0)                                  ? no_path : tile_index - 1;
+    }
+    return no_path;
+  }
+
+  Bomberman::GlobalDirection get_direction_to_neighbour(const uint32_t tile_index, const uint32_t neighbour_tile_index) const {
+    if (neighbour_tile_index == tile_index + 1) return Bomberman::GlobalDirection::Right;
+    if (neighbour_tile_index + 1 == tile_index) return Bomberman::GlobalDirection::Left;
+    return (neighbour_tile_index > tile_index) ? Bomberman::GlobalDirection::Down : Bomberman::GlobalDirection::Up;
+  }
+
+  uint64_t get_fire_tick(const uint32_t tile_index) const {
+    const uint64_t planned_tile_fire_tick = (planned_blast_stamps[tile_index] == planned_blast_stamp) ? planned_fire_tick : DangerMap::no_tick;
+    return std::min(bomb_state->danger_map.fire_ticks[tile_index], planned_tile_fire_tick);
+  }
+
+  // a tile the player can step onto at search depth depth and leave again before the fire reaches it
+  bool is_tile_walkable(const uint32_t tile_index, const uint32_t depth, const uint64_t current_tick) const {
+    if (board_state->tile_states[tile_index] != Board::TileState::Empty) return false;
+    if ( (depth == 1) && movement_state->is_tile_occupied(tile_index) ) return false; // other players will have moved on by the time later steps are taken
+    const uint64_t fire_tick = get_fire_tick(tile_index);
+    return (fire_tick == DangerMap::no_tick) || (fire_tick > current_tick + ((depth + 1) * ticks_per_tile));
+  }
+
+  bool is_bomb_target(const uint32_t tile_index, const uint32_t own_tile_index) const { // a bomb here would reach a brick or another player
+    bool is_target = false;
+    bomb_state->danger_map.for_each_blast_tile(tile_index, [&](const uint32_t target_tile_index) {
+      is_target |= (board_state->tile_states[target_tile_index] == Board::TileState::Brick) ||
+                   ( movement_state->current_tile_bits.test(target_tile_index) && (target_tile_index != own_tile_index) );
+    });
+    return is_target;
+  }
+
+  // breadth first from start_tile_index over walkable tiles, returns the depth of the nearest tile is_goal accepts and the first step towards it
+  template <typename IsGoal>
+  uint32_t search(Behavior& player_behavior, const uint32_t start_tile_index, const uint64_t current_tick, IsGoal&& is_goal, Bomberman::GlobalDirection& first_direction) {
+    if (++search_stamp == 0) {
+      std::fill(search_stamps.begin(), search_stamps.end(), 0);
+      search_stamp = 1;
+    }
+    search_tile_indexes.clear();
+    search_tile_indexes.push_back(start_tile_index);
+    search_stamps[start_tile_index] = search_stamp;
+    search_depths[start_tile_index] = 0;
+
+    const uint32_t direction_offset = player_behavior.random.next_below(4); // breaks ties between equally short paths
+    for (size_t i=0; i < search_tile_indexes.size(); ++i) {
+      const uint32_t tile_index = search_tile_indexes[i];
+      const uint32_t depth      = search_depths[tile_index];
+      if (is_goal(tile_index)) {
+        first_direction = search_first_directions[tile_index];
+        return depth;
+      }
+      if (depth == max_search_depth) continue;
+
+      for (uint32_t j=0; j < 4; ++j) {
+        const Bomberman::GlobalDirection direction = static_cast<Bomberman::GlobalDirection>((j + direction_offset) & 3);
+        const uint32_t neighbour_tile_index        = get_neighbour_tile_index(tile_index, direction);
+        if ( (neighbour_tile_index == no_path) || (search_stamps[neighbour_tile_index] == search_stamp) ) continue;
+        if (!is_tile_walkable(neighbour_tile_index, depth + 1, current_tick)) continue;
+
+        search_stamps[neighbour_tile_index]           = search_stamp;
+        search_depths[neighbour_tile_index]           = depth + 1;
+        search_first_directions[neighbour_tile_index] = (depth == 0) ? direction : search_first_directions[tile_index];
+        search_tile_indexes.push_back(neighbour_tile_index);
       }
     }
+    return no_path;
+  }
 
-    bool update() {
-      switch (current_action) {
-        case Action::Move : {
-          if (current_move_time == 0.0f) {
-            if (movement_state->move_player(player->player_id, target_direction, true)) {
-              player->skin.play_animation(player->animations.first_animation + Bomberman::running_animation_offset, 1.65f, true);
-              current_move_time = 0.00001f;
-            } else {  // invalid move so try again
-              previous_action = Action::PlaceBomb;
-              current_bomb_time += delta_time_seconds;
-              return false;
-            }
-          } else {
-            current_move_time += delta_time_seconds;
-            const bool is_player_idle = !movement_state->is_player_moving_bits[player->player_id];
-            if (current_move_time <= target_move_time) {
-              if ( movement_state->move_player(player->player_id, target_direction, true) && is_player_idle ) {
-                player->skin.play_animation(player->animations.first_animation + Bomberman::running_animation_offset, 1.65f, true);
-              }
-            } else {
-              if (is_player_idle) {
-                previous_action = Action::Move;
-                current_bomb_time += delta_time_seconds;
-                return false;
-              }
-            }
-          }
-          break;
-        }
-        case Action::PlaceBomb : {
-          if ( !force_direction && (current_bomb_time >= 3.0f) ) {
-            bomb_state->place_bomb(player->player_id, this->target_directions);
-            force_direction   = true;
-            current_bomb_time = 0.0f;
-          }
-          current_bomb_time += delta_time_seconds;
-          previous_action = Action::PlaceBomb;
-          return false;
-        }
+  Plan make_plan(Behavior& player_behavior, const uint32_t tile_index, const uint64_t current_tick) {
+    const uint32_t own_tile_index = movement_state->player_movement_states[player_behavior.player->player_id].current_tile_index;
+    auto is_safe = [&](const uint32_t target_tile_index) { return get_fire_tick(target_tile_index) == DangerMap::no_tick; };
+    Bomberman::GlobalDirection direction;
+
+    if (!is_safe(tile_index)) { // in a blast so run to the nearest tile no bomb reaches
+      if (search(player_behavior, tile_index, current_tick, is_safe, direction) != no_path) return { Plan::Action::Move, direction };
+      return { Plan::Action::Wait, direction, current_tick + 1 };
+    }
+
+    const bool is_bomb_ready = player_behavior.current_bomb_time >= bomb_interval_seconds;
+    if ( is_bomb_ready && is_bomb_target(tile_index, own_tile_index) ) { // only bomb when the blast can be outrun
+      if (++planned_blast_stamp == 0) {
+        std::fill(planned_blast_stamps.begin(), planned_blast_stamps.end(), 0);
+        planned_blast_stamp = 1;
       }
+      planned_fire_tick = std::min(current_tick + bomb_state->detonation_time_ticks, bomb_state->danger_map.fire_ticks[tile_index]);
+      planned_blast_stamps[tile_index] = planned_blast_stamp;
+      bomb_state->danger_map.for_each_blast_tile(tile_index, [&](const uint32_t target_tile_index) { planned_blast_stamps[target_tile_index] = planned_blast_stamp; });
 
-      current_bomb_time += delta_time_seconds;
-      return true;
+      const bool can_escape = search(player_behavior, tile_index, current_tick, is_safe, direction) != no_path;
+      planned_fire_tick = DangerMap::no_tick;
+      if (can_escape) return { Plan::Action::PlaceBomb, direction };
+    }
+
+    auto is_target = [&](const uint32_t target_tile_index) { // with the bomb ready this tile was just ruled out, so look for another
+      return ( !is_bomb_ready || (target_tile_index != tile_index) ) && is_safe(target_tile_index) && is_bomb_target(target_tile_index, own_tile_index);
+    };
+    const uint32_t target_depth = search(player_behavior, tile_index, current_tick, is_target, direction);
+    if (target_depth == 0) return { Plan::Action::Wait, direction, current_tick + 1 }; // in position, waiting for the bomb to come off cooldown
+    if (target_depth != no_path) {
+      if (player_behavior.random.next_below(4) == 0) { // hesitating now and then stops two AIs chasing each other around a stone forever
+        return { Plan::Action::Wait, direction, current_tick + 1 + player_behavior.random.next_below(2 * ticks_per_tile) };
+      }
+      return { Plan::Action::Move, direction };
+    }
+
+    // nothing in reach so follow the board's distance field towards the closest brick
+    const uint32_t next_tile_index = board_state->brick_spot_distances.get_next_tile_index(tile_index);
+    if ( (next_tile_index != DistanceField::no_tile) && is_tile_walkable(next_tile_index, 1, current_tick) && is_safe(next_tile_index) ) {
+      return { Plan::Action::Move, get_direction_to_neighbour(tile_index, next_tile_index) };
     }
-  };
 
-  std::bitset<player_count> has_behavior_assigned;
-  Behavior behavior[player_count];
-
-  void reset(MovementSystem* const movement_state, BombSystem* const bomb_state, Bomberman* const player_2, Bomberman* const player_3, Bomberman* const player_4) {
-    behavior[1].player = player_2;
-    behavior[2].player = player_3;
-    behavior[3].player = player_4;
-
-    for (uint32_t i=1; i < player_count; ++i) {
-      behavior[i].movement_state                 = movement_state;
-      behavior[i].bomb_state                     = bomb_state;
-      behavior[i].previous_action                = Behavior::Action::PlaceBomb;
-      behavior[i].force_direction                = false;
-      behavior[i].current_bomb_time              = 0.0f;
-      behavior[i].current_target_direction_index = 0;
+    // or wander once the bricks are gone, mostly keeping the current heading
+    const uint32_t direction_offset = (player_behavior.random.next_below(4) == 0) ? player_behavior.random.next_below(4) : static_cast<uint32_t>(player_behavior.player->current_direction);
+    for (uint32_t j=0; j < 4; ++j) {
+      direction = static_cast<Bomberman::GlobalDirection>((j + direction_offset) & 3);
+      const uint32_t neighbour_tile_index = get_neighbour_tile_index(tile_index, direction);
+      if ( (neighbour_tile_index != no_path) && is_tile_walkable(neighbour_tile_index, 1, current_tick) && is_safe(neighbour_tile_index) ) return { Plan::Action::Move, direction };
     }
+    return { Plan::Action::Wait, direction, current_tick + 1 };
+  }
+
+  bool can_look_ahead() const {
+    return (rollout_count > 0) && (board_state->tile_count <= MatchState::max_tile_count) && (behavior.size() <= MatchState::max_player_count);
+  }
+
+  void capture_match_state(const uint64_t current_tick) {
+    auto to_steps = [](const uint64_t ticks) { return static_cast<uint8_t>(std::clamp<uint64_t>((ticks + ticks_per_tile - 1) / ticks_per_tile, 1, UINT8_MAX)); };
+
+    match_state.column_count        = static_cast<uint16_t>(board_state->floor_column_count);
+    match_state.row_count           = static_cast<uint16_t>(board_state->floor_row_count);
+    match_state.tile_count          = static_cast<uint16_t>(board_state->tile_count);
+    match_state.brick_count         = 0;
+    match_state.player_count        = static_cast<uint8_t>(behavior.size());
+    match_state.alive_player_bits   = 0;
+    match_state.blast_radius_tiles  = static_cast<uint8_t>(bomb_state->blast_radius_tiles);
+    match_state.bomb_fuse_steps     = to_steps(bomb_state->detonation_time_ticks);
+    match_state.fire_steps          = to_steps(bomb_state->explosion_time_ticks);
+    match_state.bomb_cooldown_steps = to_steps(static_cast<uint64_t>(bomb_interval_seconds * SimulationState::tick_rate_hz));
+    match_state.step_count          = 0;
+
+    for (uint32_t tile_index=0; tile_index < board_state->tile_count; ++tile_index) {
+      const Board::TileState tile_state = board_state->tile_states[tile_index];
+      match_state.tile_states[tile_index]          = static_cast<MatchState::TileState>(tile_state);
+      match_state.brick_count                     += static_cast<uint16_t>(tile_state == Board::TileState::Brick);
+      match_state.remaining_fuse_steps[tile_index] = (tile_state == Board::TileState::Bomb) ? to_steps(bomb_state->detonations.due_ticks[tile_index] - current_tick) : 0;
+      match_state.remaining_fire_steps[tile_index] = (tile_state == Board::TileState::Fire) ? to_steps(bomb_state->fire_expiries.due_ticks[tile_index] - current_tick) : 0;
+    }
+
+    for (uint32_t i=0; i < behavior.size(); ++i) {  // a moving player is already on the tile it is heading to
+      const bool is_alive = movement_state->current_game_state->is_player_alive[i];
+      match_state.alive_player_bits         |= static_cast<uint8_t>(is_alive) << i;
+      match_state.player_tile_indexes[i]     = is_alive ? static_cast<uint16_t>(movement_state->player_movement_states[i].target_tile_index) : 0;
+      const float cooldown_seconds           = (i < first_ai_player_id) ? 0.0f : std::max(bomb_interval_seconds - behavior[i].current_bomb_time, 0.0f);
+      match_state.player_cooldown_steps[i]   = (cooldown_seconds > 0.0f) ? to_steps(static_cast<uint64_t>(cooldown_seconds * SimulationState::tick_rate_hz)) : 0;
+    }
+    match_state_tick = current_tick;
+  }
+
+  Plan make_rollout_plan(Behavior& player_behavior, const uint64_t current_tick) {
+    if (match_state_tick != current_tick) capture_match_state(current_tick);
+
+    uint64_t step_count = 0;
+    const MatchState::Action action = choose_match_action_by_rollouts(match_state, player_behavior.player->player_id, rollout_count, rollout_depth_steps, player_behavior.random, step_count);
+    switch (action) {
+      case MatchState::Action::PlaceBomb : return { Plan::Action::PlaceBomb, player_behavior.player->current_direction };
+      case MatchState::Action::Wait      : return { Plan::Action::Wait, player_behavior.player->current_direction, current_tick + ticks_per_tile };
+      default                            : return { Plan::Action::Move, static_cast<Bomberman::GlobalDirection>(action) };
+    }
+  }
+
+  bool is_plan_current(const Behavior& player_behavior, const uint32_t tile_index, const bool is_bomb_ready, const uint64_t current_tick) const {
+    if ( (player_behavior.plan_tile_index != tile_index) || (player_behavior.plan_is_bomb_ready != is_bomb_ready) ) return false;
+    if ( (player_behavior.plan.action == Plan::Action::Wait) && (current_tick >= player_behavior.plan.wait_until_tick) ) return false;
+    if (player_behavior.plan_danger_map_version == bomb_state->danger_map.version) return true;
+
+    // the map changed somewhere, a move still stands if the player isn't newly in a blast and the next tile is still walkable
+    if (player_behavior.plan.action != Plan::Action::Move) return false;
+    if (bomb_state->danger_map.fire_ticks[tile_index] != DangerMap::no_tick) return false;
+    return is_tile_walkable(get_neighbour_tile_index(tile_index, player_behavior.plan.direction), 1, current_tick);
   }
 
   void update() {
-    for (uint32_t i=1; i < player_count; ++i) {
-      if (has_behavior_assigned[i]) {
-        has_behavior_assigned[i] = behavior[i].update();
-      } else {
-        behavior[i].decide();
-        has_behavior_assigned[i] = true;
+    PROFILE_SCOPE("AISystem::update");
+    const uint64_t current_tick = bomb_state->current_tick;
+
+    for (uint32_t i=first_ai_player_id; i < behavior.size(); ++i) {
+      Behavior& player_behavior = behavior[i];
+      const uint32_t player_id  = player_behavior.player->player_id;
+      player_behavior.current_bomb_time += delta_time_seconds;
+      if (!movement_state->current_game_state->is_player_alive[player_id]) continue;
+
+      const bool is_player_moving = movement_state->is_player_moving_bits[player_id];
+      const bool is_bomb_ready    = player_behavior.current_bomb_time >= bomb_interval_seconds;
+      const uint32_t tile_index   = movement_state->player_movement_states[player_id].target_tile_index; // a moving player plans from the tile it is heading to
+      if (!is_plan_current(player_behavior, tile_index, is_bomb_ready, current_tick)) {
+        player_behavior.plan                    = can_look_ahead() ? make_rollout_plan(player_behavior, current_tick) : make_plan(player_behavior, tile_index, current_tick);
+        player_behavior.plan_tile_index         = tile_index;
+        player_behavior.plan_danger_map_version = bomb_state->danger_map.version;
+        player_behavior.plan_is_bomb_ready      = is_bomb_ready;
+      }
+
+      switch (player_behavior.plan.action) {
+        case Plan::Action::Move : {
+          if (is_player_moving) {
+            movement_state->move_player(player_id, player_behavior.plan.direction); // chains the step once the current one is far enough along
+          } else if (movement_state->move_player(player_id, player_behavior.plan.direction)) {
+            player_behavior.player->skin.play_animation(player_behavior.player->animations.first_animation + Bomberman::running_animation_offset, 1.65f, true);
+          } else {  // blocked, plan again next tick
+            player_behavior.plan_tile_index = no_plan_tile_index;
+          }
+          break;
+        }
+        case Plan::Action::PlaceBomb : {
+          if (is_player_moving) {
+            movement_state->is_player_moving_bits[player_id + movement_state->player_count] = false; // stops on the next tile to drop it there
+          } else {
+            bomb_state->place_bomb(player_id);
+            player_behavior.current_bomb_time = 0.0f;
+            player_behavior.plan_tile_index   = no_plan_tile_index;
+          }
+          break;
+        }
+        case Plan::Action::Wait : {
+          movement_state->is_player_moving_bits[player_id + movement_state->player_count] = false; // stop on the next tile rather than take a chained step
+          break;
+        }
       }
     }
   }
 };
 
-
 HandControllers* hands          = new HandControllers();
 Board* board                    = new Board();
-Bomberman* player_1             = new Bomberman();
-Bomberman* player_2             = new Bomberman();
-Bomberman* player_3             = new Bomberman();
-Bomberman* player_4             = new Bomberman();
+std::vector<Bomberman> players; // sized by init, players[0] is the local player
 MovementSystem* movement_system = new MovementSystem();
 BombSystem* bomb_system         = new BombSystem();
 GameState*  game_state          = new GameState();
@@ -1326,8 +1514,12 @@ void head_pose_dependent_sim() {
   hands->update();
 }
 
-void SimulationState::init() {
-  srand(static_cast<unsigned int>(time(NULL)));
+void SimulationState::init(const uint64_t seed) {
+  this->seed = seed;
+  board->random.seed(seed, 0);
+  ai_system->seed(seed, player_count);
+  ai_system->first_ai_player_id = is_player_1_ai_controlled ? 0 : 1;
+  ai_system->rollout_count      = ai_rollout_count;
 
   hands->init();
 
@@ -1335,27 +1527,36 @@ void SimulationState::init() {
   directional_light.update_color({1.0f, 1.0f, 1.0f});
   update_ambient_light_intensity(0.25f);
 
-  player_1->init(0);
-  player_2->init(1);
-  player_3->init(2);
-  player_4->init(3);
+  players.resize(player_count);
+  for (uint32_t i=0; i < player_count; ++i) {
+    players[i].init(i);
+  }
 
-  board->init();
-  player_1->transform.position = board->player_1_start_position;
-  player_2->transform.position = board->player_2_start_position;
-  player_3->transform.position = board->player_3_start_position;
-  player_4->transform.position = board->player_4_start_position;
+  board->init(board_width, board_height, player_count);
+  for (uint32_t i=0; i < player_count; ++i) {
+    set_graphics_mesh_instance_array_parent(players[i].skin.mesh_instance_array, board->root_transform_parent_id);  // players move in board space too
+    players[i].transform.position = board->player_start_positions[i];
+    players[i].previous_position  = players[i].transform.position;
+  }
 
-  sound_system->init(board, player_1, player_2, player_3, player_4);
-  game_state->init(board, sound_system, player_1, player_2, player_3, player_4);
-  movement_system->reset(game_state, board, player_1, player_2, player_3, player_4);
+  sound_system->init(board, players.data());
+  game_state->init(board, sound_system, players.data(), player_count);
+  movement_system->reset(game_state, board, players.data(), player_count);
   bomb_system->reset(game_state, board, movement_system, sound_system);
-  ai_system->reset(movement_system, bomb_system, player_2, player_3, player_4);
+  ai_system->reset(movement_system, bomb_system, players.data());
+  if ( (ai_rollout_count > 0) && !ai_system->can_look_ahead() ) {  // MatchState is fixed size so a rollout copies it cheaply, a big arena doesn't fit
+    DEBUG_LOG("AI: a %ux%u board with %u players is over MatchState's %u floor tiles and %u players, AIs plan on the danger map instead of rollouts\n",
+              board_width, board_height, player_count, MatchState::max_tile_count, MatchState::max_player_count);
+  }
 }
 
 void SimulationState::update() {
   PROFILE_FUNCTION();
 
+  for (Bomberman& player : players) {
+    player.previous_position = player.transform.position;
+  }
+
   if (input_state.exit || input_state.gamepad_exit) {
     platform_request_exit();
   }
@@ -1363,59 +1564,157 @@ void SimulationState::update() {
   constexpr float movement_threshold = 0.5f;
   bool player_moved = false;
   if (input_state.move_player.x > movement_threshold) {
-    player_moved = movement_system->move_player(player_1->player_id, Bomberman::GlobalDirection::Right);
+    player_moved = movement_system->move_player(players[0].player_id, Bomberman::GlobalDirection::Right);
   } else if ( input_state.move_player.x < (-1.0f * movement_threshold) ) {
-    player_moved = movement_system->move_player(player_1->player_id, Bomberman::GlobalDirection::Left);
+    player_moved = movement_system->move_player(players[0].player_id, Bomberman::GlobalDirection::Left);
   } else if ( input_state.move_player.y > movement_threshold ) {
-    player_moved = movement_system->move_player(player_1->player_id, Bomberman::GlobalDirection::Up);
+    player_moved = movement_system->move_player(players[0].player_id, Bomberman::GlobalDirection::Up);
   } else if ( input_state.move_player.y < (-1.0 * movement_threshold) ) {
-    player_moved = movement_system->move_player(player_1->player_id, Bomberman::GlobalDirection::Down);
+    player_moved = movement_system->move_player(players[0].player_id, Bomberman::GlobalDirection::Down);
   }
 
   if (game_state->is_game_active) {
     ai_system->update();
-    if (player_moved) player_1->skin.play_animation(player_1->animations.first_animation + Bomberman::running_animation_offset, 1.65f, true);
+    if (player_moved) players[0].skin.play_animation(players[0].animations.first_animation + Bomberman::running_animation_offset, 1.65f, true);
     movement_system->update();
   } else {
-    movement_system->is_player_moving_bits.reset();
+    std::fill(movement_system->is_player_moving_bits.begin(), movement_system->is_player_moving_bits.end(), false);
   }
 
   if (input_state.action_button || input_state.gamepad_action_button) {
     //play_audio_source(0, true);
     if (game_state->is_game_active && game_state->is_player_alive[0]) {
-      bomb_system->place_bomb(player_1->player_id);
+      bomb_system->place_bomb(players[0].player_id);
     } else {
-      movement_system->reset(game_state, board, player_1, player_2, player_3, player_4);
+      movement_system->reset(game_state, board, players.data(), player_count);
       bomb_system->reset(game_state, board, movement_system, sound_system);
       if (is_not_first_game) {
         board->reset_tile_states();
       } else {
         is_not_first_game = true;
       }
-      ai_system->reset(movement_system, bomb_system, player_2, player_3, player_4);
+      ai_system->reset(movement_system, bomb_system, players.data());
       game_state->restart_game();
       sound_system->play_start_bell();
       return;
     }
   }
 
-  const bool players_are_not_moving = !movement_system->is_player_moving_bits[0] && !movement_system->is_player_moving_bits[1] && !movement_system->is_player_moving_bits[2] && !movement_system->is_player_moving_bits[3];
-  if (input_state.move_board && players_are_not_moving) {
-    const Vector3f displacement = board->move(input_state.right_hand_transform.position);
-
-    player_1->transform.position = add_vectors(player_1->transform.position, displacement);
-    player_2->transform.position = add_vectors(player_2->transform.position, displacement);
-    player_3->transform.position = add_vectors(player_3->transform.position, displacement);
-    player_4->transform.position = add_vectors(player_4->transform.position, displacement);
+  if (input_state.move_board) {  // players are in board space so the board can move under them mid step
+    board->move(input_state.right_hand_transform.position);
   }
 
-  hands->update();
-  player_1->update();
-  player_2->update();
-  player_3->update();
-  player_4->update();
   bomb_system->update();
 }
 
+void SimulationState::interpolate(const float alpha) {
+  hands->update();  // every frame from the latest poses, a frame that runs no tick would freeze the controllers otherwise
+  for (Bomberman& player : players) {
+    player.update(alpha);
+  }
+  bomb_system->animate(frame_delta_time_seconds);
+}
+
+void SimulationState::advance(const float frame_delta_time_seconds) {
+  PROFILE_FUNCTION();
+
+  pending_button_presses.action_button         |= input_state.action_button;
+  pending_button_presses.gamepad_action_button |= input_state.gamepad_action_button;
+  pending_button_presses.move_board            |= input_state.move_board;
+  pending_button_presses.exit                  |= input_state.exit;
+  pending_button_presses.gamepad_exit          |= input_state.gamepad_exit;
+
+  accumulated_time_seconds += std::min(frame_delta_time_seconds, max_frame_delta_time_seconds);
+  delta_time_seconds        = tick_duration_seconds;
+
+  while (accumulated_time_seconds >= tick_duration_seconds) {
+    input_state.action_button         = pending_button_presses.action_button;
+    input_state.gamepad_action_button = pending_button_presses.gamepad_action_button;
+    input_state.move_board            = pending_button_presses.move_board;
+    input_state.exit                  = pending_button_presses.exit;
+    input_state.gamepad_exit          = pending_button_presses.gamepad_exit;
+    pending_button_presses            = {};
+    replay_recorder.record_tick(input_state);
+
+    update();
+    accumulated_time_seconds -= tick_duration_seconds;
+  }
+
+  interpolate(accumulated_time_seconds / tick_duration_seconds);
+}
+
+uint64_t SimulationState::compute_checksum() const {  // covers gameplay state only since visuals are allowed to differ between runs
+  uint64_t hash = tom::fnv1a_offset_basis;
+  hash = tom::fnv1a(hash, board->tile_states.data(), board->tile_states.size() * sizeof(board->tile_states[0]));
+  hash = tom::fnv1a(hash, bomb_system->detonations.due_ticks.data(), bomb_system->detonations.due_ticks.size() * sizeof(bomb_system->detonations.due_ticks[0]));
+  hash = tom::fnv1a(hash, bomb_system->fire_expiries.due_ticks.data(), bomb_system->fire_expiries.due_ticks.size() * sizeof(bomb_system->fire_expiries.due_ticks[0]));
+
+  for (uint32_t first_player_index=0; first_player_index < player_count; first_player_index+=64) {  // alive flags are packed 64 to a word
+    uint64_t player_alive_bits = 0;
+    for (uint32_t i=first_player_index; i < std::min(first_player_index + 64, player_count); ++i) {
+      player_alive_bits |= static_cast<uint64_t>(game_state->is_player_alive[i]) << (i - first_player_index);
+    }
+    hash = tom::fnv1a(hash, &player_alive_bits, sizeof(player_alive_bits));
+  }
+  hash = tom::fnv1a(hash, &game_state->is_game_active, sizeof(game_state->is_game_active));
+
+  for (uint32_t i=0; i < player_count; ++i) {
+    hash = tom::fnv1a(hash, &players[i].transform.position, sizeof(players[i].transform.position));
+    hash = tom::fnv1a(hash, &movement_system->player_movement_states[i].current_tile_index, sizeof(movement_system->player_movement_states[i].current_tile_index));
+  }
+
+  return hash;
+}
+
+bool SimulationState::is_match_active() const {
+  return game_state->is_game_active;
+}
+
+bool SimulationState::start_recording(const char* file_path) {
+  ReplayHeader header = {};
+  header.seed                      = seed;
+  header.tick_duration_seconds     = tick_duration_seconds;
+  header.board_width               = board_width;
+  header.board_height              = board_height;
+  header.player_count              = player_count;
+  header.ai_rollout_count          = ai_rollout_count;
+  header.is_player_1_ai_controlled = static_cast<uint32_t>(is_player_1_ai_controlled);
+  return replay_recorder.open(file_path, header);
+}
+
+bool SimulationState::replay(const char* file_path) {
+  ReplayPlayer replay_player;
+  if (!replay_player.open(file_path)) {
+    DEBUG_LOG("replay: could not read %s\n", file_path);
+    init(0);
+    return false;
+  }
+
+  // a recording plays on the board and with the players it was recorded with whatever this state was set up for
+  board_width               = replay_player.header.board_width;
+  board_height              = replay_player.header.board_height;
+  player_count              = replay_player.header.player_count;
+  ai_rollout_count          = replay_player.header.ai_rollout_count;
+  is_player_1_ai_controlled = replay_player.header.is_player_1_ai_controlled != 0;
+  init(replay_player.header.seed);
+
+  tom::Clock replay_clock;
+  replay_clock.start();
+  delta_time_seconds = replay_player.header.tick_duration_seconds;
+  while ( replay_player.next_tick(input_state) ) {
+    update();
+  }
+  interpolate(1.0f);
+  replay_clock.stop();
+
+  const uint64_t checksum    = compute_checksum();
+  const bool     is_matching = (checksum == replay_player.footer.checksum) && (replay_player.tick_count == replay_player.footer.tick_count);
+  DEBUG_LOG("replay: %llu ticks in %.3f s (%.1fx real time) checksum %016llx %s\n", static_cast<unsigned long long>(replay_player.tick_count), replay_clock.get_elapsed_time_seconds(),
+            (static_cast<float>(replay_player.tick_count) * replay_player.header.tick_duration_seconds) / std::max(replay_clock.get_elapsed_time_seconds(), 0.000001f),
+            static_cast<unsigned long long>(checksum), is_matching ? "matches" : "DIFFERS from recording");
+  return is_matching;
+}
+
 void SimulationState::exit() {
+  replay_recorder.close(compute_checksum());
 }
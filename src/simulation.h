@@ -1,12 +1,42 @@
 #ifndef INCLUDE_TOM_ENGINE_SIMULATION_H
 #define INCLUDE_TOM_ENGINE_SIMULATION_H
 
+#include "replay.h"
 #include <stdlib.h>
 #include <bitset>
 
 struct SimulationState {
-  void init();
-  void update();
+  static constexpr float tick_rate_hz                 = 120.0f;
+  static constexpr float tick_duration_seconds        = 1.0f / tick_rate_hz;
+  static constexpr float max_frame_delta_time_seconds = 0.25f; // limits catch-up ticks after a hitch
+
+  struct ButtonPresses {  // presses are only reported for one frame so they are held until a tick consumes them
+    bool action_button;
+    bool gamepad_action_button;
+    bool move_board;
+    bool exit;
+    bool gamepad_exit;
+  };
+
+  float accumulated_time_seconds = 0.0f;
+  ButtonPresses pending_button_presses = {};
+  uint64_t seed = 0;  // every random decision in a match comes from this so input and seed are enough to reproduce it
+  bool is_player_1_ai_controlled = false;  // set before init for AI-vs-AI matches (the headless benchmark)
+  uint32_t board_width  = 15;  // the arena size and player count are also set before init, anything but 15x13 with 4 players is a big arena
+  uint32_t board_height = 13;
+  uint32_t player_count = 4;
+  uint32_t ai_rollout_count = 8;  // rollouts per action for AIs that look ahead on a MatchState, 0 or an arena over MatchState::max_tile_count floor tiles or
+                                  // MatchState::max_player_count players uses the danger map planner, which init logs
+  ReplayRecorder replay_recorder;
+
+  void init(const uint64_t seed);
+  void advance(const float frame_delta_time_seconds); // runs the fixed ticks that fit into the frame then interpolates
+  void update();  // one fixed tick
+  void interpolate(const float alpha);
+  uint64_t compute_checksum() const;
+  bool is_match_active() const;
+  bool start_recording(const char* file_path);
+  bool replay(const char* file_path);  // initializes the simulation from the recording and runs every tick without rendering, returns false if the end state differs from the recording
   void exit();
 };
 
@@ -0,0 +1,188 @@
+#ifndef INCLUDE_TOM_ENGINE_TEXTURE_ATLAS_H
+#define INCLUDE_TOM_ENGINE_TEXTURE_ATLAS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <stb_rect_pack.h>
+
+// packs textures of any size into the pages of a texture array instead of resizing every texture to the size of a layer,
+// each texture is padded with its own wrapped edges and starts and ends on an alignment that keeps it a whole rect on every mip level,
+// so linear filtering and the mip levels never reach a neighbour and sampling at fract(uv) repeats like a repeating sampler,
+// the chain stops at the level where the padding is a single texel (log2(padding) + 1 levels) since a smaller level would blend
+// neighbours together, so a texture minified more than 16:1 samples its last level and aliases instead of fading to its average
+struct TextureAtlas {
+  static constexpr uint32_t mip_level_count = 5;
+  static constexpr uint32_t alignment       = 1 << (mip_level_count - 1);
+  static constexpr uint32_t padding         = alignment;  // a texel is left on the last mip level
+  static constexpr uint32_t bytes_per_texel = 4;          // rgba8
+
+  struct Rect {
+    uint32_t page_index;
+    uint32_t x;  // of the texture inside its padding in texels of the first mip level
+    uint32_t y;
+    uint32_t width;
+    uint32_t height;
+
+    uint32_t get_padded_width(const uint32_t mip_level) const  { return (width + (2 * padding)) >> mip_level; }
+    uint32_t get_padded_height(const uint32_t mip_level) const { return (height + (2 * padding)) >> mip_level; }
+  };
+
+  struct UvRect {
+    float offset_u;
+    float offset_v;
+    float scale_u;
+    float scale_v;
+  };
+
+  uint32_t page_width;
+  uint32_t page_height;
+  uint32_t max_page_count;
+  std::vector<stbrp_context>           page_contexts;  // reserved by init, a context points into itself so it can't move
+  std::vector<std::vector<stbrp_node>> page_nodes;
+  uint32_t texture_count    = 0;
+  uint64_t used_byte_count  = 0;  // of the textures' mip levels with their padding
+
+  void init(const uint32_t page_width, const uint32_t page_height, const uint32_t max_page_count);  // page sizes are multiples of alignment
+
+  // decodes an image file, scales it down only when it can't fit in a page and rounds its size up to the alignment, packs it, then writes
+  // its mip levels with their padding one after the other, each Rect::get_padded_width by get_padded_height texels, ready to copy to the page
+  bool add_texture_from_file_bytes(const uint8_t* const file_bytes, const size_t file_byte_count, Rect& rect, std::vector<uint8_t>& mip_levels);
+  bool pack(const uint32_t width, const uint32_t height, Rect& rect);  // sizes are multiples of alignment
+
+  UvRect   get_uv_rect(const Rect& rect) const;
+  uint64_t get_allocated_byte_count() const;  // every page with its mip levels, a texture array allocates them all up front
+};
+
+uint64_t calculate_texture_mip_chain_byte_count(const uint32_t width, const uint32_t height, const uint32_t mip_level_count);
+
+#endif  // INCLUDE_TOM_ENGINE_TEXTURE_ATLAS_H
+
+//////////////////////////////////////////////////
+
+#ifdef  TOM_ENGINE_TEXTURE_ATLAS_IMPLEMENTATION
+#ifndef TOM_ENGINE_TEXTURE_ATLAS_IMPLEMENTATION_SINGLE
+#define TOM_ENGINE_TEXTURE_ATLAS_IMPLEMENTATION_SINGLE
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <stb_image.h>
+#include <stb_image_resize.h>
+
+uint64_t calculate_texture_mip_chain_byte_count(const uint32_t width, const uint32_t height, const uint32_t mip_level_count) {
+  uint64_t byte_count = 0;
+  for (uint32_t mip_level=0; mip_level < mip_level_count; ++mip_level) {
+    byte_count += uint64_t(std::max(width >> mip_level, 1u)) * uint64_t(std::max(height >> mip_level, 1u)) * TextureAtlas::bytes_per_texel;
+  }
+  return byte_count;
+}
+
+void TextureAtlas::init(const uint32_t page_width, const uint32_t page_height, const uint32_t max_page_count) {
+  assert( ((page_width % alignment) == 0) && ((page_height % alignment) == 0) );
+  this->page_width     = page_width;
+  this->page_height    = page_height;
+  this->max_page_count = max_page_count;
+  page_contexts.clear();
+  page_contexts.reserve(max_page_count);
+  page_nodes.clear();
+  page_nodes.reserve(max_page_count);
+  texture_count   = 0;
+  used_byte_count = 0;
+}
+
+bool TextureAtlas::pack(const uint32_t width, const uint32_t height, Rect& rect) {
+  assert( ((width % alignment) == 0) && ((height % alignment) == 0) );
+
+  // packed in units of the alignment so every position is aligned
+  stbrp_rect packed_rect{};
+  packed_rect.w = static_cast<stbrp_coord>((width + (2 * padding)) / alignment);
+  packed_rect.h = static_cast<stbrp_coord>((height + (2 * padding)) / alignment);
+
+  for (uint32_t page_index=0; page_index < max_page_count; ++page_index) {
+    if (page_index == page_contexts.size()) {
+      page_nodes.emplace_back(page_width / alignment);
+      page_contexts.emplace_back();
+      stbrp_init_target(&page_contexts.back(), static_cast<int>(page_width / alignment), static_cast<int>(page_height / alignment), page_nodes.back().data(), static_cast<int>(page_nodes.back().size()));
+    }
+
+    if (stbrp_pack_rects(&page_contexts[page_index], &packed_rect, 1) == 1) {
+      rect = { page_index, (static_cast<uint32_t>(packed_rect.x) * alignment) + padding, (static_cast<uint32_t>(packed_rect.y) * alignment) + padding, width, height };
+      ++texture_count;
+      used_byte_count += calculate_texture_mip_chain_byte_count(rect.get_padded_width(0), rect.get_padded_height(0), mip_level_count);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool TextureAtlas::add_texture_from_file_bytes(const uint8_t* const file_bytes, const size_t file_byte_count, Rect& rect, std::vector<uint8_t>& mip_levels) {
+  int source_width;
+  int source_height;
+  int channel_count;
+  stbi_uc* const source_pixels = stbi_load_from_memory(file_bytes, static_cast<int>(file_byte_count), &source_width, &source_height, &channel_count, STBI_rgb_alpha);
+  if (source_pixels == nullptr) return false;
+
+  auto round_up_to_alignment = [](const uint32_t size) { return std::max( ((size + (alignment - 1)) / alignment) * alignment, alignment ); };
+  const uint32_t max_width  = page_width - (2 * padding);
+  const uint32_t max_height = page_height - (2 * padding);
+  const float    fit_scale  = std::min({ 1.0f, static_cast<float>(max_width) / static_cast<float>(source_width), static_cast<float>(max_height) / static_cast<float>(source_height) });
+  const uint32_t width      = std::min(round_up_to_alignment(static_cast<uint32_t>(static_cast<float>(source_width) * fit_scale)), max_width);
+  const uint32_t height     = std::min(round_up_to_alignment(static_cast<uint32_t>(static_cast<float>(source_height) * fit_scale)), max_height);
+
+  std::vector<uint8_t> pixels(size_t(width) * height * bytes_per_texel);
+  if ( (width == static_cast<uint32_t>(source_width)) && (height == static_cast<uint32_t>(source_height)) ) {
+    memcpy(pixels.data(), source_pixels, pixels.size());
+  } else {
+    stbir_resize_uint8_srgb(source_pixels, source_width, source_height, 0, pixels.data(), static_cast<int>(width), static_cast<int>(height), 0, bytes_per_texel, 3, 0);
+  }
+  stbi_image_free(source_pixels);
+
+  if (!pack(width, height, rect)) return false;
+
+  // every mip level is scaled from the first so errors don't add up, then padded with the texels it would wrap to
+  mip_levels.clear();
+  std::vector<uint8_t> level_pixels;
+  for (uint32_t mip_level=0; mip_level < mip_level_count; ++mip_level) {
+    const uint32_t level_width   = width >> mip_level;
+    const uint32_t level_height  = height >> mip_level;
+    const uint32_t level_padding = padding >> mip_level;
+    const uint8_t* level_source  = pixels.data();
+    if (mip_level > 0) {
+      level_pixels.resize(size_t(level_width) * level_height * bytes_per_texel);
+      stbir_resize_uint8_srgb(pixels.data(), static_cast<int>(width), static_cast<int>(height), 0, level_pixels.data(), static_cast<int>(level_width), static_cast<int>(level_height), 0, bytes_per_texel, 3, 0);
+      level_source = level_pixels.data();
+    }
+
+    const uint32_t padded_width  = rect.get_padded_width(mip_level);
+    const uint32_t padded_height = rect.get_padded_height(mip_level);
+    const size_t   level_offset  = mip_levels.size();
+    mip_levels.resize(level_offset + (size_t(padded_width) * padded_height * bytes_per_texel));
+    for (uint32_t y=0; y < padded_height; ++y) {
+      const uint32_t source_y = (y + level_height - level_padding) % level_height;
+      for (uint32_t x=0; x < padded_width; ++x) {
+        const uint32_t source_x = (x + level_width - level_padding) % level_width;
+        memcpy(&mip_levels[level_offset + ((size_t(y) * padded_width) + x) * bytes_per_texel], &level_source[((size_t(source_y) * level_width) + source_x) * bytes_per_texel], bytes_per_texel);
+      }
+    }
+  }
+
+  return true;
+}
+
+TextureAtlas::UvRect TextureAtlas::get_uv_rect(const Rect& rect) const {
+  return {
+    static_cast<float>(rect.x) / static_cast<float>(page_width),
+    static_cast<float>(rect.y) / static_cast<float>(page_height),
+    static_cast<float>(rect.width) / static_cast<float>(page_width),
+    static_cast<float>(rect.height) / static_cast<float>(page_height)
+  };
+}
+
+uint64_t TextureAtlas::get_allocated_byte_count() const {
+  return max_page_count * calculate_texture_mip_chain_byte_count(page_width, page_height, mip_level_count);
+}
+
+#endif  // TOM_ENGINE_TEXTURE_ATLAS_IMPLEMENTATION_SINGLE
+#endif  // TOM_ENGINE_TEXTURE_ATLAS_IMPLEMENTATION
@@ -2,9 +2,16 @@
 
 #include "config.h"
 #include "profiler.h"
+#include "metrics.h"
 #include "tom_std.h"
 #include "maths.h"
 #include "platform.h"
+#include "replay.h"
+#include "navigation.h"
+#include "match_state.h"
+#include "rollback.h"
+#include "texture_atlas.h"
 #include "graphics.h"
+#include "audio_mixer.h"
 #include "audio.h"
 #include "simulation.h"
@@ -2,6 +2,8 @@
 
 #include <semaphore>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
 
 namespace tom {
   struct Semaphore {
@@ -15,14 +17,18 @@ namespace tom {
     }
   };
 
+  inline uint64_t get_steady_nanoseconds() {  // monotonic so wall clock adjustments don't affect timings
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+  }
+
   struct Clock {
     uint64_t start_time_nanoseconds;
     uint64_t end_time_nanoseconds;
     uint64_t elapsed_time_nanoseconds;
 
     void start() {
-      using namespace std::chrono;
-      this->start_time_nanoseconds = duration_cast<nanoseconds>(system_clock::now().time_since_epoch()).count();
+      this->start_time_nanoseconds = get_steady_nanoseconds();
     }
 
     void restart() {
@@ -30,8 +36,7 @@ namespace tom {
     };
 
     void stop() {
-      using namespace std::chrono;
-      this->end_time_nanoseconds     = duration_cast<nanoseconds>(system_clock::now().time_since_epoch()).count();
+      this->end_time_nanoseconds     = get_steady_nanoseconds();
       this->elapsed_time_nanoseconds = end_time_nanoseconds - start_time_nanoseconds;
     }
 
@@ -47,4 +52,40 @@ namespace tom {
       return static_cast<float>(elapsed_time_nanoseconds) / 1000000000.0f;
     }
   };
+
+  constexpr uint64_t fnv1a_offset_basis = 0xcbf29ce484222325ull;
+
+  inline uint64_t fnv1a(uint64_t hash, const void* const bytes, const size_t byte_count) {  // start from fnv1a_offset_basis, pass the result back in to hash several buffers as one
+    const uint8_t* const data = static_cast<const uint8_t*>(bytes);
+    for (size_t i=0; i < byte_count; ++i) {
+      hash ^= data[i];
+      hash *= 0x100000001b3ull;
+    }
+    return hash;
+  }
+
+  struct Random {  // pcg32 so a seed gives the same sequence on every platform which rand() doesn't guarantee
+    uint64_t state     = 0x853c49e6748fea9bull;
+    uint64_t increment = 0xda3e39cb94b95bdbull;
+
+    void seed(const uint64_t seed_value, const uint64_t stream=0) {  // different streams with the same seed are independent
+      this->state     = 0;
+      this->increment = (stream << 1) | 1;
+      next();
+      this->state += seed_value;
+      next();
+    }
+
+    uint32_t next() {
+      const uint64_t previous_state = this->state;
+      this->state = (previous_state * 6364136223846793005ull) + this->increment;
+      const uint32_t xor_shifted = static_cast<uint32_t>( ((previous_state >> 18) ^ previous_state) >> 27 );
+      const uint32_t rotation    = static_cast<uint32_t>(previous_state >> 59);
+      return (xor_shifted >> rotation) | (xor_shifted << ((0u - rotation) & 31));
+    }
+
+    uint32_t next_below(const uint32_t bound) {  // [0, bound)
+      return static_cast<uint32_t>( (static_cast<uint64_t>(next()) * bound) >> 32 );
+    }
+  };
 }